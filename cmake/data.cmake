@@ -12,6 +12,7 @@ file(GLOB_RECURSE DATA_FILES
 		"${main_folder}/data/*.mtl"
 		"${main_folder}/data/*.gltf"
 		"${main_folder}/data/*.bin"
+		"${main_folder}/data/*.mesh"
 		)
 foreach(DATA ${DATA_FILES})
 	get_filename_component(FILE_NAME ${DATA} NAME)
@@ -94,6 +95,46 @@ add_custom_target(
 
 endfunction()
 
+# Cook the listed textures (relative to main_folder) with texture_cooker next to their data copy, where
+# gl::Texture looks for them. COLOR textures average their mips as sRGB, DATA ones (normal, specular,
+# metallic, roughness maps...) as linear values. FLIP_Y is for textures loaded with Texture::FLIP_Y.
+function(COOKTEXTURES main_folder exe_name)
+cmake_parse_arguments(COOK "FLIP_Y" "" "COLOR;DATA" ${ARGN})
+if(COOK_FLIP_Y)
+	set(COOK_EXTENSION ".flipped.ktx")
+	set(FLIP_ARG "--flip-y")
+else()
+	set(COOK_EXTENSION ".ktx")
+	set(FLIP_ARG "")
+endif()
+foreach(TEXTURE ${COOK_COLOR} ${COOK_DATA})
+	if(TEXTURE IN_LIST COOK_DATA)
+		set(LINEAR_ARG "--linear")
+	else()
+		set(LINEAR_ARG "")
+	endif()
+	set(TEXTURE_OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${TEXTURE}${COOK_EXTENSION}")
+	get_filename_component(OUTPUT_FOLDER ${TEXTURE_OUTPUT} DIRECTORY)
+	add_custom_command(
+			OUTPUT ${TEXTURE_OUTPUT}
+			COMMAND ${CMAKE_COMMAND} -E make_directory ${OUTPUT_FOLDER}
+			COMMAND texture_cooker ${main_folder}/${TEXTURE} ${TEXTURE_OUTPUT} ${FLIP_ARG} ${LINEAR_ARG}
+			DEPENDS ${main_folder}/${TEXTURE} texture_cooker)
+	list(APPEND COOKED_OUTPUT_FILES ${TEXTURE_OUTPUT})
+endforeach(TEXTURE)
+
+if(COOK_FLIP_Y)
+	set(COOK_TARGET "${exe_name}_CookedFlippedTextures")
+else()
+	set(COOK_TARGET "${exe_name}_CookedTextures")
+endif()
+add_custom_target(
+		${COOK_TARGET}
+		DEPENDS ${COOKED_OUTPUT_FILES}
+)
+add_dependencies("${exe_name}" ${COOK_TARGET})
+endfunction()
+
 function(GENERATEGLDATA main_folder exe_name)
 COPYDATA(${main_folder} ${exe_name})
 CheckGlShader(${main_folder} ${exe_name})
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "gl/model.h"
+#include "gl/texture.h"
+
+namespace gl
+{
+/**
+ * \brief Textures and models shared by everything loading them with the same path and flags.
+ * An asset stays loaded when nobody holds it anymore until ReleaseUnused, so switching back to a sample
+ * finds its assets already loaded. Holders only drop their reference, the registry destroys the assets.
+ */
+class AssetRegistry
+{
+public:
+    struct Statistics
+    {
+        std::size_t textureNmb = 0;
+        std::size_t modelNmb = 0;
+        /**
+         * Loads given an asset already loaded
+         */
+        std::size_t hitNmb = 0;
+        std::size_t missNmb = 0;
+    };
+
+    [[nodiscard]] static std::shared_ptr<Texture> LoadTexture(std::string_view path,
+                                                              std::uint8_t textureFlags = Texture::DEFAULT);
+
+    /**
+     * \brief Same as LoadTexture, a texture not loaded yet is loaded with Texture::LoadTextureAsync
+     */
+    [[nodiscard]] static std::shared_ptr<Texture> LoadTextureAsync(std::string_view path,
+                                                                   std::uint8_t textureFlags = Texture::DEFAULT);
+
+    [[nodiscard]] static std::shared_ptr<Model> LoadModel(std::string_view path,
+                                                          Mesh::VertexFormat format = Mesh::VertexFormat::FULL,
+                                                          std::size_t lodCount = 1);
+
+    /**
+     * \brief Destroy the assets nobody holds anymore
+     */
+    static void ReleaseUnused();
+
+    /**
+     * \brief Destroy every asset, after their holders are destroyed
+     */
+    static void Destroy();
+
+    [[nodiscard]] static Statistics GetStatistics();
+
+private:
+    static std::unordered_map<std::string, std::shared_ptr<Texture>> textures_;
+    static std::unordered_map<std::string, std::shared_ptr<Model>> models_;
+    inline static std::size_t hitNmb_ = 0;
+    inline static std::size_t missNmb_ = 0;
+};
+}
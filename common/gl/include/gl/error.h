@@ -4,6 +4,31 @@
 
 namespace gl
 {
+/**
+ * \brief Poll glGetError and log every pending error with the call site
+ */
 void CheckError(std::string_view file, int line);
-#define glCheckError() CheckError(__FILE__, __LINE__)
-}
\ No newline at end of file
+
+/**
+ * \brief Remember the call site of the last glCheckError, reported by the debug callback with its messages
+ */
+void SetErrorContext(const char* file, int line);
+
+/**
+ * \brief Install the KHR_debug message callback, the context needs to be created with the debug flag
+ */
+void EnableDebugOutput();
+
+/**
+ * GL_ERROR_CHECK_POLL: glCheckError polls glGetError, each call may stall on a driver round trip.
+ * GL_ERROR_CHECK_CALLBACK: errors are reported by the KHR_debug callback, glCheckError only marks the call site.
+ * Neither: glCheckError is compiled out, the default for release builds.
+ */
+#if defined(GL_ERROR_CHECK_POLL)
+#define glCheckError() gl::CheckError(__FILE__, __LINE__)
+#elif defined(GL_ERROR_CHECK_CALLBACK)
+#define glCheckError() gl::SetErrorContext(__FILE__, __LINE__)
+#else
+#define glCheckError() static_cast<void>(0)
+#endif
+}
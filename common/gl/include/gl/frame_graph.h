@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gl/render_target_pool.h"
+
+namespace gl
+{
+/**
+ * \brief Passes of a frame declaring the render targets they read and write, executed on Execute.
+ * Passes nothing kept reads from are culled, the kept ones run writers before readers whatever order they
+ * were added in, and transient targets are acquired from the RenderTargetPool right before their first pass
+ * and released after their last one, so passes that do not overlap share their targets.
+ * A pass rendering to the screen or to an imported texture is kept, it is what the frame is for.
+ */
+class FrameGraph
+{
+public:
+    using ResourceHandle = std::size_t;
+    static constexpr ResourceHandle INVALID_RESOURCE = std::numeric_limits<std::size_t>::max();
+
+    struct Statistics
+    {
+        std::size_t passNmb = 0;
+        std::size_t culledPassNmb = 0;
+        std::size_t transientNmb = 0;
+        /**
+         * Bytes of the transient targets used by the kept passes
+         */
+        std::size_t transientBytes = 0;
+    };
+
+    class PassBuilder
+    {
+    public:
+        /**
+         * \brief The pass samples resource, it runs after the passes writing it
+         */
+        ResourceHandle Read(ResourceHandle resource);
+
+        /**
+         * \brief The pass renders to resource, a pass that also reads it runs after the passes only writing it
+         */
+        ResourceHandle Write(ResourceHandle resource);
+
+        /**
+         * \brief Keep the pass even if nothing reads what it writes, for a pass drawing to the screen
+         */
+        void SetSideEffect();
+
+    private:
+        friend class FrameGraph;
+
+        PassBuilder(FrameGraph& frameGraph, std::size_t passIndex) :
+            frameGraph_(frameGraph), passIndex_(passIndex)
+        {}
+
+        FrameGraph& frameGraph_;
+        std::size_t passIndex_;
+    };
+
+    class PassResources
+    {
+    public:
+        [[nodiscard]] unsigned int GetTexture(ResourceHandle resource) const;
+
+        /**
+         * \brief Bind a framebuffer rendering to the color resources in order and depthResource
+         */
+        void BindFramebuffer(std::initializer_list<ResourceHandle> colorResources,
+                             ResourceHandle depthResource = INVALID_RESOURCE) const;
+
+    private:
+        friend class FrameGraph;
+
+        explicit PassResources(const FrameGraph& frameGraph) : frameGraph_(frameGraph)
+        {}
+
+        const FrameGraph& frameGraph_;
+    };
+
+    using SetupFunction = std::function<void(PassBuilder&)>;
+    using ExecuteFunction = std::function<void(const PassResources&)>;
+
+    /**
+     * \brief Transient render target, only allocated while the kept passes using it run
+     */
+    ResourceHandle CreateResource(std::string_view name, const RenderTargetDesc& desc);
+
+    /**
+     * \brief Texture living outside the graph, the passes writing it are kept
+     */
+    ResourceHandle ImportResource(std::string_view name, unsigned int textureName);
+
+    /**
+     * \brief Declare the pass resources now with setup, execute is called on Execute if the pass is kept
+     */
+    void AddPass(std::string_view name, const SetupFunction& setup, ExecuteFunction&& execute);
+
+    /**
+     * \brief Cull, order and execute the passes
+     */
+    void Execute();
+
+    /**
+     * \brief Remove the passes and resources, to build the graph of the next frame
+     */
+    void Clear();
+
+    [[nodiscard]] const Statistics& GetStatistics() const
+    { return statistics_; }
+
+    /**
+     * \brief Names of the passes of the last Execute in execution order
+     */
+    [[nodiscard]] std::vector<std::string_view> GetExecutedPasses() const;
+
+private:
+    struct Resource
+    {
+        std::string name;
+        RenderTargetDesc desc;
+        unsigned int textureName = 0;
+        bool imported = false;
+        std::vector<std::size_t> writers;
+        std::vector<std::size_t> readers;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<ResourceHandle> reads;
+        std::vector<ResourceHandle> writes;
+        bool sideEffect = false;
+        bool kept = false;
+    };
+
+    void CullPasses();
+
+    /**
+     * \brief Kept passes with writers before modifiers (passes reading and writing) before readers of each
+     * resource, in the order they were added otherwise
+     */
+    void OrderPasses();
+
+    [[nodiscard]] bool IsModifier(std::size_t passIndex, ResourceHandle resource) const;
+
+    std::vector<Resource> resources_;
+    std::vector<Pass> passes_;
+    std::vector<std::size_t> executionOrder_;
+    Statistics statistics_;
+};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "gl/mesh.h"
+
+namespace gl
+{
+/**
+ * \brief Layout of glMultiDrawElementsIndirect commands
+ */
+struct DrawElementsIndirectCommand
+{
+    std::uint32_t count = 0;
+    std::uint32_t instanceCount = 0;
+    std::uint32_t firstIndex = 0;
+    std::int32_t baseVertex = 0;
+    std::uint32_t baseInstance = 0;
+};
+
+/**
+ * \brief One vertex and one index buffer sub-allocated for many meshes behind a single vertex array,
+ * so all the draws recorded between two flushes are issued with one glMultiDrawElementsIndirect.
+ * The vertex attributes 0 to 3 follow Mesh::Vertex, attribute 4 is the material index of the draw
+ * (an unsigned integer fetched per instance from the baseInstance of each command).
+ */
+class GeometryPool
+{
+public:
+    struct Range
+    {
+        std::uint32_t indexCount = 0;
+        std::uint32_t firstIndex = 0;
+        std::int32_t baseVertex = 0;
+    };
+
+    static constexpr unsigned MATERIAL_INDEX_ATTRIBUTE = 4;
+
+    ~GeometryPool();
+
+    void Create(std::size_t vertexCapacity, std::size_t indexCapacity);
+
+    void Destroy();
+
+    /**
+     * \brief Copy the mesh data after the previous allocations, nullopt if the pool is full
+     */
+    [[nodiscard]] std::optional<Range> Allocate(std::span<const Mesh::Vertex> vertices,
+                                                std::span<const unsigned int> indices);
+
+    void AddDraw(const Range& range, std::uint32_t materialIndex);
+
+    /**
+     * \brief Issue the recorded draws in one multi draw indirect with the textures and program currently bound
+     */
+    void Flush();
+
+    [[nodiscard]] unsigned int GetVao() const
+    { return vao_; }
+
+    [[nodiscard]] std::size_t GetVertexCount() const
+    { return vertexCount_; }
+
+    [[nodiscard]] std::size_t GetIndexCount() const
+    { return indexCount_; }
+
+private:
+    std::vector<DrawElementsIndirectCommand> commands_;
+    std::vector<std::uint32_t> materialIndices_;
+    std::size_t vertexCapacity_ = 0, indexCapacity_ = 0;
+    std::size_t vertexCount_ = 0, indexCount_ = 0;
+    unsigned vao_ = 0, vbo_ = 0, ebo_ = 0;
+    unsigned commandBuffer_ = 0, materialBuffer_ = 0;
+};
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gl
+{
+/**
+ * \brief GPU time of the scopes of a frame measured with timestamp queries, without any external tool.
+ * The queries of a frame are read when its query set comes back QUERY_FRAME_NMB frames later so reading them
+ * does not stall, a frame whose queries are still not available is dropped.
+ */
+class GpuProfiler
+{
+public:
+    struct Timing
+    {
+        std::string name;
+        /**
+         * Number of scopes this one is nested in, the frame is the only one at 0
+         */
+        int depth = 0;
+        /**
+         * Milliseconds, the average moves by AVERAGE_FACTOR of the difference each frame
+         */
+        double averageTime = 0.0;
+        double lastTime = 0.0;
+    };
+
+    /**
+     * \brief Scope measured from its construction to its destruction, nested in the scopes alive
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(std::string_view name);
+
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::size_t markerIndex_;
+    };
+
+    static constexpr std::size_t QUERY_FRAME_NMB = 3;
+    static constexpr double AVERAGE_FACTOR = 0.05;
+    /**
+     * \brief Resolved frames kept for ExportChromeTrace
+     */
+    static constexpr std::size_t TRACE_FRAME_NMB = 120;
+    static constexpr std::string_view TRACE_PATH = "gpu_trace.json";
+
+    /**
+     * \brief Read the queries of the frame whose set comes back and open the frame scope
+     */
+    static void BeginFrame();
+
+    static void EndFrame();
+
+    static void Destroy();
+
+    /**
+     * \brief Scopes of the last resolved frame in the order they began, with their averages
+     */
+    [[nodiscard]] static const std::vector<Timing>& GetTimings()
+    { return timings_; }
+
+    /**
+     * \brief Average milliseconds of the whole frame
+     */
+    [[nodiscard]] static double GetFrameTime();
+
+    [[nodiscard]] static std::size_t GetDroppedFrameNmb()
+    { return droppedFrameNmb_; }
+
+    /**
+     * \brief Write the kept frames as a trace of complete events loadable in chrome://tracing or Perfetto
+     */
+    static bool ExportChromeTrace(std::string_view path);
+
+    /**
+     * \brief Takes effect on the next frame
+     */
+    static void SetEnabled(bool enabled)
+    { enabled_ = enabled; }
+
+    [[nodiscard]] static bool IsEnabled()
+    { return enabled_; }
+
+private:
+    struct Marker
+    {
+        std::string name;
+        int depth = 0;
+        std::size_t beginQuery = 0;
+        std::size_t endQuery = 0;
+        bool ended = false;
+    };
+
+    struct FrameQueries
+    {
+        std::vector<unsigned int> queries;
+        std::size_t usedQueryNmb = 0;
+        std::vector<Marker> markers;
+        bool pending = false;
+    };
+
+    /**
+     * \brief Scope with its nanosecond GPU timestamps
+     */
+    struct TraceEvent
+    {
+        std::string name;
+        std::uint64_t begin = 0;
+        std::uint64_t end = 0;
+    };
+
+    [[nodiscard]] static std::size_t BeginMarker(std::string_view name);
+
+    static void EndMarker(std::size_t markerIndex);
+
+    static std::size_t WriteTimestamp(FrameQueries& frame);
+
+    static void ResolveFrame(FrameQueries& frame);
+
+    static std::array<FrameQueries, QUERY_FRAME_NMB> frames_;
+    static std::vector<Timing> timings_;
+    static std::deque<std::vector<TraceEvent>> trace_;
+    inline static std::size_t currentFrame_ = 0;
+    inline static std::size_t frameMarker_ = 0;
+    inline static int depth_ = 0;
+    inline static bool frameActive_ = false;
+    inline static bool enabled_ = true;
+    inline static std::size_t droppedFrameNmb_ = 0;
+};
+}
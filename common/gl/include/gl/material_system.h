@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "gl/mesh.h"
+
+namespace gl
+{
+/**
+ * \brief Materials of many meshes gathered so draws with different textures can go in the same multi draw.
+ * The textures are copied by size and format in GL_TEXTURE_2D_ARRAYs, or referenced by ARB_bindless_texture handles
+ * when available, and the material table is a shader storage buffer indexed by the material index of the draw.
+ */
+class MaterialSystem
+{
+public:
+    enum class TextureSlot
+    {
+        DIFFUSE,
+        SPECULAR,
+        NORMAL,
+        LENGTH
+    };
+    static constexpr std::size_t TEXTURE_SLOT_NMB = static_cast<std::size_t>(TextureSlot::LENGTH);
+    static constexpr std::uint32_t NO_TEXTURE = ~0u;
+
+    /**
+     * \brief std430 layout of a texture in the material table, layer of textureArrays[array] or bindless handle
+     */
+    struct TextureData
+    {
+        std::uint32_t array = NO_TEXTURE;
+        std::uint32_t layer = 0;
+        std::uint64_t handle = 0;
+    };
+
+    struct MaterialData
+    {
+        std::array<TextureData, TEXTURE_SLOT_NMB> textures{};
+    };
+
+    //Samplers the array shaders declare in textureArrays
+    static constexpr std::size_t MAX_TEXTURE_ARRAYS = 8;
+    static constexpr unsigned MATERIAL_STORAGE_BINDING = 0;
+
+    ~MaterialSystem();
+
+    /**
+     * \brief Register the material made of textures, the same textures give back the same index
+     */
+    std::uint32_t AddMaterial(std::span<const Mesh::Texture> textures);
+
+    /**
+     * \brief Copy the registered textures to their arrays, or make their handles resident, and upload the table
+     */
+    void Build(bool allowBindless = true);
+
+    void Destroy();
+
+    /**
+     * \brief Bind the table and the texture arrays from firstTextureUnit to the samplers of shader
+     */
+    void Bind(ShaderProgram& shader, int firstTextureUnit = 0);
+
+    [[nodiscard]] bool IsBindless() const
+    { return isBindless_; }
+
+    [[nodiscard]] std::size_t GetMaterialCount() const
+    { return materials_.size(); }
+
+    [[nodiscard]] std::size_t GetTextureArrayCount() const
+    { return textureArrays_.size(); }
+
+private:
+    struct TextureArray
+    {
+        int width = 0;
+        int height = 0;
+        int levels = 0;
+        unsigned internalFormat = 0;
+        std::vector<unsigned> textures;
+        unsigned name = 0;
+    };
+
+    std::uint32_t AddTexture(unsigned textureName);
+
+    //Index in textures_ of each slot of the materials, their array layer or handle is resolved by Build
+    std::vector<std::array<std::uint32_t, TEXTURE_SLOT_NMB>> materials_;
+    std::vector<std::uint64_t> materialIds_;
+    std::vector<unsigned> textures_;
+    std::vector<TextureArray> textureArrays_;
+    std::vector<std::uint64_t> residentHandles_;
+    unsigned materialBuffer_ = 0;
+    bool isBindless_ = false;
+};
+}
@@ -1,11 +1,13 @@
 #pragma once
 
 
+#include <span>
 #include <vector>
 #include <string>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include "mesh_file.h"
 #include "gl/shader.h"
 #include "gl/vertex_array.h"
 #include "gl/texture.h"
@@ -16,12 +18,17 @@ namespace gl
 class Mesh
 {
 public:
-    struct Vertex
+    //Same layout as the cooked files, their vertices are copied as they are
+    using Vertex = core::MeshFileVertex;
+
+    /**
+     * \brief GPU layout of the vertices, QUANTIZED is core::QuantizedVertex and its shaders decode
+     * the position with the meshBoundsMin and meshBoundsExtent uniforms and the octahedral normal and tangent
+     */
+    enum class VertexFormat
     {
-        glm::vec3 position;
-        glm::vec2 texCoords;
-        glm::vec3 normal;
-        glm::vec3 tangent;
+        FULL,
+        QUANTIZED
     };
 
     struct Texture
@@ -30,6 +37,15 @@ public:
         std::string type;
     };
 
+    /**
+     * \brief Range of a level of detail in the element buffer, all of them index the same vertices
+     */
+    struct Lod
+    {
+        std::size_t firstIndex = 0;
+        std::size_t indexCount = 0;
+    };
+
     Mesh() = default;
 
     ~Mesh();
@@ -45,7 +61,28 @@ public:
 
     Mesh& operator=(Mesh&& other) noexcept;
 
-    void SetupMesh();
+    /**
+     * \brief Simplify the mesh into up to lodCount - 1 coarser levels of detail stored after its indices,
+     * has to be called before SetupMesh
+     */
+    void GenerateLods(std::size_t lodCount);
+
+    void SetupMesh(VertexFormat format = VertexFormat::FULL);
+
+    /**
+     * \brief Point the attributes 0 to 3 of the bound vertex array to Vertex data in the bound array buffer
+     */
+    static void SetVertexAttributes();
+
+    static void SetQuantizedVertexAttributes();
+
+    /**
+     * \brief Set the bounds the quantized positions are relative to, nothing to do for full vertices
+     */
+    void BindQuantization(ShaderProgram& shader) const;
+
+    [[nodiscard]] VertexFormat GetVertexFormat() const
+    { return format_; }
 
     void Draw(ShaderProgram& shader);
 
@@ -54,10 +91,38 @@ public:
     [[nodiscard]] unsigned int GetVao() const
     { return vao_; }
 
+    /**
+     * \brief Index count of the full detail mesh
+     */
     [[nodiscard]] std::size_t GetIndicesCount() const;
 
+    [[nodiscard]] const std::vector<Vertex>& GetVertices() const
+    { return vertices_; }
+
+    /**
+     * \brief Indices of the full detail mesh
+     */
+    [[nodiscard]] std::span<const unsigned int> GetIndices() const
+    { return std::span(indices_).first(GetIndicesCount()); }
+
+    [[nodiscard]] std::size_t GetLodCount() const
+    { return lods_.size(); }
+
+    [[nodiscard]] const Lod& GetLod(std::size_t lod) const
+    { return lods_[lod]; }
+
     void BindTextures(ShaderProgram& shader) const;
 
+    /**
+     * \brief Hash of the bound textures, meshes with the same id can be drawn without binding them again
+     */
+    [[nodiscard]] std::uint64_t GetMaterialId() const;
+
+    [[nodiscard]] static std::uint64_t GetMaterialId(std::span<const Texture> textures);
+
+    [[nodiscard]] const std::vector<Texture>& GetTextures() const
+    { return textures_; }
+
     [[nodiscard]] glm::vec3 GetMax() const {return maxExtend;}
     [[nodiscard]] glm::vec3 GetMin() const {return minExtend;}
 
@@ -65,8 +130,11 @@ private:
     std::vector<Vertex> vertices_;
     std::vector<unsigned int> indices_;
     std::vector<Texture> textures_;
+    //LOD 0 is the full detail mesh
+    std::vector<Lod> lods_;
     glm::vec3 maxExtend{std::numeric_limits<float>::lowest()}, minExtend{std::numeric_limits<float>::max()};
     unsigned vao_ = 0, vbo_ = 0, ebo_ = 0;
+    VertexFormat format_ = VertexFormat::FULL;
 };
 
 }
\ No newline at end of file
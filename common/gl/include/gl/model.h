@@ -1,8 +1,12 @@
 #pragma once
 
+#include "gl/geometry_pool.h"
+#include "gl/material_system.h"
 #include "gl/mesh.h"
 #include <assimp/scene.h>
 
+#include <memory>
+
 namespace gl
 {
 
@@ -13,19 +17,58 @@ public:
 
     ~Model();
 
-    void LoadModel(std::string_view path);
+    /**
+     * \brief Load the cooked file next to path if there is one, or import path with Assimp.
+     * With a lodCount above 1, each mesh gets simplified levels of detail after its indices.
+     */
+    void LoadModel(std::string_view path, Mesh::VertexFormat format = Mesh::VertexFormat::FULL,
+                   std::size_t lodCount = 1);
 
     void Draw(ShaderProgram& shader);
 
+    /**
+     * \brief Copy the meshes in pool, they are then drawn from it with one multi draw indirect per material,
+     * or with a single one when their materials are registered in materials
+     */
+    void AddToPool(GeometryPool& pool, MaterialSystem* materials = nullptr);
+
+    /**
+     * \brief Draw from the pool the model was added to, falls back to drawing each mesh if it was not.
+     * With a material system, it has to be bound to shader beforehand.
+     */
+    void Draw(ShaderProgram& shader, GeometryPool& pool);
+
     void Destroy();
 
     [[nodiscard]] const Mesh& GetMesh(std::size_t i) const;
 
+    [[nodiscard]] std::size_t GetMeshCount() const
+    { return meshes_.size(); }
+
 private:
     std::vector<Mesh> meshes_;
     std::string directory_;
-    std::vector<std::size_t> textureHashes_;
-    std::vector<Texture> textures_;
+    /**
+     * Textures of the meshes, shared through the AssetRegistry with the other models using them
+     */
+    std::vector<std::shared_ptr<Texture>> textures_;
+    std::vector<GeometryPool::Range> poolRanges_;
+    //Mesh indices grouped by material and the material index of each mesh
+    std::vector<std::size_t> poolDrawOrder_;
+    std::vector<std::uint32_t> materialIndices_;
+    bool usingMaterialSystem_ = false;
+
+    void SetupMeshes(Mesh::VertexFormat format, std::size_t lodCount);
+
+    /**
+     * \brief Load the meshes and materials written by the mesh cooker, false if the file is invalid
+     */
+    bool LoadCookedModel(std::string_view cookedPath);
+
+    /**
+     * \brief Name of the texture at texturePath, loaded by the first model one of whose meshes uses it
+     */
+    unsigned int LoadTexture(const std::string& texturePath);
 
     void ProcessNode(aiNode* node, const aiScene* scene);
 
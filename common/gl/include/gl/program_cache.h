@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace gl
+{
+/**
+ * \brief Disk cache of linked program binaries.
+ * Entries are keyed by the hash of the shader sources and of the driver vendor, renderer and version,
+ * a binary refused by the driver is simply compiled again and overwritten.
+ */
+class ProgramCache
+{
+public:
+    struct Statistics
+    {
+        std::size_t compiledNmb = 0;
+        std::size_t cachedNmb = 0;
+        double compileTime = 0.0;
+        double cacheTime = 0.0;
+    };
+
+    [[nodiscard]] static std::uint64_t ComputeKey(std::initializer_list<std::string_view> sources);
+
+    /**
+     * \brief Return a linked program from the cache or 0 if there is no valid binary for key
+     */
+    [[nodiscard]] static unsigned LoadProgram(std::uint64_t key);
+
+    /**
+     * \brief Store the binary of program, it must have been linked with the retrievable hint
+     */
+    static void SaveProgram(unsigned program, std::uint64_t key);
+
+    /**
+     * \brief Ask the driver to keep the binary of program retrievable, to call before linking
+     */
+    static void SetRetrievableHint(unsigned program);
+
+    static void AddCompileTime(double milliseconds);
+
+    static void AddCacheTime(double milliseconds);
+
+    [[nodiscard]] static const Statistics& GetStatistics()
+    { return statistics_; }
+
+    static void SetEnabled(bool enabled)
+    { enabled_ = enabled; }
+
+    [[nodiscard]] static bool IsEnabled()
+    { return enabled_; }
+
+    static constexpr std::string_view CACHE_FOLDER = "shader_cache";
+private:
+    [[nodiscard]] static std::string GetCachePath(std::uint64_t key);
+
+    [[nodiscard]] static bool IsSupported();
+
+    static Statistics statistics_;
+    inline static bool enabled_ = true;
+};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include "glm/vec3.hpp"
+
+#include "radix_sort.h"
+
+namespace gl
+{
+class Mesh;
+class Model;
+class ShaderProgram;
+
+/**
+ * \brief Draws recorded with a 64-bit sort key and executed in key order on Flush,
+ * so draws sharing a program, material and vertex array follow each other and only the first one binds them.
+ * Key from the most significant bits: pass (4), program (12), material (16), vertex array (16), depth (16).
+ */
+class RenderQueue
+{
+public:
+    struct Statistics
+    {
+        std::size_t drawNmb = 0;
+        std::size_t programChangeNmb = 0;
+        std::size_t materialChangeNmb = 0;
+        std::size_t vaoChangeNmb = 0;
+    };
+
+    /**
+     * \brief Opaque draws are sorted front to back from position, depth beyond farPlane is clamped
+     */
+    void SetViewPosition(glm::vec3 position, float farPlane);
+
+    void Submit(ShaderProgram& program, const Mesh& mesh, const glm::mat4& model, std::uint8_t pass = 0);
+
+    void Submit(ShaderProgram& program, const Model& model, const glm::mat4& transform, std::uint8_t pass = 0);
+
+    /**
+     * \brief Sort and execute the recorded draws then clear the queue
+     */
+    void Flush();
+
+    [[nodiscard]] const Statistics& GetStatistics() const
+    { return statistics_; }
+
+    [[nodiscard]] static std::uint64_t MakeKey(std::uint8_t pass, unsigned program, std::uint64_t materialId,
+                                               unsigned vao, float depth);
+
+private:
+    struct DrawCommand
+    {
+        ShaderProgram* program = nullptr;
+        const Mesh* mesh = nullptr;
+        std::uint64_t materialId = 0;
+        glm::mat4 model{1.0f};
+    };
+
+    std::vector<DrawCommand> commands_;
+    std::vector<core::SortItem> items_;
+    std::vector<core::SortItem> scratch_;
+    glm::vec3 viewPosition_{};
+    float farPlane_ = 100.0f;
+    Statistics statistics_;
+};
+}
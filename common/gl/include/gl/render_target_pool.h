@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+namespace gl
+{
+/**
+ * \brief Size and internal format of a 2d render target, targets with the same description are interchangeable
+ */
+struct RenderTargetDesc
+{
+    int width = 0;
+    int height = 0;
+    unsigned int internalFormat = 0;
+
+    bool operator==(const RenderTargetDesc& other) const = default;
+};
+
+/**
+ * \brief Render target textures handed out by description, to acquire when a pass writes them and release
+ * after the last pass reading them. A released texture is given to the next acquire of the same description,
+ * in the same frame too, so targets whose lifetimes do not overlap share their memory. Targets not acquired
+ * for a few frames are deleted, a resized window only leaves its old targets behind for these frames.
+ */
+class RenderTargetPool
+{
+public:
+    struct Statistics
+    {
+        std::size_t targetNmb = 0;
+        std::size_t allocatedBytes = 0;
+        /**
+         * Bytes acquired last frame, what the passes would allocate without sharing the targets
+         */
+        std::size_t acquiredBytes = 0;
+        std::size_t framebufferNmb = 0;
+    };
+
+    /**
+     * \brief Frames a released target stays in the pool before being deleted
+     */
+    static constexpr std::uint64_t MAX_UNUSED_FRAMES = 3;
+    static constexpr std::size_t MAX_COLOR_ATTACHMENT = 8;
+
+    /**
+     * \brief Texture name of a target matching desc, created if none is free
+     */
+    [[nodiscard]] static unsigned int Acquire(const RenderTargetDesc& desc);
+
+    /**
+     * \brief Give the target back, the passes acquiring after may write over it
+     */
+    static void Release(unsigned int textureName);
+
+    /**
+     * \brief Bind a framebuffer with the targets as color attachments in order and depthTarget (0 for none)
+     * as depth attachment, the framebuffer is kept for the next binds with the same attachments
+     */
+    static void BindFramebuffer(std::initializer_list<unsigned int> colorTargets, unsigned int depthTarget = 0);
+
+    static void BindFramebuffer(std::span<const unsigned int> colorTargets, unsigned int depthTarget = 0);
+
+    /**
+     * \brief Delete the targets unused for MAX_UNUSED_FRAMES, to call once per frame
+     */
+    static void Update();
+
+    static void Destroy();
+
+    [[nodiscard]] static const Statistics& GetStatistics()
+    { return statistics_; }
+
+    [[nodiscard]] static std::size_t GetByteSize(const RenderTargetDesc& desc);
+
+private:
+    struct Target
+    {
+        RenderTargetDesc desc;
+        unsigned int textureName = 0;
+        bool used = false;
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    struct CachedFramebuffer
+    {
+        std::array<unsigned int, MAX_COLOR_ATTACHMENT> colorTargets{};
+        unsigned int depthTarget = 0;
+        unsigned int fbo = 0;
+    };
+
+    static void DeleteTarget(const Target& target);
+
+    static std::vector<Target> targets_;
+    static std::vector<CachedFramebuffer> framebuffers_;
+    static Statistics statistics_;
+    inline static std::size_t frameAcquiredBytes_ = 0;
+    inline static std::uint64_t frameIndex_ = 0;
+};
+}
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
+#include <span>
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <glm/ext/matrix_float4x4.hpp>
 
 #include "filesystem.h"
+#include "hash.h"
 #include "texture.h"
 
 #include "glm/vec2.hpp"
@@ -15,6 +19,33 @@
 namespace gl
 {
 
+/**
+ * \brief Uniform name hashed at compile time, for example "view"_uniform
+ */
+struct UniformId
+{
+    constexpr explicit UniformId(std::string_view name) : hash(core::HashFnv1a(name))
+    {}
+
+    std::uint64_t hash;
+};
+
+namespace literals
+{
+constexpr UniformId operator ""_uniform(const char* name, std::size_t length)
+{
+    return UniformId(std::string_view(name, length));
+}
+}
+
+/**
+ * \brief Uniform location resolved once, setting it is a direct glUniform call
+ */
+struct UniformLocation
+{
+    int value = -1;
+};
+
 class ShaderProgram
 {
 public:
@@ -33,38 +64,89 @@ public:
 
     void Destroy();
 
+    /**
+     * \brief Submit the compilation and link of the program without waiting for the driver.
+     * Creating all the programs of a sample before binding any of them lets the driver compile them in parallel,
+     * the status is checked by FinishCreation on the first Bind.
+     */
     void CreateDefaultProgram(std::string_view vertexPath, std::string_view fragmentPath);
 
+    void CreateComputeProgram(std::string_view computePath);
+
+    /**
+     * \brief Wait for the compilation and link submitted by Create and report their errors
+     */
+    void FinishCreation();
+
+    /**
+     * \brief Non blocking query of the driver compilation, always false without KHR_parallel_shader_compile
+     */
+    [[nodiscard]] bool IsCompiling() const;
+
+    /**
+     * \brief Let the driver use its compiler threads, to call once after the context creation
+     */
+    static void EnableParallelCompilation();
+
+    /**
+     * \brief Location of an active uniform, arrays of basic types also answer to name[i], -1 if inactive
+     */
+    [[nodiscard]] UniformLocation GetUniformLocation(UniformId uniformId);
+
+    [[nodiscard]] UniformLocation GetUniformLocation(std::string_view uniformName)
+    { return GetUniformLocation(UniformId(uniformName)); }
+
     void SetFloat(std::string_view uniformName, float f);
+    void SetFloat(UniformLocation location, float f);
 
     void SetInt(std::string_view uniformName, int i);
+    void SetInt(UniformLocation location, int i);
 
     void SetVec2(std::string_view uniformName, glm::vec2 v);
+    void SetVec2(UniformLocation location, glm::vec2 v);
 
     void SetVec3(std::string_view uniformName, glm::vec3 v);
+    void SetVec3(UniformLocation location, glm::vec3 v);
+    /**
+     * \brief Upload consecutive elements of a vec3 array starting at location in a single call
+     */
+    void SetVec3Array(UniformLocation location, std::span<const glm::vec3> values);
 
     void SetVec4(std::string_view uniformName, glm::vec4 v);
+    void SetVec4(UniformLocation location, glm::vec4 v);
+
+    void Bind();
 
-    void Bind() const;
+    [[nodiscard]] unsigned int GetName() const
+    { return program_; }
 
     void SetTexture(std::string_view uniformName, const Texture& texture, int textureUnit);
     void SetTexture(std::string_view uniformName, unsigned int textureName, int textureUnit);
+    void SetTexture(UniformLocation location, unsigned int textureName, int textureUnit);
 
     void SetMat4(std::string_view uniformName, const glm::mat4& mat);
+    void SetMat4(UniformLocation location, const glm::mat4& mat);
 
 private:
 
     static constexpr unsigned INVALID_SHADER = 0;
     unsigned int program_ = 0;
-    std::unordered_map<std::string, int> uniformMap_;
+    /**
+     * Hashed name to location of every active uniform, filled by introspection once the program is linked
+     */
+    std::unordered_map<std::uint64_t, int> uniformLocations_;
 
-    int GetUniformLocation(std::string_view uniformName);
+    void ResolveUniforms();
 
-    static unsigned CreateShaderProgram(unsigned vertexShader, unsigned fragmentShader);
+    static unsigned SubmitShader(const core::BufferFile& bufferFile, unsigned shaderType);
 
-    unsigned LoadShader(core::BufferFile&& bufferFile, int shaderType) const;
+    void SubmitProgram(std::initializer_list<unsigned> shaders);
 
-    static unsigned LoadShader(char* shaderContent, unsigned shaderType);
+    bool isPending_ = false;
+    std::vector<unsigned> pendingShaders_;
+    std::string pendingDescription_;
+    std::uint64_t pendingCacheKey_ = 0;
+    double pendingSubmitTime_ = 0.0;
 
 };
 
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace gl
+{
+/**
+ * \brief Shadow of the GL bindings and fixed function state, a call setting the value already in place is skipped.
+ * Every bind of the samples and of the common code goes through it so the shadow never goes out of sync,
+ * code outside of it (like the ImGui backend) must be followed by Invalidate.
+ */
+class StateCache
+{
+public:
+    struct Statistics
+    {
+        std::size_t issuedNmb = 0;
+        std::size_t elidedNmb = 0;
+    };
+
+    static void UseProgram(unsigned program);
+
+    static void BindVertexArray(unsigned vao);
+
+    /**
+     * \brief The element array binding belongs to the bound vertex array, it is always issued
+     */
+    static void BindBuffer(unsigned target, unsigned buffer);
+
+    static void BindBufferBase(unsigned target, unsigned index, unsigned buffer);
+
+    static void BindBufferRange(unsigned target, unsigned index, unsigned buffer, std::ptrdiff_t offset,
+                                std::ptrdiff_t size);
+
+    static void ActiveTexture(unsigned textureUnit);
+
+    /**
+     * \brief Bind texture to target on the active texture unit
+     */
+    static void BindTexture(unsigned target, unsigned texture);
+
+    /**
+     * \brief Bind texture to target on unit, the active unit only changes if the binding does
+     */
+    static void BindTexture(int unit, unsigned target, unsigned texture);
+
+    static void Enable(unsigned capability);
+
+    static void Disable(unsigned capability);
+
+    static void DepthFunc(unsigned func);
+
+    static void BlendFunc(unsigned sourceFactor, unsigned destinationFactor);
+
+    static void CullFace(unsigned mode);
+
+    static void FrontFace(unsigned mode);
+
+    /**
+     * \brief Deleting a bound object resets its binding to 0 and its name may be given again to a new object
+     */
+    static void DeleteProgram(unsigned program);
+
+    static void DeleteVertexArrays(int count, const unsigned* vaos);
+
+    static void DeleteBuffers(int count, const unsigned* buffers);
+
+    static void DeleteTextures(int count, const unsigned* textures);
+
+    /**
+     * \brief Forget the shadowed state after GL calls made outside of the cache, the next calls are all issued
+     */
+    static void Invalidate();
+
+    /**
+     * \brief Keep the counters of the frame that ended and start counting a new one
+     */
+    static void EndFrame();
+
+    [[nodiscard]] static const Statistics& GetFrameStatistics()
+    { return lastFrameStatistics_; }
+
+    static constexpr std::size_t MAX_TEXTURE_UNITS = 32;
+    static constexpr std::size_t TEXTURE_TARGET_NMB = 5;
+    static constexpr std::size_t BUFFER_TARGET_NMB = 6;
+    static constexpr std::size_t CAPABILITY_NMB = 4;
+private:
+    //Value no object can have, the next call is always issued
+    static constexpr unsigned UNKNOWN = ~0u;
+
+    struct State
+    {
+        unsigned program = UNKNOWN;
+        unsigned vao = UNKNOWN;
+        std::array<unsigned, BUFFER_TARGET_NMB> buffers{};
+        unsigned activeTextureUnit = UNKNOWN;
+        std::array<std::array<unsigned, TEXTURE_TARGET_NMB>, MAX_TEXTURE_UNITS> textures{};
+        std::array<unsigned, CAPABILITY_NMB> capabilities{};
+        unsigned depthFunc = UNKNOWN;
+        std::array<unsigned, 2> blendFunc{UNKNOWN, UNKNOWN};
+        unsigned cullFace = UNKNOWN;
+        unsigned frontFace = UNKNOWN;
+    };
+
+    static State MakeUnknownState();
+
+    static void SetCapability(unsigned capability, bool enabled);
+
+    /**
+     * \brief Count the call and tell if it has to be issued, updating the shadowed value
+     */
+    static bool Update(unsigned& shadow, unsigned value);
+
+    static State state_;
+    static Statistics statistics_;
+    static Statistics lastFrameStatistics_;
+};
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace gl
+{
+/**
+ * \brief Persistently mapped buffer split in regions written by the CPU while the GPU reads the previous ones.
+ * Each region is protected by a fence, so the CPU only waits if it gets more than REGION_COUNT - 1 frames ahead.
+ */
+class StreamBuffer
+{
+public:
+    static constexpr std::size_t REGION_COUNT = 3;
+
+    ~StreamBuffer();
+
+    /**
+     * \brief Allocate REGION_COUNT regions of at least regionSize bytes, each region starting on alignment
+     * so it can also be bound as a uniform or shader storage range
+     */
+    void Create(std::size_t regionSize, std::size_t alignment = 256);
+
+    void Destroy();
+
+    /**
+     * \brief Wait for the GPU to release the current region and return its mapped memory
+     */
+    [[nodiscard]] void* BeginRegion();
+
+    /**
+     * \brief Fence the current region after the draw calls reading it were issued and move to the next one
+     */
+    void EndRegion();
+
+    [[nodiscard]] unsigned int GetName() const
+    { return buffer_; }
+
+    [[nodiscard]] std::size_t GetRegionSize() const
+    { return regionSize_; }
+
+    [[nodiscard]] std::size_t GetRegionIndex() const
+    { return regionIndex_; }
+
+    /**
+     * \brief Byte offset of the current region in the buffer
+     */
+    [[nodiscard]] std::size_t GetRegionOffset() const
+    { return regionIndex_ * regionSize_; }
+
+private:
+    unsigned int buffer_ = 0;
+    std::byte* mappedData_ = nullptr;
+    std::size_t regionSize_ = 0;
+    std::size_t regionIndex_ = 0;
+    /**
+     * GLsync of each region, kept opaque to not leak the GL headers
+     */
+    std::array<void*, REGION_COUNT> fences_{};
+};
+}
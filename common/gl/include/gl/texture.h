@@ -1,9 +1,11 @@
 #pragma once
 
+#include <string>
 #include <string_view>
 #include <vector>
 #include <glm/vec2.hpp>
 #include "filesystem.h"
+#include "gl/texture_residency.h"
 
 namespace gl
 {
@@ -18,8 +20,29 @@ public:
         MIRROR_REPEAT_WRAP = 1u << 3u,
         GAMMA_CORRECTION = 1u << 4u,
         FLIP_Y = 1u << 5u,
+        /**
+         * Stream the mips in and out with the TextureResidency, HDR images are loaded whole
+         */
+        STREAMING = 1u << 6u,
         DEFAULT = MIPMAP | SMOOTH | CLAMP_WRAP,
     };
+
+    /**
+     * \brief Pixels decoded by stb_image, 8 bits per channel or floats for hdr images
+     */
+    struct Image
+    {
+        void* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        int channelNb = 0;
+        bool hdr = false;
+
+        [[nodiscard]] std::size_t GetSize() const;
+
+        void Free();
+    };
+
     Texture();
 
     Texture(const Texture& other) = delete;
@@ -32,10 +55,19 @@ public:
 
     ~Texture();
 
+    /**
+     * \brief Load the cooked version of path made by the texture_cooker if there is one, else decode path
+     */
     void LoadTexture(std::string_view path,
         std::uint8_t textureFlags = DEFAULT,
                      int channelsDesired = 0);
 
+    /**
+     * \brief Return right away with the white texture of CreateWhiteTexture, the image is decoded on a worker
+     * and streamed in over the next frames by the TextureLoader. Compressed and cooked textures are loaded right away.
+     */
+    void LoadTextureAsync(std::string_view path, std::uint8_t textureFlags = DEFAULT);
+
     void LoadCubemap(const std::vector<std::string_view>& paths);
 
     void Destroy();
@@ -49,8 +81,45 @@ public:
     void SetName(unsigned textureName);
     void SetType(unsigned textureType);
 
+    /**
+     * \brief Decode an image file, safe to call from any thread. The pixels are nullptr if it cannot be decoded.
+     */
+    [[nodiscard]] static Image DecodeImage(const core::BufferFile& file, bool hdr, bool flipY,
+                                           int channelsDesired = 0);
+
+    /**
+     * \brief Set the wrap and filter parameters of the texture bound to GL_TEXTURE_2D
+     */
+    static void SetParameters(std::uint8_t textureFlags);
+
+    /**
+     * \brief Specify the level 0 of the texture bound to GL_TEXTURE_2D, pixels is an offset
+     * in the bound pixel unpack buffer if there is one
+     */
+    static void UploadImage(const Image& image, std::uint8_t textureFlags, const void* pixels);
+
+    /**
+     * \brief Full mip chain of a RGBA8 image, safe to call from any thread
+     */
+    [[nodiscard]] static TextureResidency::MipChain BuildMipChain(const Image& image, std::uint8_t textureFlags);
+
+    /**
+     * \brief Set the parameters of the texture bound to GL_TEXTURE_2D and give it to the TextureResidency
+     */
+    static void StreamMipChain(unsigned int textureName, TextureResidency::MipChain&& mipChain,
+                               std::uint8_t textureFlags);
+
 private:
-    void LoadCompressedTexture(core::BufferFile&& file);
+    [[nodiscard]] static std::string GetCookedPath(std::string_view path, std::uint8_t textureFlags);
+    void LoadCookedTexture(std::string_view cookedPath, std::uint8_t textureFlags);
+    /**
+     * \brief Load a ktx or dds file, with the sRGB variant of its format if srgb
+     */
+    void LoadCompressedTexture(core::BufferFile&& file, bool srgb = false);
+    /**
+     * \brief Levels of a ktx or dds file for the TextureResidency, empty if it cannot be read
+     */
+    [[nodiscard]] static TextureResidency::MipChain LoadCompressedMipChain(core::BufferFile&& file, bool srgb);
     unsigned int textureName_ = 0;
     unsigned int textureType_;
     glm::vec2 textureSize_;
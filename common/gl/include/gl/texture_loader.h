@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "jobsystem.h"
+#include "gl/texture.h"
+
+namespace gl
+{
+/**
+ * \brief Decode textures on worker threads and stream them to the GPU through a pool of pixel unpack buffers.
+ * A requested texture keeps its placeholder until its image is uploaded, which the Engine does between frames
+ * within an upload budget, so loading a model does not stall on its textures.
+ */
+class TextureLoader
+{
+public:
+    struct Statistics
+    {
+        std::size_t pendingNmb = 0;
+        std::size_t uploadedNmb = 0;
+        std::size_t uploadedBytes = 0;
+    };
+
+    static constexpr std::size_t STAGING_BUFFER_COUNT = 4;
+    /**
+     * \brief Bytes uploaded per frame, a bigger image is still uploaded alone
+     */
+    static constexpr std::size_t UPLOAD_BUDGET = 16 * 1024 * 1024;
+
+    static void Init();
+
+    static void Destroy();
+
+    /**
+     * \brief Queue the decoding of path and its upload in textureName, which keeps its placeholder until then
+     */
+    static void LoadTexture(unsigned int textureName, std::string_view path, std::uint8_t textureFlags);
+
+    /**
+     * \brief Drop the pending image of textureName, to call before deleting the texture
+     */
+    static void Cancel(unsigned int textureName);
+
+    /**
+     * \brief Upload the decoded images while there is a free staging buffer and the frame budget allows
+     */
+    static void Update();
+
+    /**
+     * \brief Wait until every requested texture is uploaded, for code reading their content or size
+     */
+    static void Flush();
+
+    [[nodiscard]] static const Statistics& GetStatistics()
+    { return statistics_; }
+
+    static void SetEnabled(bool enabled)
+    { enabled_ = enabled; }
+
+    /**
+     * \brief Whether textures are loaded asynchronously, false until the workers are started
+     */
+    [[nodiscard]] static bool IsEnabled()
+    { return enabled_ && workerQueue_ != nullptr; }
+
+private:
+    struct Request
+    {
+        unsigned int textureName = 0;
+        std::string path;
+        std::uint8_t textureFlags = 0;
+        Texture::Image image;
+        /**
+         * Levels of a STREAMING texture, built on the worker instead of the image
+         */
+        TextureResidency::MipChain mipChain;
+        std::shared_ptr<core::Task> task;
+    };
+
+    struct StagingBuffer
+    {
+        unsigned int buffer = 0;
+        std::size_t size = 0;
+        /**
+         * GLsync of the last upload from the buffer, kept opaque to not leak the GL headers
+         */
+        void* fence = nullptr;
+    };
+
+    /**
+     * \brief Upload the decoded requests within budget bytes, waiting for a staging buffer if waitForStaging
+     */
+    static void UploadDecoded(std::size_t budget, bool waitForStaging);
+
+    static void Upload(Request& request, StagingBuffer& stagingBuffer);
+
+    static void ReleaseStagingBuffers(bool wait);
+
+    static void FreeCancelled();
+
+    static std::unique_ptr<core::WorkerQueue> workerQueue_;
+    static std::vector<std::unique_ptr<core::WorkerThread>> workerThreads_;
+    static std::deque<std::shared_ptr<Request>> requests_;
+    /**
+     * Cancelled requests whose decoding is not done yet, their image is freed when it is
+     */
+    static std::vector<std::shared_ptr<Request>> cancelledRequests_;
+    static std::array<StagingBuffer, STAGING_BUFFER_COUNT> stagingBuffers_;
+    static Statistics statistics_;
+    inline static bool enabled_ = true;
+};
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace gl
+{
+/**
+ * \brief Keep only the mips of the streamed textures that are needed on screen within a VRAM budget.
+ * A texture starts with its small mips resident, finer ones are uploaded over the frames while its reported
+ * screen size asks for them, and the finest mips of the least recently used textures are evicted when the
+ * budget is reached. The whole mip chain stays in main memory, the GL texture keeps its name and sees its
+ * base level move as the mips come and go.
+ */
+class TextureResidency
+{
+public:
+    /**
+     * \brief Levels of a texture from the finest, in the layout glTexImage2D or glCompressedTexImage2D takes
+     */
+    struct MipChain
+    {
+        int width = 0;
+        int height = 0;
+        unsigned int internalFormat = 0;
+        unsigned int format = 0;
+        unsigned int type = 0;
+        bool compressed = false;
+        std::vector<std::vector<std::uint8_t>> levels;
+    };
+
+    struct Statistics
+    {
+        std::size_t textureNmb = 0;
+        std::size_t residentBytes = 0;
+        /**
+         * Levels wanted by the reported screen sizes and not uploaded yet
+         */
+        std::size_t pendingNmb = 0;
+        std::size_t uploadedNmb = 0;
+        std::size_t evictionNmb = 0;
+    };
+
+    /**
+     * \brief Levels up to this size are uploaded with the texture and never evicted
+     */
+    static constexpr int MIN_RESIDENT_SIZE = 64;
+    /**
+     * \brief Bytes of finer levels uploaded per frame, a bigger level is still uploaded alone
+     */
+    static constexpr std::size_t UPLOAD_BUDGET = 8 * 1024 * 1024;
+    static constexpr std::size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+    /**
+     * \brief Stream mipChain in the texture textureName, uploading its smallest levels right away
+     */
+    static void AddTexture(unsigned int textureName, MipChain&& mipChain);
+
+    /**
+     * \brief Stop streaming textureName, to call before deleting the texture
+     */
+    static void RemoveTexture(unsigned int textureName);
+
+    /**
+     * \brief Upload every level of textureName now and never evict them, for code that copies the texture
+     * or freezes its state, like bindless handles
+     */
+    static void Pin(unsigned int textureName);
+
+    /**
+     * \brief Feedback of a draw sampling textureName over screenSize pixels along the largest side of the surface.
+     * A texture without any feedback wants all its levels.
+     */
+    static void ReportUsage(unsigned int textureName, float screenSize);
+
+    /**
+     * \brief Pixels covered by worldSize units at distance of a perspective camera with fovY in radians,
+     * for ReportUsage
+     */
+    [[nodiscard]] static float GetScreenSize(float worldSize, float distance, float fovY, int screenHeight);
+
+    /**
+     * \brief Evict down to the budget and upload the wanted levels within the frame upload budget
+     */
+    static void Update();
+
+    static void Destroy();
+
+    [[nodiscard]] static const Statistics& GetStatistics()
+    { return statistics_; }
+
+    static void SetMemoryBudget(std::size_t memoryBudget)
+    { memoryBudget_ = memoryBudget; }
+
+    [[nodiscard]] static std::size_t GetMemoryBudget()
+    { return memoryBudget_; }
+
+private:
+    struct Entry
+    {
+        unsigned int textureName = 0;
+        MipChain mipChain;
+        /**
+         * Finest resident level, the base level of the texture
+         */
+        int residentLevel = 0;
+        /**
+         * Levels from this one are always resident
+         */
+        int minResidentLevel = 0;
+        int wantedLevel = 0;
+        /**
+         * Finest level reported this frame, the level count if there was no report
+         */
+        int reportedLevel = 0;
+        bool hasFeedback = false;
+        bool pinned = false;
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    [[nodiscard]] static Entry* FindEntry(unsigned int textureName);
+
+    static void UploadLevel(Entry& entry, int level);
+
+    static void EvictLevel(Entry& entry);
+
+    /**
+     * \brief Entry whose finest level goes first, over resident ones then the least recently used.
+     * With a requester, only the over resident entries and the ones used less recently than it are considered.
+     */
+    [[nodiscard]] static Entry* FindEvictionCandidate(const Entry* requester);
+
+    static std::vector<Entry> entries_;
+    static Statistics statistics_;
+    inline static std::size_t memoryBudget_ = DEFAULT_MEMORY_BUDGET;
+    inline static std::uint64_t frameIndex_ = 0;
+};
+}
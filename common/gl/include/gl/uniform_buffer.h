@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+namespace gl
+{
+
+/**
+ * \brief Binding points shared by every program, a block named like UNIFORM_BLOCK_NAMES is bound to it on link
+ */
+enum class UniformBlockBinding : unsigned
+{
+    CAMERA = 0,
+    LIGHTS,
+    LENGTH
+};
+
+constexpr std::array<std::string_view, static_cast<std::size_t>(UniformBlockBinding::LENGTH)> UNIFORM_BLOCK_NAMES =
+        {
+                "Camera",
+                "Lights"
+        };
+
+[[nodiscard]] std::optional<UniformBlockBinding> GetUniformBlockBinding(std::string_view blockName);
+
+/**
+ * \brief Types with the size and alignment of the std140 layout, to build blocks matching the GLSL declaration
+ */
+namespace std140
+{
+using Float = float;
+using Int = std::int32_t;
+//GLSL bool is 4 bytes in a block
+using Bool = std::int32_t;
+using Vec2 = glm::vec2;
+using Vec4 = glm::vec4;
+using Mat4 = glm::mat4;
+
+/**
+ * \brief vec3 is aligned on 16 bytes, a following scalar may use its last 4 bytes but another vec3 may not
+ */
+struct alignas(16) Vec3
+{
+    Vec3() = default;
+
+    Vec3(glm::vec3 v) : value(v)
+    {}
+
+    glm::vec3 value{};
+};
+
+/**
+ * \brief Array elements and structs are rounded up to 16 bytes whatever their type
+ */
+template<typename T>
+struct alignas(16) ArrayElement
+{
+    ArrayElement() = default;
+
+    ArrayElement(const T& v) : value(v)
+    {}
+
+    T value{};
+};
+
+static_assert(sizeof(Vec3) == 16);
+static_assert(sizeof(ArrayElement<float>) == 16);
+static_assert(sizeof(Mat4) == 64);
+}
+
+/**
+ * \brief Camera matrices and position
+ * \code
+ * layout(std140) uniform Camera
+ * {
+ *     mat4 view;
+ *     mat4 projection;
+ *     vec3 viewPos;
+ * };
+ * \endcode
+ */
+struct CameraBlock
+{
+    std140::Mat4 view{1.0f};
+    std140::Mat4 projection{1.0f};
+    std140::Vec3 viewPos;
+};
+
+/**
+ * \brief Element of a Lights block made of an array of point lights
+ * \code
+ * struct Light
+ * {
+ *     vec3 position;
+ *     vec3 color;
+ * };
+ * layout(std140) uniform Lights
+ * {
+ *     Light lights[NR_LIGHTS];
+ * };
+ * \endcode
+ */
+struct PointLightData
+{
+    std140::Vec3 position;
+    std140::Vec3 color;
+};
+
+template<std::size_t N>
+using PointLightsBlock = std::array<PointLightData, N>;
+
+static_assert(sizeof(PointLightData) == 32);
+static_assert(offsetof(CameraBlock, viewPos) == 128);
+static_assert(sizeof(CameraBlock) == 144);
+
+/**
+ * \brief Buffer backing a uniform block, uploaded once per frame and read by every program declaring the block
+ */
+class UniformBuffer
+{
+public:
+    ~UniformBuffer();
+
+    void Create(std::size_t size, UniformBlockBinding binding);
+
+    template<typename T>
+    void Create(UniformBlockBinding binding)
+    {
+        Create(sizeof(T), binding);
+    }
+
+    void Destroy();
+
+    void Update(const void* data, std::size_t size, std::size_t offset = 0);
+
+    template<typename T>
+    void Update(const T& block)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Update(&block, sizeof(T));
+    }
+
+    /**
+     * \brief Attach the buffer to its binding point, done on Create, only needed if another buffer took the point
+     */
+    void Bind() const;
+
+    [[nodiscard]] unsigned int GetName() const
+    { return buffer_; }
+
+    [[nodiscard]] std::size_t GetSize() const
+    { return size_; }
+
+    [[nodiscard]] UniformBlockBinding GetBinding() const
+    { return binding_; }
+
+private:
+    unsigned int buffer_ = 0;
+    std::size_t size_ = 0;
+    UniformBlockBinding binding_ = UniformBlockBinding::CAMERA;
+};
+}
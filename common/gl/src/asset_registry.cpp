@@ -0,0 +1,115 @@
+#include "gl/asset_registry.h"
+
+#include "fmt/core.h"
+#include "log.h"
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace gl
+{
+std::unordered_map<std::string, std::shared_ptr<Texture>> AssetRegistry::textures_;
+std::unordered_map<std::string, std::shared_ptr<Model>> AssetRegistry::models_;
+
+namespace
+{
+/**
+ * \brief Asset of key in assets, made with load the first time
+ */
+template<typename T, typename LoadFunction>
+std::shared_ptr<T> FindOrLoad(std::unordered_map<std::string, std::shared_ptr<T>>& assets, std::string&& key,
+                              std::size_t& hitNmb, std::size_t& missNmb, LoadFunction load)
+{
+    const auto it = assets.find(key);
+    if (it != assets.end())
+    {
+        hitNmb++;
+        return it->second;
+    }
+    missNmb++;
+    auto asset = std::make_shared<T>();
+    load(*asset);
+    assets.emplace(std::move(key), asset);
+    return asset;
+}
+
+/**
+ * \brief Destroy the assets only the registry holds, or all of them if all
+ */
+template<typename T>
+void Release(std::unordered_map<std::string, std::shared_ptr<T>>& assets, bool all)
+{
+    std::erase_if(assets, [all](auto& entry)
+    {
+        auto& [key, asset] = entry;
+        if (asset.use_count() > 1)
+        {
+            if (!all)
+            {
+                return false;
+            }
+            core::LogWarning(fmt::format("Asset {} is still used", key));
+        }
+        asset->Destroy();
+        return true;
+    });
+}
+}
+
+std::shared_ptr<Texture> AssetRegistry::LoadTexture(std::string_view path, std::uint8_t textureFlags)
+{
+    return FindOrLoad(textures_, fmt::format("{}:{}", path, textureFlags), hitNmb_, missNmb_,
+                      [path, textureFlags](Texture& texture)
+                      {
+                          texture.LoadTexture(path, textureFlags);
+                      });
+}
+
+std::shared_ptr<Texture> AssetRegistry::LoadTextureAsync(std::string_view path, std::uint8_t textureFlags)
+{
+    return FindOrLoad(textures_, fmt::format("{}:{}", path, textureFlags), hitNmb_, missNmb_,
+                      [path, textureFlags](Texture& texture)
+                      {
+                          texture.LoadTextureAsync(path, textureFlags);
+                      });
+}
+
+std::shared_ptr<Model> AssetRegistry::LoadModel(std::string_view path, Mesh::VertexFormat format,
+                                                std::size_t lodCount)
+{
+    return FindOrLoad(models_, fmt::format("{}:{}:{}", path, static_cast<int>(format), lodCount),
+                      hitNmb_, missNmb_, [path, format, lodCount](Model& model)
+                      {
+                          model.LoadModel(path, format, lodCount);
+                      });
+}
+
+void AssetRegistry::ReleaseUnused()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //Models hold their textures, they go first
+    Release(models_, false);
+    Release(textures_, false);
+}
+
+void AssetRegistry::Destroy()
+{
+    Release(models_, true);
+    Release(textures_, true);
+    hitNmb_ = 0;
+    missNmb_ = 0;
+}
+
+AssetRegistry::Statistics AssetRegistry::GetStatistics()
+{
+    Statistics statistics;
+    statistics.textureNmb = textures_.size();
+    statistics.modelNmb = models_.size();
+    statistics.hitNmb = hitNmb_;
+    statistics.missNmb = missNmb_;
+    return statistics;
+}
+}
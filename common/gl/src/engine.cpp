@@ -1,11 +1,20 @@
 #include <gl/engine.h>
 #include <GL/glew.h>
+#include <gl/asset_registry.h>
 #include <gl/error.h>
+#include <gl/gpu_profiler.h>
+#include <gl/program_cache.h>
+#include <gl/render_target_pool.h>
+#include <gl/shader.h>
+#include <gl/state_cache.h>
+#include <gl/texture_loader.h>
+#include <gl/texture_residency.h>
 
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
 #include "imgui_impl_sdl2.h"
 #include "log.h"
+#include "fmt/core.h"
 
 #ifdef TRACY_ENABLE
 #include "tracy/Tracy.hpp"
@@ -36,8 +45,13 @@ void Engine::Init()
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
 
+#ifdef GL_ERROR_CHECK_CALLBACK
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
+                        SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG | SDL_GL_CONTEXT_DEBUG_FLAG);
+#else
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
                         SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+#endif
     SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
 
 
@@ -77,7 +91,12 @@ void Engine::Init()
         core::LogError("Failed to initialize GLEW");
         std::terminate();
     }
+#ifdef GL_ERROR_CHECK_CALLBACK
+    EnableDebugOutput();
+#endif
     glCheckError();
+    ShaderProgram::EnableParallelCompilation();
+    TextureLoader::Init();
 #ifdef TRACY_ENABLE
     TracyGpuContext
 #endif
@@ -151,18 +170,33 @@ void Engine::Run()
         ImGui::NewFrame();
         DrawImGui();
         ImGui::Render();
+        GpuProfiler::BeginFrame();
         glClearColor(0, 0, 0, 1);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glCheckError();
-        program_.Update(dt);
+        {
+            GpuProfiler::Scope textureScope("Texture Uploads");
+            TextureLoader::Update();
+            TextureResidency::Update();
+        }
+        {
+            GpuProfiler::Scope programScope("Program Update");
+            program_.Update(dt);
+        }
+        RenderTargetPool::Update();
         {
 #ifdef TRACY_ENABLE
             ZoneNamedN(imguiRender, "ImGui Render Data", true);
             TracyGpuNamedZone(gpuImguiRender, "ImGui Render Data", true);
 #endif
+            GpuProfiler::Scope imguiScope("ImGui Render");
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
             glCheckError();
+            //The ImGui backend binds its own objects without going through the state cache
+            StateCache::Invalidate();
         }
+        StateCache::EndFrame();
+        GpuProfiler::EndFrame();
 #ifdef TRACY_ENABLE
         ZoneNamedN(swapWindow, "Swap Window", true);
         TracyGpuNamedZone(gpuSwapWindow, "Swap Window", true);
@@ -182,6 +216,11 @@ void Engine::Run()
 void Engine::Destroy()
 {
     program_.Destroy();
+    AssetRegistry::Destroy();
+    RenderTargetPool::Destroy();
+    GpuProfiler::Destroy();
+    TextureLoader::Destroy();
+    TextureResidency::Destroy();
     ImGui_ImplOpenGL3_Shutdown();
     glCheckError();
     // Delete our OpengL context
@@ -197,6 +236,75 @@ void Engine::DrawImGui()
 {
     ImGui::Begin("Engine");
     ImGui::Text("FPS: %f", 1.0f / deltaTime_);
+    bool programCacheEnabled = ProgramCache::IsEnabled();
+    if (ImGui::Checkbox("Program Binary Cache", &programCacheEnabled))
+    {
+        ProgramCache::SetEnabled(programCacheEnabled);
+    }
+    const auto& programStatistics = ProgramCache::GetStatistics();
+    ImGui::Text("Programs compiled: %zu in %.2f ms", programStatistics.compiledNmb, programStatistics.compileTime);
+    ImGui::Text("Programs from cache: %zu in %.2f ms", programStatistics.cachedNmb, programStatistics.cacheTime);
+    const auto& stateStatistics = StateCache::GetFrameStatistics();
+    ImGui::Text("GL state calls issued: %zu elided: %zu", stateStatistics.issuedNmb, stateStatistics.elidedNmb);
+    bool asyncTextureLoading = TextureLoader::IsEnabled();
+    if (ImGui::Checkbox("Async Texture Loading", &asyncTextureLoading))
+    {
+        TextureLoader::SetEnabled(asyncTextureLoading);
+    }
+    const auto& textureStatistics = TextureLoader::GetStatistics();
+    ImGui::Text("Textures pending: %zu uploaded: %zu (%.1f MB)", textureStatistics.pendingNmb,
+                textureStatistics.uploadedNmb,
+                static_cast<double>(textureStatistics.uploadedBytes) / (1024.0 * 1024.0));
+    const auto assetStatistics = AssetRegistry::GetStatistics();
+    ImGui::Text("Assets textures: %zu models: %zu", assetStatistics.textureNmb, assetStatistics.modelNmb);
+    ImGui::Text("Asset loads shared: %zu new: %zu", assetStatistics.hitNmb, assetStatistics.missNmb);
+    if (ImGui::Button("Release Unused Assets"))
+    {
+        AssetRegistry::ReleaseUnused();
+    }
+    const auto& renderTargetStatistics = RenderTargetPool::GetStatistics();
+    ImGui::Text("Render targets: %zu (%.1f MB) acquired: %.1f MB", renderTargetStatistics.targetNmb,
+                static_cast<double>(renderTargetStatistics.allocatedBytes) / (1024.0 * 1024.0),
+                static_cast<double>(renderTargetStatistics.acquiredBytes) / (1024.0 * 1024.0));
+    if (ImGui::CollapsingHeader("Texture Streaming"))
+    {
+        int memoryBudget = static_cast<int>(TextureResidency::GetMemoryBudget() / (1024 * 1024));
+        if (ImGui::SliderInt("VRAM Budget (MB)", &memoryBudget, 1, 1024))
+        {
+            TextureResidency::SetMemoryBudget(static_cast<std::size_t>(memoryBudget) * 1024 * 1024);
+        }
+        const auto& residencyStatistics = TextureResidency::GetStatistics();
+        ImGui::Text("Streamed textures: %zu resident: %.1f MB", residencyStatistics.textureNmb,
+                    static_cast<double>(residencyStatistics.residentBytes) / (1024.0 * 1024.0));
+        ImGui::Text("Levels pending: %zu uploaded: %zu evicted: %zu", residencyStatistics.pendingNmb,
+                    residencyStatistics.uploadedNmb, residencyStatistics.evictionNmb);
+    }
+    if (ImGui::CollapsingHeader("GPU Profiler"))
+    {
+        bool gpuProfilerEnabled = GpuProfiler::IsEnabled();
+        if (ImGui::Checkbox("Enable GPU Profiler", &gpuProfilerEnabled))
+        {
+            GpuProfiler::SetEnabled(gpuProfilerEnabled);
+        }
+        const auto frameTime = GpuProfiler::GetFrameTime();
+        ImGui::Text("GPU frame: %.3f ms dropped frames: %zu", frameTime, GpuProfiler::GetDroppedFrameNmb());
+        //One bar per scope, filled by its share of the frame
+        for (const auto& timing : GpuProfiler::GetTimings())
+        {
+            if (timing.depth == 0)
+            {
+                continue;
+            }
+            const auto label = fmt::format("{:>{}}{} {:.3f} ms", "", (timing.depth - 1) * 2, timing.name,
+                                           timing.averageTime);
+            const auto fraction = frameTime > 0.0 ? static_cast<float>(timing.averageTime / frameTime) : 0.0f;
+            ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), label.c_str());
+        }
+        if (ImGui::Button("Export Chrome Trace"))
+        {
+            GpuProfiler::ExportChromeTrace(GpuProfiler::TRACE_PATH);
+        }
+    }
     ImGui::End();
     program_.DrawImGui();
 }
@@ -3,12 +3,107 @@
 //
 
 #include "gl/error.h"
+#include "gl/state_cache.h"
 #include <GL/glew.h>
 #include <fmt/core.h>
 #include "log.h"
 
 namespace gl
 {
+namespace
+{
+struct ErrorContext
+{
+    const char* file = "unknown";
+    int line = 0;
+};
+
+ErrorContext errorContext;
+
+std::string_view GetDebugSourceName(GLenum source)
+{
+    switch (source)
+    {
+        case GL_DEBUG_SOURCE_API:
+            return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+            return "Window System";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER:
+            return "Shader Compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:
+            return "Third Party";
+        case GL_DEBUG_SOURCE_APPLICATION:
+            return "Application";
+        default:
+            return "Other";
+    }
+}
+
+std::string_view GetDebugTypeName(GLenum type)
+{
+    switch (type)
+    {
+        case GL_DEBUG_TYPE_ERROR:
+            return "Error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+            return "Deprecated Behavior";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+            return "Undefined Behavior";
+        case GL_DEBUG_TYPE_PORTABILITY:
+            return "Portability";
+        case GL_DEBUG_TYPE_PERFORMANCE:
+            return "Performance";
+        default:
+            return "Other";
+    }
+}
+
+void GLAPIENTRY DebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                     GLsizei length, const GLchar* message, [[maybe_unused]] const void* userParam)
+{
+    const auto log = fmt::format("File: {} Line: {} OpenGL {} {} ({}): {}",
+                                 errorContext.file, errorContext.line,
+                                 GetDebugSourceName(source), GetDebugTypeName(type), id,
+                                 std::string_view(message, length));
+    switch (severity)
+    {
+        case GL_DEBUG_SEVERITY_HIGH:
+            core::LogError(log);
+            break;
+        case GL_DEBUG_SEVERITY_MEDIUM:
+            core::LogWarning(log);
+            break;
+        default:
+            core::LogDebug(log);
+            break;
+    }
+}
+}
+
+void SetErrorContext(const char* file, int line)
+{
+    errorContext = {file, line};
+}
+
+void EnableDebugOutput()
+{
+    if (!GLEW_KHR_debug)
+    {
+        core::LogWarning("KHR_debug is not supported, OpenGL errors will not be reported");
+        return;
+    }
+    GLint contextFlags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &contextFlags);
+    if (!(contextFlags & GL_CONTEXT_FLAG_DEBUG_BIT))
+    {
+        core::LogWarning("OpenGL context is not a debug context, the driver may not report errors");
+    }
+    StateCache::Enable(GL_DEBUG_OUTPUT);
+    //Synchronous output calls back inside the faulting call, so the context is the last glCheckError before it
+    StateCache::Enable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(DebugMessageCallback, nullptr);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+}
 
 void CheckError(std::string_view file, int line)
 {
@@ -0,0 +1,335 @@
+#include "gl/frame_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <ranges>
+
+#include "gl/gpu_profiler.h"
+#include "log.h"
+#include "fmt/core.h"
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+FrameGraph::ResourceHandle FrameGraph::PassBuilder::Read(ResourceHandle resource)
+{
+    if (resource >= frameGraph_.resources_.size())
+    {
+        core::LogError(fmt::format("[Error] Pass {} reads an unknown resource",
+                                   frameGraph_.passes_[passIndex_].name));
+        return INVALID_RESOURCE;
+    }
+    frameGraph_.passes_[passIndex_].reads.push_back(resource);
+    frameGraph_.resources_[resource].readers.push_back(passIndex_);
+    return resource;
+}
+
+FrameGraph::ResourceHandle FrameGraph::PassBuilder::Write(ResourceHandle resource)
+{
+    if (resource >= frameGraph_.resources_.size())
+    {
+        core::LogError(fmt::format("[Error] Pass {} writes an unknown resource",
+                                   frameGraph_.passes_[passIndex_].name));
+        return INVALID_RESOURCE;
+    }
+    frameGraph_.passes_[passIndex_].writes.push_back(resource);
+    frameGraph_.resources_[resource].writers.push_back(passIndex_);
+    return resource;
+}
+
+void FrameGraph::PassBuilder::SetSideEffect()
+{
+    frameGraph_.passes_[passIndex_].sideEffect = true;
+}
+
+unsigned int FrameGraph::PassResources::GetTexture(ResourceHandle resource) const
+{
+    const auto& frameResource = frameGraph_.resources_[resource];
+    if (frameResource.textureName == 0)
+    {
+        core::LogError(fmt::format("[Error] Resource {} is not allocated, it is not declared by the pass",
+                                   frameResource.name));
+    }
+    return frameResource.textureName;
+}
+
+void FrameGraph::PassResources::BindFramebuffer(std::initializer_list<ResourceHandle> colorResources,
+                                                ResourceHandle depthResource) const
+{
+    std::vector<unsigned int> colorTargets;
+    colorTargets.reserve(colorResources.size());
+    for (const auto resource : colorResources)
+    {
+        colorTargets.push_back(GetTexture(resource));
+    }
+    const auto depthTarget = depthResource == INVALID_RESOURCE ? 0 : GetTexture(depthResource);
+    RenderTargetPool::BindFramebuffer(std::span<const unsigned int>(colorTargets), depthTarget);
+}
+
+FrameGraph::ResourceHandle FrameGraph::CreateResource(std::string_view name, const RenderTargetDesc& desc)
+{
+    auto& resource = resources_.emplace_back();
+    resource.name = name;
+    resource.desc = desc;
+    return resources_.size() - 1;
+}
+
+FrameGraph::ResourceHandle FrameGraph::ImportResource(std::string_view name, unsigned int textureName)
+{
+    auto& resource = resources_.emplace_back();
+    resource.name = name;
+    resource.textureName = textureName;
+    resource.imported = true;
+    return resources_.size() - 1;
+}
+
+void FrameGraph::AddPass(std::string_view name, const SetupFunction& setup, ExecuteFunction&& execute)
+{
+    auto& pass = passes_.emplace_back();
+    pass.name = name;
+    pass.execute = std::move(execute);
+    PassBuilder builder(*this, passes_.size() - 1);
+    setup(builder);
+}
+
+void FrameGraph::Execute()
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Frame Graph Execute");
+#endif
+    statistics_ = {};
+    statistics_.passNmb = passes_.size();
+    CullPasses();
+    OrderPasses();
+    statistics_.culledPassNmb = passes_.size() - executionOrder_.size();
+
+    //Transient resources are acquired before their first pass and released after their last one
+    constexpr auto noUse = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> firstUse(resources_.size(), noUse);
+    std::vector<std::size_t> lastUse(resources_.size(), noUse);
+    for (std::size_t step = 0; step < executionOrder_.size(); step++)
+    {
+        const auto& pass = passes_[executionOrder_[step]];
+        for (const auto& resources : {std::cref(pass.reads), std::cref(pass.writes)})
+        {
+            for (const auto resource : resources.get())
+            {
+                if (firstUse[resource] == noUse)
+                {
+                    firstUse[resource] = step;
+                }
+                lastUse[resource] = step;
+            }
+        }
+    }
+    for (std::size_t resource = 0; resource < resources_.size(); resource++)
+    {
+        const auto& frameResource = resources_[resource];
+        if (frameResource.imported || firstUse[resource] == noUse)
+        {
+            continue;
+        }
+        statistics_.transientNmb++;
+        statistics_.transientBytes += RenderTargetPool::GetByteSize(frameResource.desc);
+        if (frameResource.writers.empty())
+        {
+            core::LogWarning(fmt::format("Resource {} is read but no pass writes it", frameResource.name));
+        }
+    }
+
+    for (std::size_t step = 0; step < executionOrder_.size(); step++)
+    {
+        for (std::size_t resource = 0; resource < resources_.size(); resource++)
+        {
+            if (firstUse[resource] == step && !resources_[resource].imported)
+            {
+                resources_[resource].textureName = RenderTargetPool::Acquire(resources_[resource].desc);
+            }
+        }
+        auto& pass = passes_[executionOrder_[step]];
+        {
+#ifdef TRACY_ENABLE
+            ZoneTransientN(passZone, pass.name.c_str(), true);
+            TracyGpuZoneTransient(passGpuZone, pass.name.c_str(), true);
+#endif
+            GpuProfiler::Scope passScope(pass.name);
+            if (pass.execute)
+            {
+                pass.execute(PassResources(*this));
+            }
+        }
+        for (std::size_t resource = 0; resource < resources_.size(); resource++)
+        {
+            if (lastUse[resource] == step && !resources_[resource].imported)
+            {
+                RenderTargetPool::Release(resources_[resource].textureName);
+                resources_[resource].textureName = 0;
+            }
+        }
+    }
+}
+
+void FrameGraph::Clear()
+{
+    resources_.clear();
+    passes_.clear();
+    executionOrder_.clear();
+}
+
+std::vector<std::string_view> FrameGraph::GetExecutedPasses() const
+{
+    std::vector<std::string_view> names;
+    names.reserve(executionOrder_.size());
+    for (const auto passIndex : executionOrder_)
+    {
+        names.emplace_back(passes_[passIndex].name);
+    }
+    return names;
+}
+
+void FrameGraph::CullPasses()
+{
+    std::vector<std::size_t> keptPasses;
+    for (std::size_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+    {
+        auto& pass = passes_[passIndex];
+        pass.kept = pass.sideEffect || std::ranges::any_of(pass.writes, [this](ResourceHandle resource)
+        {
+            return resources_[resource].imported;
+        });
+        if (pass.kept)
+        {
+            keptPasses.push_back(passIndex);
+        }
+    }
+    //The writers of what a kept pass reads are kept too
+    while (!keptPasses.empty())
+    {
+        const auto passIndex = keptPasses.back();
+        keptPasses.pop_back();
+        for (const auto resource : passes_[passIndex].reads)
+        {
+            for (const auto writer : resources_[resource].writers)
+            {
+                if (!passes_[writer].kept)
+                {
+                    passes_[writer].kept = true;
+                    keptPasses.push_back(writer);
+                }
+            }
+        }
+    }
+}
+
+void FrameGraph::OrderPasses()
+{
+    std::vector<std::vector<std::size_t>> successors(passes_.size());
+    std::vector<std::size_t> predecessorCounts(passes_.size(), 0);
+    const auto addEdge = [&successors, &predecessorCounts](std::size_t from, std::size_t to)
+    {
+        if (from == to || std::ranges::find(successors[from], to) != successors[from].end())
+        {
+            return;
+        }
+        successors[from].push_back(to);
+        predecessorCounts[to]++;
+    };
+    const auto isKept = [this](std::size_t passIndex)
+    {
+        return passes_[passIndex].kept;
+    };
+    for (ResourceHandle resource = 0; resource < resources_.size(); resource++)
+    {
+        std::vector<std::size_t> writers;
+        std::vector<std::size_t> modifiers;
+        std::vector<std::size_t> readers;
+        for (const auto writer : resources_[resource].writers | std::views::filter(isKept))
+        {
+            (IsModifier(writer, resource) ? modifiers : writers).push_back(writer);
+        }
+        for (const auto reader : resources_[resource].readers | std::views::filter(isKept))
+        {
+            if (!IsModifier(reader, resource))
+            {
+                readers.push_back(reader);
+            }
+        }
+        for (const auto writer : writers)
+        {
+            if (!modifiers.empty())
+            {
+                addEdge(writer, modifiers.front());
+            }
+            for (const auto reader : readers)
+            {
+                addEdge(writer, reader);
+            }
+        }
+        for (std::size_t i = 0; i + 1 < modifiers.size(); i++)
+        {
+            addEdge(modifiers[i], modifiers[i + 1]);
+        }
+        if (!modifiers.empty())
+        {
+            for (const auto reader : readers)
+            {
+                addEdge(modifiers.back(), reader);
+            }
+        }
+    }
+
+    //Among the passes ready to run, the first added goes first
+    executionOrder_.clear();
+    std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> readyPasses;
+    std::size_t keptNmb = 0;
+    for (std::size_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+    {
+        if (!passes_[passIndex].kept)
+        {
+            continue;
+        }
+        keptNmb++;
+        if (predecessorCounts[passIndex] == 0)
+        {
+            readyPasses.push(passIndex);
+        }
+    }
+    while (!readyPasses.empty())
+    {
+        const auto passIndex = readyPasses.top();
+        readyPasses.pop();
+        executionOrder_.push_back(passIndex);
+        for (const auto successor : successors[passIndex])
+        {
+            if (--predecessorCounts[successor] == 0)
+            {
+                readyPasses.push(successor);
+            }
+        }
+    }
+    if (executionOrder_.size() != keptNmb)
+    {
+        core::LogError("[Error] Frame graph passes depend on each other in a cycle, they run in the order added");
+        executionOrder_.clear();
+        for (std::size_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+        {
+            if (passes_[passIndex].kept)
+            {
+                executionOrder_.push_back(passIndex);
+            }
+        }
+    }
+}
+
+bool FrameGraph::IsModifier(std::size_t passIndex, ResourceHandle resource) const
+{
+    const auto& pass = passes_[passIndex];
+    return std::ranges::find(pass.reads, resource) != pass.reads.end() &&
+           std::ranges::find(pass.writes, resource) != pass.writes.end();
+}
+}
@@ -6,6 +6,7 @@
 #include "gl/framebuffer.h"
 #include "log.h"
 #include "gl/error.h"
+#include "gl/state_cache.h"
 #include "fmt/core.h"
 
 #include <algorithm>
@@ -53,7 +54,7 @@ void Framebuffer::Create()
         if (frameBufferType_ & DEPTH_CUBEMAP)
         {
             glGenTextures(1, &depthBuffer_);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, depthBuffer_);
+            StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, depthBuffer_);
             for (unsigned int i = 0; i < 6; ++i)
             {
                 glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT16,
@@ -64,7 +65,7 @@ void Framebuffer::Create()
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
             glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X,
                                    depthBuffer_, 0);
             glCheckError();
@@ -72,7 +73,7 @@ void Framebuffer::Create()
         else
         {
             glGenTextures(1, &depthBuffer_);
-            glBindTexture(GL_TEXTURE_2D, depthBuffer_);
+            StateCache::BindTexture(GL_TEXTURE_2D, depthBuffer_);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16,
                          size_.x, size_.y, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT,
                          nullptr);
@@ -87,7 +88,7 @@ void Framebuffer::Create()
             glFramebufferTexture2D(GL_FRAMEBUFFER,
                                    GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthBuffer_,
                                    0);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            StateCache::BindTexture(GL_TEXTURE_2D, 0);
             glCheckError();
         }
     }
@@ -140,7 +141,7 @@ void Framebuffer::Create()
         {
             if (frameBufferType_ & COLOR_CUBEMAP)
             {
-                glBindTexture(GL_TEXTURE_CUBE_MAP, colorBuffers_[i]);
+                StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, colorBuffers_[i]);
                 for (int j = 0; j < 6; j++)
                 {
                     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + j, 0,
@@ -154,14 +155,14 @@ void Framebuffer::Create()
                 glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
                 // we clamp to the edge as the blur filter would otherwise sample repeated texture values!
                 glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+                StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i,
                     GL_TEXTURE_CUBE_MAP_POSITIVE_X, colorBuffers_[i], 0);
                 glCheckError();
             }
             else
             {
-                glBindTexture(GL_TEXTURE_2D, colorBuffers_[i]);
+                StateCache::BindTexture(GL_TEXTURE_2D, colorBuffers_[i]);
                 glTexImage2D(GL_TEXTURE_2D, 0,
                              internalColorFormat, size_.x,
                              size_.y, 0, colorFormat,
@@ -172,7 +173,7 @@ void Framebuffer::Create()
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
                 // we clamp to the edge as the blur filter would otherwise sample repeated texture values!
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                glBindTexture(GL_TEXTURE_2D, 0);
+                StateCache::BindTexture(GL_TEXTURE_2D, 0);
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i,
                                        GL_TEXTURE_2D, colorBuffers_[i], 0);
                 glCheckError();
@@ -212,11 +213,11 @@ void Framebuffer::Destroy()
     {
         if(colorBuffer != 0)
         {
-            glDeleteTextures(colorAttachmentNmb, &colorBuffer);
+            StateCache::DeleteTextures(colorAttachmentNmb, &colorBuffer);
         }
     }
     if (depthBuffer_)
-        glDeleteTextures(1, &depthBuffer_);
+        StateCache::DeleteTextures(1, &depthBuffer_);
     if (depthRbo_)
         glDeleteRenderbuffers(1, &depthRbo_);
     glCheckError();
@@ -0,0 +1,153 @@
+#include "gl/geometry_pool.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+#include "log.h"
+
+#include <GL/glew.h>
+#include <fmt/core.h>
+
+#include <array>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+
+GeometryPool::~GeometryPool()
+{
+    if (vao_ != 0)
+    {
+        core::LogWarning("Geometry pool is not free");
+    }
+}
+
+void GeometryPool::Create(std::size_t vertexCapacity, std::size_t indexCapacity)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Create Geometry Pool");
+#endif
+    vertexCapacity_ = vertexCapacity;
+    indexCapacity_ = indexCapacity;
+    vertexCount_ = 0;
+    indexCount_ = 0;
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ebo_);
+    glGenBuffers(1, &commandBuffer_);
+    glGenBuffers(1, &materialBuffer_);
+    StateCache::BindVertexArray(vao_);
+
+    //The pool is only written with glBufferSubData when a mesh is allocated
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCapacity_ * sizeof(Mesh::Vertex)), nullptr,
+                    GL_DYNAMIC_STORAGE_BIT);
+    Mesh::SetVertexAttributes();
+
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, materialBuffer_);
+    glEnableVertexAttribArray(MATERIAL_INDEX_ATTRIBUTE);
+    glVertexAttribIPointer(MATERIAL_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(std::uint32_t), nullptr);
+    glVertexAttribDivisor(MATERIAL_INDEX_ATTRIBUTE, 1);
+
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCapacity_ * sizeof(unsigned int)),
+                    nullptr, GL_DYNAMIC_STORAGE_BIT);
+    StateCache::BindVertexArray(0);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+    glCheckError();
+}
+
+void GeometryPool::Destroy()
+{
+    if (vao_ != 0)
+    {
+#ifdef TRACY_ENABLE
+        ZoneNamedN(poolDestroy, "Geometry Pool Destroy", true);
+        TracyGpuNamedZone(poolDestroyGpu, "Geometry Pool Destroy", true);
+#endif
+        StateCache::DeleteVertexArrays(1, &vao_);
+        vao_ = 0;
+        const std::array buffers = {vbo_, ebo_, commandBuffer_, materialBuffer_};
+        StateCache::DeleteBuffers(static_cast<int>(buffers.size()), buffers.data());
+        vbo_ = 0;
+        ebo_ = 0;
+        commandBuffer_ = 0;
+        materialBuffer_ = 0;
+        glCheckError();
+    }
+    commands_.clear();
+    materialIndices_.clear();
+    vertexCount_ = 0;
+    indexCount_ = 0;
+}
+
+std::optional<GeometryPool::Range> GeometryPool::Allocate(std::span<const Mesh::Vertex> vertices,
+                                                          std::span<const unsigned int> indices)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Allocate In Geometry Pool");
+#endif
+    if (vertexCount_ + vertices.size() > vertexCapacity_ || indexCount_ + indices.size() > indexCapacity_)
+    {
+        core::LogError(fmt::format("[Error] Geometry pool is full, {} vertices and {} indices do not fit",
+                                   vertices.size(), indices.size()));
+        return std::nullopt;
+    }
+    const Range range{
+            static_cast<std::uint32_t>(indices.size()),
+            static_cast<std::uint32_t>(indexCount_),
+            static_cast<std::int32_t>(vertexCount_)};
+
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, vbo_);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(vertexCount_ * sizeof(Mesh::Vertex)),
+                    static_cast<GLsizeiptr>(vertices.size_bytes()), vertices.data());
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, ebo_);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(indexCount_ * sizeof(unsigned int)),
+                    static_cast<GLsizeiptr>(indices.size_bytes()), indices.data());
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glCheckError();
+
+    vertexCount_ += vertices.size();
+    indexCount_ += indices.size();
+    return range;
+}
+
+void GeometryPool::AddDraw(const Range& range, std::uint32_t materialIndex)
+{
+    //The base instance picks the material index of the draw in the per instance attribute
+    commands_.push_back({range.indexCount, 1, range.firstIndex, range.baseVertex,
+                         static_cast<std::uint32_t>(materialIndices_.size())});
+    materialIndices_.push_back(materialIndex);
+}
+
+void GeometryPool::Flush()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Flush Geometry Pool");
+#endif
+    if (commands_.empty())
+    {
+        return;
+    }
+    //Orphan the previous storage, the draws still reading it do not stall the upload
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, materialBuffer_);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(materialIndices_.size() * sizeof(std::uint32_t)),
+                 materialIndices_.data(), GL_STREAM_DRAW);
+    StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer_);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                 static_cast<GLsizeiptr>(commands_.size() * sizeof(DrawElementsIndirectCommand)),
+                 commands_.data(), GL_STREAM_DRAW);
+
+    StateCache::BindVertexArray(vao_);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands_.size()), 0);
+    glCheckError();
+    commands_.clear();
+    materialIndices_.clear();
+}
+}
@@ -0,0 +1,251 @@
+#include "gl/gpu_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+#include <GL/glew.h>
+
+#include "gl/error.h"
+#include "log.h"
+#include "fmt/core.h"
+
+namespace gl
+{
+std::array<GpuProfiler::FrameQueries, GpuProfiler::QUERY_FRAME_NMB> GpuProfiler::frames_;
+std::vector<GpuProfiler::Timing> GpuProfiler::timings_;
+std::deque<std::vector<GpuProfiler::TraceEvent>> GpuProfiler::trace_;
+
+namespace
+{
+constexpr auto NO_MARKER = std::numeric_limits<std::size_t>::max();
+/**
+ * \brief Queries generated at once when a frame needs more
+ */
+constexpr std::size_t QUERY_BATCH = 32;
+
+std::string EscapeJson(std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const auto c : text)
+    {
+        switch (c)
+        {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+                }
+                else
+                {
+                    escaped += c;
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+}
+
+GpuProfiler::Scope::Scope(std::string_view name) : markerIndex_(BeginMarker(name))
+{
+}
+
+GpuProfiler::Scope::~Scope()
+{
+    EndMarker(markerIndex_);
+}
+
+void GpuProfiler::BeginFrame()
+{
+    currentFrame_ = (currentFrame_ + 1) % QUERY_FRAME_NMB;
+    auto& frame = frames_[currentFrame_];
+    if (frame.pending)
+    {
+        ResolveFrame(frame);
+    }
+    frame.usedQueryNmb = 0;
+    frame.markers.clear();
+    frame.pending = false;
+    if (!enabled_)
+    {
+        return;
+    }
+    frameActive_ = true;
+    depth_ = 0;
+    frameMarker_ = BeginMarker("Frame");
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (!frameActive_)
+    {
+        return;
+    }
+    EndMarker(frameMarker_);
+    frameActive_ = false;
+    frames_[currentFrame_].pending = true;
+}
+
+void GpuProfiler::Destroy()
+{
+    for (auto& frame : frames_)
+    {
+        if (!frame.queries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+        frame = {};
+    }
+    glCheckError();
+    timings_.clear();
+    trace_.clear();
+    currentFrame_ = 0;
+    depth_ = 0;
+    frameActive_ = false;
+    droppedFrameNmb_ = 0;
+}
+
+double GpuProfiler::GetFrameTime()
+{
+    return timings_.empty() ? 0.0 : timings_.front().averageTime;
+}
+
+bool GpuProfiler::ExportChromeTrace(std::string_view path)
+{
+    std::ofstream file{std::string(path), std::ofstream::trunc};
+    if (!file)
+    {
+        core::LogError(fmt::format("[Error] Could not write GPU trace file: {}", path));
+        return false;
+    }
+    //Timestamps in microseconds from the first kept frame
+    const auto origin = trace_.empty() || trace_.front().empty() ? 0 : trace_.front().front().begin;
+    file << "{\"traceEvents\":[";
+    bool isFirstEvent = true;
+    for (const auto& events : trace_)
+    {
+        for (const auto& event : events)
+        {
+            file << fmt::format("{}\n{{\"name\":\"{}\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+                                "\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                isFirstEvent ? "" : ",", EscapeJson(event.name),
+                                static_cast<double>(event.begin - origin) / 1000.0,
+                                static_cast<double>(event.end - event.begin) / 1000.0);
+            isFirstEvent = false;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    core::LogDebug(fmt::format("GPU trace of {} frames written to {}", trace_.size(), path));
+    return true;
+}
+
+std::size_t GpuProfiler::BeginMarker(std::string_view name)
+{
+    if (!frameActive_)
+    {
+        return NO_MARKER;
+    }
+    auto& frame = frames_[currentFrame_];
+    auto& marker = frame.markers.emplace_back();
+    marker.name = name;
+    marker.depth = depth_;
+    marker.beginQuery = WriteTimestamp(frame);
+    depth_++;
+    return frame.markers.size() - 1;
+}
+
+void GpuProfiler::EndMarker(std::size_t markerIndex)
+{
+    if (!frameActive_ || markerIndex == NO_MARKER)
+    {
+        return;
+    }
+    auto& frame = frames_[currentFrame_];
+    auto& marker = frame.markers[markerIndex];
+    marker.endQuery = WriteTimestamp(frame);
+    marker.ended = true;
+    depth_--;
+}
+
+std::size_t GpuProfiler::WriteTimestamp(FrameQueries& frame)
+{
+    if (frame.usedQueryNmb == frame.queries.size())
+    {
+        frame.queries.resize(frame.queries.size() + QUERY_BATCH);
+        glGenQueries(QUERY_BATCH, &frame.queries[frame.usedQueryNmb]);
+    }
+    //Timestamps rather than GL_TIME_ELAPSED queries, those cannot be nested
+    glQueryCounter(frame.queries[frame.usedQueryNmb], GL_TIMESTAMP);
+    return frame.usedQueryNmb++;
+}
+
+void GpuProfiler::ResolveFrame(FrameQueries& frame)
+{
+    if (frame.usedQueryNmb == 0)
+    {
+        return;
+    }
+    //Queries complete in order, the last one being available means all of them are
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries[frame.usedQueryNmb - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE)
+    {
+        droppedFrameNmb_++;
+        return;
+    }
+    std::vector<GLuint64> timestamps(frame.usedQueryNmb);
+    for (std::size_t i = 0; i < frame.usedQueryNmb; i++)
+    {
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+    }
+    glCheckError();
+
+    std::vector<Timing> timings;
+    timings.reserve(frame.markers.size());
+    auto& events = trace_.emplace_back();
+    events.reserve(frame.markers.size());
+    for (const auto& marker : frame.markers)
+    {
+        if (!marker.ended)
+        {
+            continue;
+        }
+        const auto begin = timestamps[marker.beginQuery];
+        const auto end = timestamps[marker.endQuery];
+        const auto time = static_cast<double>(end - begin) / 1'000'000.0;
+        //Scopes sharing a name and depth, like the passes of a loop, are matched in order with the last frame
+        const auto isSameScope = [&marker](const Timing& timing)
+        {
+            return timing.depth == marker.depth && timing.name == marker.name;
+        };
+        const auto occurrence = std::ranges::count_if(timings, isSameScope);
+        auto previous = std::ranges::find_if(timings_, isSameScope);
+        for (std::ptrdiff_t i = 0; i < occurrence && previous != timings_.end(); i++)
+        {
+            previous = std::find_if(std::next(previous), timings_.end(), isSameScope);
+        }
+
+        auto& timing = timings.emplace_back();
+        timing.name = marker.name;
+        timing.depth = marker.depth;
+        timing.lastTime = time;
+        timing.averageTime = previous == timings_.end()
+                                 ? time
+                                 : previous->averageTime + (time - previous->averageTime) * AVERAGE_FACTOR;
+        events.push_back({marker.name, begin, end});
+    }
+    timings_ = std::move(timings);
+    if (trace_.size() > TRACE_FRAME_NMB)
+    {
+        trace_.pop_front();
+    }
+}
+}
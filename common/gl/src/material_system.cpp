@@ -0,0 +1,245 @@
+#include "gl/material_system.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+#include "gl/texture_residency.h"
+#include "log.h"
+
+#include <GL/glew.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+namespace
+{
+static_assert(sizeof(MaterialSystem::TextureData) == 16, "TextureData does not follow the std430 layout");
+
+/**
+ * \brief Texture storage only takes sized formats, the textures loaded with an unsized one get its 8 bits version
+ */
+GLenum SizedFormat(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_RED:
+            return GL_R8;
+        case GL_RG:
+            return GL_RG8;
+        case GL_RGB:
+            return GL_RGB8;
+        case GL_RGBA:
+            return GL_RGBA8;
+        case GL_SRGB:
+            return GL_SRGB8;
+        case GL_SRGB_ALPHA:
+            return GL_SRGB8_ALPHA8;
+        default:
+            return internalFormat;
+    }
+}
+
+std::size_t GetSlot(std::string_view textureType)
+{
+    if (textureType == "texture_specular")
+        return static_cast<std::size_t>(MaterialSystem::TextureSlot::SPECULAR);
+    if (textureType == "texture_normal")
+        return static_cast<std::size_t>(MaterialSystem::TextureSlot::NORMAL);
+    return static_cast<std::size_t>(MaterialSystem::TextureSlot::DIFFUSE);
+}
+}
+
+MaterialSystem::~MaterialSystem()
+{
+    if (materialBuffer_ != 0)
+    {
+        core::LogWarning("Material system is not free");
+    }
+}
+
+std::uint32_t MaterialSystem::AddMaterial(std::span<const Mesh::Texture> textures)
+{
+    const auto materialId = Mesh::GetMaterialId(textures);
+    if (const auto it = std::ranges::find(materialIds_, materialId); it != materialIds_.end())
+    {
+        return static_cast<std::uint32_t>(std::distance(materialIds_.begin(), it));
+    }
+    auto& material = materials_.emplace_back();
+    material.fill(NO_TEXTURE);
+    //Like the samplers of BindTextures, only the first texture of each type is used
+    for (const auto& texture : textures)
+    {
+        auto& slot = material[GetSlot(texture.type)];
+        if (slot == NO_TEXTURE && texture.textureName != 0)
+        {
+            slot = AddTexture(texture.textureName);
+        }
+    }
+    materialIds_.push_back(materialId);
+    return static_cast<std::uint32_t>(materials_.size() - 1);
+}
+
+std::uint32_t MaterialSystem::AddTexture(unsigned textureName)
+{
+    if (const auto it = std::ranges::find(textures_, textureName); it != textures_.end())
+    {
+        return static_cast<std::uint32_t>(std::distance(textures_.begin(), it));
+    }
+    textures_.push_back(textureName);
+    return static_cast<std::uint32_t>(textures_.size() - 1);
+}
+
+void MaterialSystem::Build(bool allowBindless)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Build Materials");
+#endif
+    isBindless_ = allowBindless && GLEW_ARB_bindless_texture;
+    //Both the array copies and the handles need every level, which cannot be streamed afterward
+    for (const auto texture : textures_)
+    {
+        TextureResidency::Pin(texture);
+    }
+    std::vector<TextureData> textureData(textures_.size());
+    if (isBindless_)
+    {
+        //The handles keep the sampling state of the textures, which cannot change afterward
+        for (std::size_t i = 0; i < textures_.size(); i++)
+        {
+            const auto handle = glGetTextureHandleARB(textures_[i]);
+            glMakeTextureHandleResidentARB(handle);
+            residentHandles_.push_back(handle);
+            textureData[i].handle = handle;
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < textures_.size(); i++)
+        {
+            GLint width = 0, height = 0, internalFormat = 0;
+            glGetTextureLevelParameteriv(textures_[i], 0, GL_TEXTURE_WIDTH, &width);
+            glGetTextureLevelParameteriv(textures_[i], 0, GL_TEXTURE_HEIGHT, &height);
+            glGetTextureLevelParameteriv(textures_[i], 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+            //Textures loaded without MIPMAP only have their base level
+            int levels = 1;
+            while ((width >> levels) > 0 || (height >> levels) > 0)
+            {
+                GLint levelWidth = 0;
+                glGetTextureLevelParameteriv(textures_[i], levels, GL_TEXTURE_WIDTH, &levelWidth);
+                if (levelWidth == 0)
+                    break;
+                levels++;
+            }
+            const auto format = SizedFormat(static_cast<GLenum>(internalFormat));
+            auto it = std::ranges::find_if(textureArrays_, [&](const TextureArray& textureArray)
+            {
+                return textureArray.width == width && textureArray.height == height &&
+                       textureArray.levels == levels && textureArray.internalFormat == format;
+            });
+            if (it == textureArrays_.end())
+            {
+                if (textureArrays_.size() == MAX_TEXTURE_ARRAYS)
+                {
+                    core::LogError(fmt::format("[Error] Material texture of {}x{} needs more than {} texture arrays",
+                                               width, height, MAX_TEXTURE_ARRAYS));
+                    continue;
+                }
+                textureArrays_.push_back(TextureArray{width, height, levels, format});
+                it = textureArrays_.end() - 1;
+            }
+            textureData[i].array = static_cast<std::uint32_t>(std::distance(textureArrays_.begin(), it));
+            textureData[i].layer = static_cast<std::uint32_t>(it->textures.size());
+            it->textures.push_back(textures_[i]);
+        }
+        for (auto& textureArray : textureArrays_)
+        {
+            glGenTextures(1, &textureArray.name);
+            StateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, textureArray.name);
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, textureArray.levels, textureArray.internalFormat,
+                           textureArray.width, textureArray.height,
+                           static_cast<GLsizei>(textureArray.textures.size()));
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                            textureArray.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            //The texels and mip levels are copied on the GPU, the images are not decoded again
+            for (std::size_t layer = 0; layer < textureArray.textures.size(); layer++)
+            {
+                for (int level = 0; level < textureArray.levels; level++)
+                {
+                    glCopyImageSubData(textureArray.textures[layer], GL_TEXTURE_2D, level, 0, 0, 0,
+                                       textureArray.name, GL_TEXTURE_2D_ARRAY, level, 0, 0,
+                                       static_cast<GLint>(layer),
+                                       std::max(textureArray.width >> level, 1),
+                                       std::max(textureArray.height >> level, 1), 1);
+                }
+            }
+            glCheckError();
+        }
+    }
+
+    std::vector<MaterialData> materialData(materials_.size());
+    for (std::size_t i = 0; i < materials_.size(); i++)
+    {
+        for (std::size_t slot = 0; slot < TEXTURE_SLOT_NMB; slot++)
+        {
+            if (materials_[i][slot] != NO_TEXTURE)
+            {
+                materialData[i].textures[slot] = textureData[materials_[i][slot]];
+            }
+        }
+    }
+    glGenBuffers(1, &materialBuffer_);
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, materialBuffer_);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER,
+                    static_cast<GLsizeiptr>(std::max<std::size_t>(materialData.size(), 1) * sizeof(MaterialData)),
+                    materialData.empty() ? nullptr : materialData.data(), 0);
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glCheckError();
+}
+
+void MaterialSystem::Destroy()
+{
+    for (const auto handle : residentHandles_)
+    {
+        glMakeTextureHandleNonResidentARB(handle);
+    }
+    residentHandles_.clear();
+    for (auto& textureArray : textureArrays_)
+    {
+        if (textureArray.name != 0)
+        {
+            StateCache::DeleteTextures(1, &textureArray.name);
+        }
+    }
+    textureArrays_.clear();
+    if (materialBuffer_ != 0)
+    {
+        StateCache::DeleteBuffers(1, &materialBuffer_);
+        materialBuffer_ = 0;
+    }
+    materials_.clear();
+    materialIds_.clear();
+    textures_.clear();
+    glCheckError();
+}
+
+void MaterialSystem::Bind(ShaderProgram& shader, int firstTextureUnit)
+{
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_STORAGE_BINDING, materialBuffer_);
+    for (std::size_t i = 0; i < textureArrays_.size(); i++)
+    {
+        const auto textureUnit = firstTextureUnit + static_cast<int>(i);
+        StateCache::BindTexture(textureUnit, GL_TEXTURE_2D_ARRAY, textureArrays_[i].name);
+        shader.SetInt(fmt::format("textureArrays[{}]", i), textureUnit);
+    }
+    glCheckError();
+}
+}
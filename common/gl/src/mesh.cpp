@@ -1,6 +1,10 @@
 #include "gl/mesh.h"
 #include "fmt/core.h"
 #include "gl/error.h"
+#include "gl/state_cache.h"
+#include <hash.h>
+#include <mesh_simplifier.h>
+#include <vertex_quantization.h>
 #include <log.h>
 
 #include <GL/glew.h>
@@ -19,7 +23,7 @@ Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices,
         vertices_(std::move(vertices)), indices_(std::move(indices)),
         textures_(std::move(textures))
 {
-
+    lods_.push_back({0, indices_.size()});
 }
 
 Mesh::Mesh(Mesh&& other) noexcept
@@ -27,9 +31,13 @@ Mesh::Mesh(Mesh&& other) noexcept
     vertices_ = std::move(other.vertices_);
     indices_ = std::move(other.indices_);
     textures_ = std::move(other.textures_);
+    lods_ = std::move(other.lods_);
+    minExtend = other.minExtend;
+    maxExtend = other.maxExtend;
     std::swap(vao_, other.vao_);
     std::swap(vbo_, other.vbo_);
     std::swap(ebo_, other.ebo_);
+    std::swap(format_, other.format_);
 }
 
 Mesh& Mesh::operator=(Mesh&& other) noexcept
@@ -37,13 +45,32 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept
     vertices_ = std::move(other.vertices_);
     indices_ = std::move(other.indices_);
     textures_ = std::move(other.textures_);
+    lods_ = std::move(other.lods_);
+    minExtend = other.minExtend;
+    maxExtend = other.maxExtend;
     std::swap(vao_, other.vao_);
     std::swap(vbo_, other.vbo_);
     std::swap(ebo_, other.ebo_);
+    std::swap(format_, other.format_);
     return *this;
 }
 
-void Mesh::SetupMesh()
+void Mesh::GenerateLods(std::size_t lodCount)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto lodIndices = core::GenerateLodChain(GetIndices(), vertices_, lodCount);
+    for (const auto& lod : lodIndices)
+    {
+        lods_.push_back({indices_.size(), lod.size()});
+        indices_.insert(indices_.end(), lod.begin(), lod.end());
+    }
+    core::LogDebug(fmt::format("Generated {} LODs from {} triangles down to {}", lods_.size(),
+                               lods_.front().indexCount / 3, lods_.back().indexCount / 3));
+}
+
+void Mesh::SetupMesh(VertexFormat format)
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
@@ -85,14 +112,41 @@ void Mesh::SetupMesh()
     glGenBuffers(1, &ebo_);
 
     glCheckError();
-    glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-
-    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex),
-                 vertices_.data(), GL_STATIC_DRAW);
-
+    StateCache::BindVertexArray(vao_);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_);
 
+    format_ = format;
+    if (format_ == VertexFormat::QUANTIZED)
+    {
+        //Only the GPU copy is quantized, the pool and the optimizations work on the full vertices
+        std::vector<core::QuantizedVertex> quantizedVertices;
+        quantizedVertices.reserve(vertices_.size());
+        for (const auto& vertex : vertices_)
+        {
+            quantizedVertices.push_back(core::QuantizeVertex(vertex, minExtend, maxExtend));
+        }
+        glBufferData(GL_ARRAY_BUFFER, quantizedVertices.size() * sizeof(core::QuantizedVertex),
+                     quantizedVertices.data(), GL_STATIC_DRAW);
+        glCheckError();
+        SetQuantizedVertexAttributes();
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex),
+                     vertices_.data(), GL_STATIC_DRAW);
+        glCheckError();
+        SetVertexAttributes();
+    }
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 indices_.size() * sizeof(unsigned int),
+                 indices_.data(), GL_STATIC_DRAW);
+    StateCache::BindVertexArray(0);
     glCheckError();
+}
+
+void Mesh::SetVertexAttributes()
+{
     // vertex positions
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
@@ -112,12 +166,40 @@ void Mesh::SetupMesh()
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
                           (void*) offsetof(Vertex, tangent));
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 indices_.size() * sizeof(unsigned int),
-                 indices_.data(), GL_STATIC_DRAW);
-    glBindVertexArray(0);
-    glCheckError();
+}
+
+void Mesh::SetQuantizedVertexAttributes()
+{
+    using core::QuantizedVertex;
+    // vertex positions, in [0,1] of the mesh bounds
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+                          (void*) offsetof(QuantizedVertex, position));
+
+    // vertex texture coords
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(QuantizedVertex),
+                          (void*) offsetof(QuantizedVertex, texCoords));
+
+    // vertex normals, octahedral encoded
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+                          (void*) offsetof(QuantizedVertex, normal));
+
+    // vertex normals tangent, octahedral encoded
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+                          (void*) offsetof(QuantizedVertex, tangent));
+}
+
+void Mesh::BindQuantization(ShaderProgram& shader) const
+{
+    if (format_ != VertexFormat::QUANTIZED)
+    {
+        return;
+    }
+    shader.SetVec3("meshBoundsMin", minExtend);
+    shader.SetVec3("meshBoundsExtent", maxExtend - minExtend);
 }
 
 void Mesh::Draw(ShaderProgram& shader)
@@ -127,13 +209,13 @@ void Mesh::Draw(ShaderProgram& shader)
     TracyGpuZone("Draw Mesh");
 #endif
     BindTextures(shader);
+    BindQuantization(shader);
 
     // draw mesh
-    glBindVertexArray(vao_);
-    glCheckError();
-    glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_INT, nullptr);
+    //The vertex array stays bound, the next mesh drawn with it skips the bind
+    StateCache::BindVertexArray(vao_);
     glCheckError();
-    glBindVertexArray(0);
+    glDrawElements(GL_TRIANGLES, GetIndicesCount(), GL_UNSIGNED_INT, nullptr);
     glCheckError();
 }
 
@@ -153,18 +235,18 @@ void Mesh::Destroy()
         ZoneNamedN(textureDestroy, "Mesh Destroy", true);
         TracyGpuNamedZone(textureDestroyGpu, "Mesh Destroy", true);
 #endif
-        glDeleteVertexArrays(1, &vao_);
+        StateCache::DeleteVertexArrays(1, &vao_);
         vao_ = 0;
         glCheckError();
         if (vbo_ != 0)
         {
-            glDeleteBuffers(1, &vbo_);
+            StateCache::DeleteBuffers(1, &vbo_);
             vbo_ = 0;
             glCheckError();
         }
         if (ebo_ != 0)
         {
-            glDeleteBuffers(1, &ebo_);
+            StateCache::DeleteBuffers(1, &ebo_);
             ebo_ = 0;
             glCheckError();
         }
@@ -173,7 +255,7 @@ void Mesh::Destroy()
 
 std::size_t Mesh::GetIndicesCount() const
 {
-    return indices_.size();
+    return lods_.empty() ? 0 : lods_.front().indexCount;
 }
 
 void Mesh::BindTextures(ShaderProgram& shader) const
@@ -194,9 +276,6 @@ void Mesh::BindTextures(ShaderProgram& shader) const
             core::LogWarning("Invalid Texture in Mesh");
             continue;
         }
-        glActiveTexture(
-                GL_TEXTURE0 + i); // activate proper texture unit before binding
-        glCheckError();
         // retrieve texture number (the N in diffuse_textureN)
         std::string number;
         std::string name = textures_[i].type;
@@ -217,13 +296,25 @@ void Mesh::BindTextures(ShaderProgram& shader) const
         }
         const auto uniformName = fmt::format("{}{}", name, number);
         shader.SetInt(uniformName.c_str(), i);
-        glBindTexture(GL_TEXTURE_2D, textures_[i].textureName);
+        StateCache::BindTexture(i, GL_TEXTURE_2D, textures_[i].textureName);
         glCheckError();
     }
-    glActiveTexture(GL_TEXTURE0);
-    glCheckError();
 }
 
+std::uint64_t Mesh::GetMaterialId() const
+{
+    return GetMaterialId(textures_);
+}
 
-
-}
\ No newline at end of file
+std::uint64_t Mesh::GetMaterialId(std::span<const Texture> textures)
+{
+    std::uint64_t hash = core::FNV_OFFSET_BASIS;
+    for (const auto& texture : textures)
+    {
+        hash = core::HashFnv1a(std::string_view(reinterpret_cast<const char*>(&texture.textureName),
+                                                sizeof(texture.textureName)), hash);
+        hash = core::HashFnv1a(texture.type, hash);
+    }
+    return hash;
+}
+}
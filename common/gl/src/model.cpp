@@ -1,13 +1,18 @@
 #include "gl/model.h"
 
 #include <algorithm>
+#include <numeric>
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include "fmt/core.h"
 
+#include "gl/asset_registry.h"
 #include "gl/texture.h"
+#include "filesystem.h"
 #include "log.h"
+#include "mesh_file.h"
+#include "mesh_optimizer.h"
 
 #ifdef TRACY_ENABLE
 
@@ -18,11 +23,19 @@
 namespace gl
 {
 
-void Model::LoadModel(std::string_view path)
+void Model::LoadModel(std::string_view path, Mesh::VertexFormat format, std::size_t lodCount)
 {
 #ifdef TRACY_ENABLE
     ZoneNamedN(cubeInit, "Load Model", true);
 #endif
+    directory_ = path.substr(0, path.find_last_of('/'));
+    //The mesh cooker writes the cooked file next to the source one, it is read in place without Assimp
+    const auto cookedPath = fmt::format("{}{}", path, core::MESH_FILE_EXTENSION);
+    if (core::FilesystemLocator::get().FileExists(cookedPath) && LoadCookedModel(cookedPath))
+    {
+        SetupMeshes(format, lodCount);
+        return;
+    }
     Assimp::Importer import;
     const aiScene* scene = nullptr;
     {
@@ -44,11 +57,62 @@ void Model::LoadModel(std::string_view path)
 #ifdef TRACY_ENABLE
     ZoneNamedN(ProcessNodes, "Process Nodes", true);
 #endif
-    directory_ = path.substr(0, path.find_last_of('/'));
-
     ProcessNode(scene->mRootNode, scene);
-    std::for_each(meshes_.begin(), meshes_.end(),
-                  [](auto& mesh) { mesh.SetupMesh(); });
+    SetupMeshes(format, lodCount);
+}
+
+void Model::SetupMeshes(Mesh::VertexFormat format, std::size_t lodCount)
+{
+    for (auto& mesh : meshes_)
+    {
+        if (lodCount > 1)
+        {
+            mesh.GenerateLods(lodCount);
+        }
+        mesh.SetupMesh(format);
+    }
+}
+
+bool Model::LoadCookedModel(std::string_view cookedPath)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    core::MappedFile file;
+    if (!file.Open(cookedPath))
+    {
+        return false;
+    }
+    const auto view = core::ReadMeshFile(file.GetData());
+    if (!view)
+    {
+        core::LogError(fmt::format("[Error] Invalid cooked model: {}, loading the source model", cookedPath));
+        return false;
+    }
+    meshes_.reserve(view->meshes.size());
+    for (const auto& cookedMesh : view->meshes)
+    {
+        const auto* vertexBegin = view->vertices.data() + cookedMesh.firstVertex;
+        const auto* indexBegin = view->indices.data() + cookedMesh.firstIndex;
+        std::vector<Mesh::Texture> textures;
+        if (!view->materials.empty())
+        {
+            const auto& material = view->materials[cookedMesh.materialIndex];
+            for (const auto& cookedTexture : view->textures.subspan(material.firstTexture, material.textureCount))
+            {
+                Mesh::Texture texture;
+                texture.textureName = LoadTexture(fmt::format("{}/{}", directory_,
+                                                              view->GetTexturePath(cookedTexture)));
+                texture.type = view->GetTextureType(cookedTexture);
+                textures.push_back(std::move(texture));
+            }
+        }
+        //The blobs are copied as a whole from the mapping, there is no per vertex conversion
+        meshes_.emplace_back(std::vector<Mesh::Vertex>(vertexBegin, vertexBegin + cookedMesh.vertexCount),
+                             std::vector<unsigned int>(indexBegin, indexBegin + cookedMesh.indexCount),
+                             std::move(textures));
+    }
+    return true;
 }
 
 void Model::Draw(ShaderProgram& shader)
@@ -63,6 +127,77 @@ void Model::Draw(ShaderProgram& shader)
     }
 }
 
+void Model::AddToPool(GeometryPool& pool, MaterialSystem* materials)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    poolRanges_.clear();
+    poolRanges_.reserve(meshes_.size());
+    for (const auto& mesh : meshes_)
+    {
+        const auto range = pool.Allocate(mesh.GetVertices(), mesh.GetIndices());
+        if (!range)
+        {
+            poolRanges_.clear();
+            return;
+        }
+        poolRanges_.push_back(*range);
+    }
+
+    //Meshes sharing a material follow each other and go in the same multi draw,
+    //with a material system the shader fetches the textures itself and all of them go in the same one
+    materialIndices_.clear();
+    usingMaterialSystem_ = materials != nullptr;
+    std::vector<std::uint64_t> materialIds;
+    for (const auto& mesh : meshes_)
+    {
+        if (usingMaterialSystem_)
+        {
+            materialIndices_.push_back(materials->AddMaterial(mesh.GetTextures()));
+            continue;
+        }
+        const auto materialId = mesh.GetMaterialId();
+        auto it = std::ranges::find(materialIds, materialId);
+        if (it == materialIds.end())
+        {
+            it = materialIds.insert(materialIds.end(), materialId);
+        }
+        materialIndices_.push_back(static_cast<std::uint32_t>(std::distance(materialIds.begin(), it)));
+    }
+    poolDrawOrder_.resize(meshes_.size());
+    std::iota(poolDrawOrder_.begin(), poolDrawOrder_.end(), 0);
+    std::ranges::stable_sort(poolDrawOrder_, [this](std::size_t a, std::size_t b)
+    {
+        return materialIndices_[a] < materialIndices_[b];
+    });
+}
+
+void Model::Draw(ShaderProgram& shader, GeometryPool& pool)
+{
+    if (poolRanges_.empty())
+    {
+        Draw(shader);
+        return;
+    }
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Draw Model From Pool");
+#endif
+    for (std::size_t i = 0; i < poolDrawOrder_.size(); i++)
+    {
+        const auto meshIndex = poolDrawOrder_[i];
+        const auto materialIndex = materialIndices_[meshIndex];
+        if (!usingMaterialSystem_ && (i == 0 || materialIndices_[poolDrawOrder_[i - 1]] != materialIndex))
+        {
+            pool.Flush();
+            meshes_[meshIndex].BindTextures(shader);
+        }
+        pool.AddDraw(poolRanges_[meshIndex], materialIndex);
+    }
+    pool.Flush();
+}
+
 void Model::ProcessNode(aiNode* node, const aiScene* scene)
 {
 #ifdef TRACY_ENABLE
@@ -156,6 +291,11 @@ Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene)
                         std::make_move_iterator(normalMaps.end()));
 
     }
+    //The cooked models were optimized by the mesh cooker
+    const auto statistics = core::OptimizeMesh(vertices, indices);
+    core::LogDebug(fmt::format("Optimized mesh of {} triangles, ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f}",
+                               indices.size() / 3, statistics.before.acmr, statistics.after.acmr,
+                               statistics.before.atvr, statistics.after.atvr));
     return Mesh(std::move(vertices), std::move(indices), std::move(textures));
 }
 
@@ -173,29 +313,24 @@ Model::LoadMaterialTextures(aiMaterial* material, aiTextureType type,
         aiString str;
         material->GetTexture(type, i, &str);
         Mesh::Texture texture;
-        const auto texturePath = fmt::format("{}/{}", directory_, str.C_Str());
-        const auto textureHash = std::hash<std::string>{}(texturePath);
-        const auto it = std::ranges::find(textureHashes_, textureHash);
-        if (it == textureHashes_.end())
-        {
-            textures_.emplace_back();
-            auto& newTexture = textures_.back();
-            newTexture.LoadTexture(texturePath, Texture::MIPMAP | Texture::SMOOTH);
-            texture.textureName = newTexture.GetName();
-            textureHashes_.push_back(textureHash);
-        }
-        else
-        {
-            const auto index = std::distance(textureHashes_.begin(), it);
-            texture.textureName = textures_[index].GetName();
-        }
-
+        texture.textureName = LoadTexture(fmt::format("{}/{}", directory_, str.C_Str()));
         texture.type = typeName;
         textures.push_back(std::move(texture));
     }
     return textures;
 }
 
+unsigned int Model::LoadTexture(const std::string& texturePath)
+{
+    auto texture = AssetRegistry::LoadTextureAsync(texturePath,
+                                                   Texture::MIPMAP | Texture::SMOOTH | Texture::STREAMING);
+    if (std::ranges::find(textures_, texture) == textures_.end())
+    {
+        textures_.push_back(texture);
+    }
+    return texture->GetName();
+}
+
 Model::~Model()
 {
 }
@@ -211,10 +346,9 @@ void Model::Destroy()
         mesh.Destroy();
     }
 
-    for (auto& texture : textures_)
-    {
-        texture.Destroy();
-    }
+    //The registry destroys the textures once no model holds them
+    textures_.clear();
+    poolRanges_.clear();
 }
 
 const Mesh& Model::GetMesh(std::size_t i) const
@@ -0,0 +1,211 @@
+#include "gl/program_cache.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+#include "hash.h"
+#include "log.h"
+
+#include <GL/glew.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace gl
+{
+namespace
+{
+constexpr std::uint32_t CACHE_MAGIC = 0x43535047; //GPSC
+constexpr std::uint32_t CACHE_VERSION = 1;
+
+struct ProgramCacheHeader
+{
+    std::uint32_t magic = CACHE_MAGIC;
+    std::uint32_t version = CACHE_VERSION;
+    std::uint32_t binaryFormat = 0;
+    std::uint32_t binaryLength = 0;
+};
+
+std::uint64_t HashString(std::uint64_t hash, std::string_view value)
+{
+    //Separator so that moving characters from one string to the next changes the hash
+    return core::HashFnv1a("\xFF", core::HashFnv1a(value, hash));
+}
+
+std::string_view GetGlString(GLenum name)
+{
+    const auto* value = reinterpret_cast<const char*>(glGetString(name));
+    return value == nullptr ? std::string_view() : std::string_view(value);
+}
+
+/**
+ * \brief Checked before glProgramBinary, which raises GL_INVALID_ENUM on a format the driver dropped
+ */
+bool IsBinaryFormatSupported(GLenum binaryFormat)
+{
+    static const std::vector<GLint> binaryFormats = []()
+    {
+        GLint formatNmb = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatNmb);
+        std::vector<GLint> formats(formatNmb);
+        if (formatNmb > 0)
+        {
+            glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+        }
+        return formats;
+    }();
+    return std::ranges::find(binaryFormats, static_cast<GLint>(binaryFormat)) != binaryFormats.end();
+}
+
+void RemoveCacheFile(const std::string& path)
+{
+    std::error_code error;
+    fs::remove(path, error);
+    if (error)
+    {
+        core::LogWarning(fmt::format("Could not remove program cache file: {}", path));
+    }
+}
+}
+
+ProgramCache::Statistics ProgramCache::statistics_{};
+
+std::uint64_t ProgramCache::ComputeKey(std::initializer_list<std::string_view> sources)
+{
+    std::uint64_t hash = core::FNV_OFFSET_BASIS;
+    hash = HashString(hash, GetGlString(GL_VENDOR));
+    hash = HashString(hash, GetGlString(GL_RENDERER));
+    hash = HashString(hash, GetGlString(GL_VERSION));
+    for (const auto source : sources)
+    {
+        hash = HashString(hash, source);
+    }
+    return hash;
+}
+
+unsigned ProgramCache::LoadProgram(std::uint64_t key)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!enabled_ || !IsSupported())
+        return 0;
+    const auto path = GetCachePath(key);
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file)
+        return 0;
+    ProgramCacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION)
+    {
+        core::LogWarning(fmt::format("Invalid program cache file: {}", path));
+        return 0;
+    }
+    std::vector<char> binary(header.binaryLength);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file)
+    {
+        core::LogWarning(fmt::format("Truncated program cache file: {}", path));
+        return 0;
+    }
+
+    file.close();
+    if (!IsBinaryFormatSupported(header.binaryFormat))
+    {
+        core::LogWarning(fmt::format("Program cache file with a binary format the driver does not support: {}",
+                                     path));
+        RemoveCacheFile(path);
+        return 0;
+    }
+
+    const GLuint program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        core::LogWarning(fmt::format("Program cache file refused by the driver: {}, compiling from source\n{}",
+                                     path, infoLog));
+        StateCache::DeleteProgram(program);
+        RemoveCacheFile(path);
+        return 0;
+    }
+    return program;
+}
+
+void ProgramCache::SaveProgram(unsigned program, std::uint64_t key)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!enabled_ || program == 0 || !IsSupported())
+        return;
+    GLint binaryLength = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+        return;
+    std::vector<char> binary(binaryLength);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, binaryLength, nullptr, &binaryFormat, binary.data());
+    glCheckError();
+
+    std::error_code error;
+    fs::create_directories(CACHE_FOLDER, error);
+    const auto path = GetCachePath(key);
+    std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+    if (!file)
+    {
+        core::LogWarning(fmt::format("Could not write program cache file: {}", path));
+        return;
+    }
+    const ProgramCacheHeader header{CACHE_MAGIC, CACHE_VERSION, binaryFormat,
+                                    static_cast<std::uint32_t>(binaryLength)};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), binaryLength);
+}
+
+void ProgramCache::SetRetrievableHint(unsigned program)
+{
+    if (enabled_ && IsSupported())
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void ProgramCache::AddCompileTime(double milliseconds)
+{
+    statistics_.compiledNmb++;
+    statistics_.compileTime += milliseconds;
+}
+
+void ProgramCache::AddCacheTime(double milliseconds)
+{
+    statistics_.cachedNmb++;
+    statistics_.cacheTime += milliseconds;
+}
+
+std::string ProgramCache::GetCachePath(std::uint64_t key)
+{
+    return fmt::format("{}/{:016x}.bin", CACHE_FOLDER, key);
+}
+
+bool ProgramCache::IsSupported()
+{
+    static const bool isSupported = []()
+    {
+        GLint formatNmb = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatNmb);
+        return formatNmb > 0;
+    }();
+    return isSupported;
+}
+}
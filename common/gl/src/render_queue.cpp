@@ -0,0 +1,131 @@
+#include "gl/render_queue.h"
+#include "gl/error.h"
+#include "gl/model.h"
+#include "gl/state_cache.h"
+
+#include <GL/glew.h>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+using namespace literals;
+
+namespace
+{
+constexpr std::uint64_t PASS_BITS = 4;
+constexpr std::uint64_t PROGRAM_BITS = 12;
+constexpr std::uint64_t MATERIAL_BITS = 16;
+constexpr std::uint64_t VAO_BITS = 16;
+constexpr std::uint64_t DEPTH_BITS = 16;
+static_assert(PASS_BITS + PROGRAM_BITS + MATERIAL_BITS + VAO_BITS + DEPTH_BITS == 64);
+
+constexpr std::uint64_t Mask(std::uint64_t bits)
+{
+    return (1ull << bits) - 1;
+}
+}
+
+std::uint64_t RenderQueue::MakeKey(std::uint8_t pass, unsigned program, std::uint64_t materialId,
+                                   unsigned vao, float depth)
+{
+    //Only the order depends on the key, names wider than their field just share a slot with others
+    const auto quantizedDepth = static_cast<std::uint64_t>(std::clamp(depth, 0.0f, 1.0f) *
+                                                           static_cast<float>(Mask(DEPTH_BITS)));
+    std::uint64_t key = pass & Mask(PASS_BITS);
+    key = key << PROGRAM_BITS | (program & Mask(PROGRAM_BITS));
+    key = key << MATERIAL_BITS | (materialId & Mask(MATERIAL_BITS));
+    key = key << VAO_BITS | (vao & Mask(VAO_BITS));
+    key = key << DEPTH_BITS | quantizedDepth;
+    return key;
+}
+
+void RenderQueue::SetViewPosition(glm::vec3 position, float farPlane)
+{
+    viewPosition_ = position;
+    farPlane_ = farPlane;
+}
+
+void RenderQueue::Submit(ShaderProgram& program, const Mesh& mesh, const glm::mat4& model, std::uint8_t pass)
+{
+    const auto materialId = mesh.GetMaterialId();
+    const float depth = glm::length(glm::vec3(model[3]) - viewPosition_) / farPlane_;
+    items_.push_back({MakeKey(pass, program.GetName(), materialId, mesh.GetVao(), depth),
+                      static_cast<std::uint32_t>(commands_.size())});
+    commands_.push_back({&program, &mesh, materialId, model});
+}
+
+void RenderQueue::Submit(ShaderProgram& program, const Model& model, const glm::mat4& transform, std::uint8_t pass)
+{
+    for (std::size_t i = 0; i < model.GetMeshCount(); i++)
+    {
+        Submit(program, model.GetMesh(i), transform, pass);
+    }
+}
+
+void RenderQueue::Flush()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Flush Render Queue");
+#endif
+    statistics_ = {};
+    scratch_.resize(items_.size());
+    core::RadixSort(items_, scratch_);
+
+    ShaderProgram* currentProgram = nullptr;
+    const DrawCommand* currentMaterial = nullptr;
+    unsigned currentVao = 0;
+    UniformLocation modelLocation;
+    UniformLocation normalMatrixLocation;
+    for (const auto& item : items_)
+    {
+        const auto& command = commands_[item.index];
+        if (command.program != currentProgram)
+        {
+            currentProgram = command.program;
+            currentProgram->Bind();
+            modelLocation = currentProgram->GetUniformLocation("model"_uniform);
+            //The samples name the normal matrix either way
+            normalMatrixLocation = currentProgram->GetUniformLocation("transposeInverseModel"_uniform);
+            if (normalMatrixLocation.value < 0)
+            {
+                normalMatrixLocation = currentProgram->GetUniformLocation("normalMatrix"_uniform);
+            }
+            //The sampler uniforms belong to the program, the textures are bound again for the new one
+            currentMaterial = nullptr;
+            statistics_.programChangeNmb++;
+        }
+        if (currentMaterial == nullptr || currentMaterial->materialId != command.materialId)
+        {
+            command.mesh->BindTextures(*currentProgram);
+            currentMaterial = &command;
+            statistics_.materialChangeNmb++;
+        }
+        if (command.mesh->GetVao() != currentVao)
+        {
+            currentVao = command.mesh->GetVao();
+            StateCache::BindVertexArray(currentVao);
+            statistics_.vaoChangeNmb++;
+        }
+        currentProgram->SetMat4(modelLocation, command.model);
+        if (normalMatrixLocation.value >= 0)
+        {
+            currentProgram->SetMat4(normalMatrixLocation, glm::transpose(glm::inverse(command.model)));
+        }
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command.mesh->GetIndicesCount()), GL_UNSIGNED_INT,
+                       nullptr);
+        statistics_.drawNmb++;
+    }
+    glCheckError();
+    commands_.clear();
+    items_.clear();
+}
+}
@@ -0,0 +1,236 @@
+#include "gl/render_target_pool.h"
+
+#include <algorithm>
+
+#include <GL/glew.h>
+
+#include "gl/error.h"
+#include "gl/framebuffer.h"
+#include "gl/state_cache.h"
+#include "log.h"
+#include "fmt/core.h"
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+std::vector<RenderTargetPool::Target> RenderTargetPool::targets_;
+std::vector<RenderTargetPool::CachedFramebuffer> RenderTargetPool::framebuffers_;
+RenderTargetPool::Statistics RenderTargetPool::statistics_;
+
+namespace
+{
+bool HasStencil(unsigned int internalFormat)
+{
+    return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+std::size_t GetPixelSize(unsigned int internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_R8:
+            return 1;
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGB8:
+            return 3;
+        case GL_RGBA8:
+        case GL_RG16F:
+        case GL_R32F:
+        case GL_R11F_G11F_B10F:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+            return 4;
+        case GL_RGB16F:
+            return 6;
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGB32F:
+            return 12;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            core::LogWarning(fmt::format("Unknown render target format {:#x}, counted as 4 bytes per pixel",
+                                         internalFormat));
+            return 4;
+    }
+}
+}
+
+unsigned int RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+    frameAcquiredBytes_ += GetByteSize(desc);
+    const auto it = std::ranges::find_if(targets_, [&desc](const Target& target)
+    {
+        return !target.used && target.desc == desc;
+    });
+    if (it != targets_.end())
+    {
+        it->used = true;
+        it->lastUsedFrame = frameIndex_;
+        return it->textureName;
+    }
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Create Render Target");
+#endif
+    auto& target = targets_.emplace_back();
+    target.desc = desc;
+    target.used = true;
+    target.lastUsedFrame = frameIndex_;
+    glGenTextures(1, &target.textureName);
+    StateCache::BindTexture(GL_TEXTURE_2D, target.textureName);
+    glTexStorage2D(GL_TEXTURE_2D, 1, desc.internalFormat, desc.width, desc.height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    //Blur filters would otherwise sample the other side of the screen
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    StateCache::BindTexture(GL_TEXTURE_2D, 0);
+    glCheckError();
+    statistics_.targetNmb = targets_.size();
+    statistics_.allocatedBytes += GetByteSize(desc);
+    return target.textureName;
+}
+
+void RenderTargetPool::Release(unsigned int textureName)
+{
+    const auto it = std::ranges::find(targets_, textureName, &Target::textureName);
+    if (it == targets_.end() || !it->used)
+    {
+        core::LogError(fmt::format("[Error] Render target {} released without being acquired", textureName));
+        return;
+    }
+    it->used = false;
+}
+
+void RenderTargetPool::BindFramebuffer(std::initializer_list<unsigned int> colorTargets, unsigned int depthTarget)
+{
+    BindFramebuffer(std::span(colorTargets.begin(), colorTargets.size()), depthTarget);
+}
+
+void RenderTargetPool::BindFramebuffer(std::span<const unsigned int> colorTargets, unsigned int depthTarget)
+{
+    if (colorTargets.size() > MAX_COLOR_ATTACHMENT)
+    {
+        core::LogError(fmt::format("[Error] Framebuffer with {} color attachments, the pool supports {}",
+                                   colorTargets.size(), MAX_COLOR_ATTACHMENT));
+        return;
+    }
+    CachedFramebuffer key;
+    std::ranges::copy(colorTargets, key.colorTargets.begin());
+    key.depthTarget = depthTarget;
+    const auto it = std::ranges::find_if(framebuffers_, [&key](const CachedFramebuffer& framebuffer)
+    {
+        return framebuffer.colorTargets == key.colorTargets && framebuffer.depthTarget == key.depthTarget;
+    });
+    if (it != framebuffers_.end())
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, it->fbo);
+        return;
+    }
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    TracyGpuZone("Create Render Target Framebuffer");
+#endif
+    glGenFramebuffers(1, &key.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, key.fbo);
+    std::array<GLenum, MAX_COLOR_ATTACHMENT> drawBuffers{};
+    for (std::size_t i = 0; i < colorTargets.size(); i++)
+    {
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, drawBuffers[i], GL_TEXTURE_2D, key.colorTargets[i], 0);
+    }
+    if (depthTarget != 0)
+    {
+        const auto depthIt = std::ranges::find(targets_, depthTarget, &Target::textureName);
+        const auto attachment = depthIt != targets_.end() && HasStencil(depthIt->desc.internalFormat)
+                                    ? GL_DEPTH_STENCIL_ATTACHMENT
+                                    : GL_DEPTH_ATTACHMENT;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depthTarget, 0);
+    }
+    if (colorTargets.size() == 0)
+    {
+        GLenum drawBuffer = GL_NONE;
+        glDrawBuffers(1, &drawBuffer);
+        glReadBuffer(GL_NONE);
+    }
+    else
+    {
+        glDrawBuffers(static_cast<GLsizei>(colorTargets.size()), drawBuffers.data());
+    }
+    Framebuffer::CheckFramebuffer(__FILE__, __LINE__);
+    glCheckError();
+    framebuffers_.push_back(key);
+    statistics_.framebufferNmb = framebuffers_.size();
+}
+
+void RenderTargetPool::Update()
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Render Target Pool Update");
+#endif
+    statistics_.acquiredBytes = frameAcquiredBytes_;
+    frameAcquiredBytes_ = 0;
+    std::erase_if(targets_, [](const Target& target)
+    {
+        if (target.used || frameIndex_ - target.lastUsedFrame < MAX_UNUSED_FRAMES)
+        {
+            return false;
+        }
+        DeleteTarget(target);
+        return true;
+    });
+    statistics_.targetNmb = targets_.size();
+    statistics_.framebufferNmb = framebuffers_.size();
+    frameIndex_++;
+}
+
+void RenderTargetPool::Destroy()
+{
+    for (const auto& target : targets_)
+    {
+        if (target.used)
+        {
+            core::LogWarning(fmt::format("Render target {} is still acquired", target.textureName));
+        }
+        DeleteTarget(target);
+    }
+    targets_.clear();
+    statistics_ = {};
+    frameAcquiredBytes_ = 0;
+    frameIndex_ = 0;
+}
+
+std::size_t RenderTargetPool::GetByteSize(const RenderTargetDesc& desc)
+{
+    return static_cast<std::size_t>(desc.width) * desc.height * GetPixelSize(desc.internalFormat);
+}
+
+void RenderTargetPool::DeleteTarget(const Target& target)
+{
+    //The framebuffers attaching the target are incomplete without it
+    std::erase_if(framebuffers_, [&target](const CachedFramebuffer& framebuffer)
+    {
+        if (framebuffer.depthTarget != target.textureName &&
+            std::ranges::find(framebuffer.colorTargets, target.textureName) == framebuffer.colorTargets.end())
+        {
+            return false;
+        }
+        glDeleteFramebuffers(1, &framebuffer.fbo);
+        return true;
+    });
+    StateCache::DeleteTextures(1, &target.textureName);
+    statistics_.allocatedBytes -= GetByteSize(target.desc);
+    glCheckError();
+}
+}
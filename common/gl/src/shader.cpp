@@ -1,6 +1,10 @@
-#include <iostream>
+#include <array>
+#include <chrono>
 #include <gl/shader.h>
 #include <gl/error.h>
+#include <gl/state_cache.h>
+#include <gl/program_cache.h>
+#include <gl/uniform_buffer.h>
 #include <log.h>
 
 #include <GL/glew.h>
@@ -13,6 +17,21 @@
 #endif
 namespace gl
 {
+namespace
+{
+using ProgramClock = std::chrono::steady_clock;
+
+double ElapsedMilliseconds(ProgramClock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(ProgramClock::now() - start).count();
+}
+
+std::string_view FileContent(const core::BufferFile& file)
+{
+    return {reinterpret_cast<const char*>(file.dataBuffer), file.dataLength};
+}
+}
+
 ShaderProgram::~ShaderProgram()
 {
     if(program_)
@@ -23,142 +42,292 @@ ShaderProgram::~ShaderProgram()
 
 void ShaderProgram::Destroy()
 {
+    for (const auto shader : pendingShaders_)
+    {
+        glDeleteShader(shader);
+    }
+    pendingShaders_.clear();
+    isPending_ = false;
+    uniformLocations_.clear();
     if (program_ != 0)
     {
 #ifdef TRACY_ENABLE
         ZoneNamedN(shaderDestroy, "Shader Destroy", true);
         TracyGpuNamedZone(shaderDestroyGpu, "Shader Destroy", true);
 #endif
-        glDeleteProgram(program_);
+        StateCache::DeleteProgram(program_);
         program_ = 0;
         glCheckError();
     }
 }
 
-unsigned ShaderProgram::LoadShader(core::BufferFile&& bufferFile, int shaderType) const
+unsigned ShaderProgram::SubmitShader(const core::BufferFile& bufferFile, unsigned shaderType)
 {
+#ifdef TRACY_ENABLE
+    ZoneNamedN(shaderSubmit, "Shader Submit", true);
+    TracyGpuNamedZone(shaderSubmitGpu, "Shader Submit", true);
+#endif
     if (bufferFile.dataBuffer == nullptr)
     {
         core::LogError("Shader file is empty...");
         return INVALID_SHADER;
     }
-    return LoadShader(reinterpret_cast<char*>(bufferFile.dataBuffer), shaderType);
-}
-
-unsigned ShaderProgram::LoadShader(char* shaderContent, unsigned shaderType)
-{
-#ifdef TRACY_ENABLE
-    ZoneNamedN(shaderLoad, "Shader Load", true);
-    TracyGpuNamedZone(shaderDLoadGpu, "Shader Load", true);
-#endif
     const GLuint shader = glCreateShader(shaderType);
-
-    glCheckError();
-
-
+    const auto* shaderContent = reinterpret_cast<const char*>(bufferFile.dataBuffer);
     glShaderSource(shader, 1, &shaderContent, nullptr);
+    //The compile status is only queried when the program is first bound
     glCompileShader(shader);
     glCheckError();
-    //Check success status of shader compilation
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        char infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        core::LogError(fmt::format("[Error] Shader compilation failed with this log:\n{}\nShader content:\n{}",
-                                   infoLog,
-                                   shaderContent));
-        return INVALID_SHADER;
-    }
     return shader;
 }
 
+void ShaderProgram::SubmitProgram(std::initializer_list<unsigned> shaders)
+{
+    program_ = glCreateProgram();
+    for (const auto shader : shaders)
+    {
+        glAttachShader(program_, shader);
+        pendingShaders_.push_back(shader);
+    }
+    ProgramCache::SetRetrievableHint(program_);
+    glLinkProgram(program_);
+    isPending_ = true;
+    glCheckError();
+}
+
 void ShaderProgram::CreateDefaultProgram(std::string_view vertexPath, std::string_view fragmentPath)
 {
 #ifdef TRACY_ENABLE
     ZoneNamedN(shaderProgramCreate, "Shader Program Create", true);
     TracyGpuNamedZone(shaderProgramCreateGpu, "Shader Program Create", true);
 #endif
+    const auto start = ProgramClock::now();
     auto& filesystem = core::FilesystemLocator::get();
-    core::BufferFile vertexFile = filesystem.LoadFile(vertexPath);
+    const core::BufferFile vertexFile = filesystem.LoadFile(vertexPath);
+    const core::BufferFile fragmentFile = filesystem.LoadFile(fragmentPath);
+    const auto cacheKey = ProgramCache::ComputeKey({FileContent(vertexFile), FileContent(fragmentFile)});
+    program_ = ProgramCache::LoadProgram(cacheKey);
+    if (program_ != 0)
+    {
+        ResolveUniforms();
+        ProgramCache::AddCacheTime(ElapsedMilliseconds(start));
+        return;
+    }
 
-    const GLuint vertexShader = LoadShader(std::move(vertexFile), GL_VERTEX_SHADER);
+    const GLuint vertexShader = SubmitShader(vertexFile, GL_VERTEX_SHADER);
     if (vertexShader == INVALID_SHADER)
     {
         core::LogError(fmt::format("[Error] Loading vertex shader: {} unsuccessful", vertexPath));
         return;
     }
-    core::BufferFile fragmentFile = filesystem.LoadFile(fragmentPath);
-
-    const GLuint fragmentShader = LoadShader(std::move(fragmentFile), GL_FRAGMENT_SHADER);
+    const GLuint fragmentShader = SubmitShader(fragmentFile, GL_FRAGMENT_SHADER);
     if (fragmentShader == INVALID_SHADER)
     {
         glDeleteShader(vertexShader);
-        std::cerr << fmt::format("[Error] Loading fragment shader: {} unsuccessful", fragmentPath) << '\n';
+        core::LogError(fmt::format("[Error] Loading fragment shader: {} unsuccessful", fragmentPath));
         return;
     }
+    SubmitProgram({vertexShader, fragmentShader});
+    pendingDescription_ = fmt::format("vertex: {} and fragment: {}", vertexPath, fragmentPath);
+    pendingCacheKey_ = cacheKey;
+    pendingSubmitTime_ = ElapsedMilliseconds(start);
+}
 
-    glCheckError();
-    program_ = CreateShaderProgram(vertexShader, fragmentShader);
-    if (program_ == 0)
+void ShaderProgram::CreateComputeProgram(std::string_view computePath)
+{
+#ifdef TRACY_ENABLE
+    ZoneNamedN(computeProgramCreate, "Compute Program Create", true);
+    TracyGpuNamedZone(computeProgramCreateGpu, "Compute Program Create", true);
+#endif
+    const auto start = ProgramClock::now();
+    auto& filesystem = core::FilesystemLocator::get();
+    const core::BufferFile computeFile = filesystem.LoadFile(computePath);
+    const auto cacheKey = ProgramCache::ComputeKey({FileContent(computeFile)});
+    program_ = ProgramCache::LoadProgram(cacheKey);
+    if (program_ != 0)
+    {
+        ResolveUniforms();
+        ProgramCache::AddCacheTime(ElapsedMilliseconds(start));
+        return;
+    }
+
+    const GLuint computeShader = SubmitShader(computeFile, GL_COMPUTE_SHADER);
+    if (computeShader == INVALID_SHADER)
+    {
+        core::LogError(fmt::format("[Error] Loading compute shader: {} unsuccessful", computePath));
+        return;
+    }
+    SubmitProgram({computeShader});
+    pendingDescription_ = fmt::format("compute: {}", computePath);
+    pendingCacheKey_ = cacheKey;
+    pendingSubmitTime_ = ElapsedMilliseconds(start);
+}
+
+void ShaderProgram::FinishCreation()
+{
+    if (!isPending_)
+        return;
+#ifdef TRACY_ENABLE
+    ZoneNamedN(finishCreation, "Shader Program Finish", true);
+    TracyGpuNamedZone(finishCreationGpu, "Shader Program Finish", true);
+#endif
+    const auto start = ProgramClock::now();
+    isPending_ = false;
+    bool success = true;
+    for (const auto shader : pendingShaders_)
+    {
+        //Check success status of shader compilation
+        GLint compileStatus;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+        if (!compileStatus)
+        {
+            char infoLog[512];
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            core::LogError(fmt::format("[Error] Shader compilation failed for {} with this log:\n{}",
+                                       pendingDescription_, infoLog));
+            success = false;
+        }
+    }
+    if (success)
+    {
+        //Check if shader program was linked correctly
+        GLint linkStatus;
+        glGetProgramiv(program_, GL_LINK_STATUS, &linkStatus);
+        if (!linkStatus)
+        {
+            char infoLog[512];
+            glGetProgramInfoLog(program_, 512, nullptr, infoLog);
+            core::LogError(fmt::format("[Error] Shader program with {}: LINK_FAILED with infoLog:\n{}",
+                                       pendingDescription_, infoLog));
+            success = false;
+        }
+    }
+    for (const auto shader : pendingShaders_)
+    {
+        glDetachShader(program_, shader);
+        glDeleteShader(shader);
+    }
+    pendingShaders_.clear();
+    if (success)
+    {
+        ResolveUniforms();
+        ProgramCache::SaveProgram(program_, pendingCacheKey_);
+    }
+    else
     {
-        std::cerr << fmt::format("[Error] Loading shader program with vertex: {} and fragment {}",
-                                 vertexPath, fragmentPath) << '\n';
+        StateCache::DeleteProgram(program_);
+        program_ = 0;
     }
+    ProgramCache::AddCompileTime(pendingSubmitTime_ + ElapsedMilliseconds(start));
     glCheckError();
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+}
+
+bool ShaderProgram::IsCompiling() const
+{
+    if (!isPending_ || !(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile))
+        return false;
+    GLint completionStatus = GL_TRUE;
+    glGetProgramiv(program_, GL_COMPLETION_STATUS_KHR, &completionStatus);
+    return completionStatus == GL_FALSE;
+}
+
+void ShaderProgram::EnableParallelCompilation()
+{
+    //0xFFFFFFFF lets the driver pick the number of compiler threads
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+    }
     glCheckError();
 }
 
 void ShaderProgram::SetFloat(std::string_view uniformName, float f)
 {
-    glUniform1f(GetUniformLocation(uniformName), f);
+    SetFloat(GetUniformLocation(uniformName), f);
+}
+
+void ShaderProgram::SetFloat(UniformLocation location, float f)
+{
+    glUniform1f(location.value, f);
     glCheckError();
 }
 
 void ShaderProgram::SetInt(std::string_view uniformName, int i)
 {
-    glUniform1i(GetUniformLocation(uniformName), i);
+    SetInt(GetUniformLocation(uniformName), i);
+}
+
+void ShaderProgram::SetInt(UniformLocation location, int i)
+{
+    glUniform1i(location.value, i);
     glCheckError();
 }
 
 void ShaderProgram::SetVec2(std::string_view uniformName, glm::vec2 v)
 {
-    glUniform2fv(GetUniformLocation(uniformName), 1, &v[0]);
+    SetVec2(GetUniformLocation(uniformName), v);
+}
+
+void ShaderProgram::SetVec2(UniformLocation location, glm::vec2 v)
+{
+    glUniform2fv(location.value, 1, &v[0]);
     glCheckError();
 }
 
 void ShaderProgram::SetVec3(std::string_view uniformName, glm::vec3 v)
 {
-    glUniform3fv(GetUniformLocation(uniformName), 1, &v[0]);
+    SetVec3(GetUniformLocation(uniformName), v);
+}
+
+void ShaderProgram::SetVec3(UniformLocation location, glm::vec3 v)
+{
+    glUniform3fv(location.value, 1, &v[0]);
+    glCheckError();
+}
+
+void ShaderProgram::SetVec3Array(UniformLocation location, std::span<const glm::vec3> values)
+{
+    glUniform3fv(location.value, static_cast<GLsizei>(values.size()), &values.data()->x);
     glCheckError();
 }
 
 void ShaderProgram::SetVec4(std::string_view uniformName, glm::vec4 v)
 {
-    glUniform4fv(GetUniformLocation(uniformName), 1, &v[0]);
+    SetVec4(GetUniformLocation(uniformName), v);
+}
+
+void ShaderProgram::SetVec4(UniformLocation location, glm::vec4 v)
+{
+    glUniform4fv(location.value, 1, &v[0]);
     glCheckError();
 }
 
 void ShaderProgram::SetMat4(std::string_view uniformName, const glm::mat4& mat)
 {
-    glUniformMatrix4fv(GetUniformLocation(uniformName), 1, 0, &mat[0][0]);
+    SetMat4(GetUniformLocation(uniformName), mat);
+}
+
+void ShaderProgram::SetMat4(UniformLocation location, const glm::mat4& mat)
+{
+    glUniformMatrix4fv(location.value, 1, 0, &mat[0][0]);
     glCheckError();
 }
 
-void ShaderProgram::Bind() const
+void ShaderProgram::Bind()
 {
-    glUseProgram(program_);
+    FinishCreation();
+    StateCache::UseProgram(program_);
     glCheckError();
 }
 
 void ShaderProgram::SetTexture(std::string_view uniformName, const Texture& texture, int textureUnit)
 {
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(texture.GetType(), texture.GetName());
-    glUniform1i(GetUniformLocation(uniformName), textureUnit);
+    StateCache::BindTexture(textureUnit, texture.GetType(), texture.GetName());
+    glUniform1i(GetUniformLocation(uniformName).value, textureUnit);
     glCheckError();
 
 }
@@ -166,60 +335,86 @@ void ShaderProgram::SetTexture(std::string_view uniformName, const Texture& text
 void ShaderProgram::SetTexture(std::string_view uniformName,
                                unsigned int textureName, int textureUnit)
 {
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, textureName);
-    glUniform1i(GetUniformLocation(uniformName), textureUnit);
-    glCheckError();
+    SetTexture(GetUniformLocation(uniformName), textureName, textureUnit);
 }
 
+void ShaderProgram::SetTexture(UniformLocation location, unsigned int textureName, int textureUnit)
+{
+    StateCache::BindTexture(textureUnit, GL_TEXTURE_2D, textureName);
+    glUniform1i(location.value, textureUnit);
+    glCheckError();
+}
 
-int ShaderProgram::GetUniformLocation(std::string_view uniformName)
+UniformLocation ShaderProgram::GetUniformLocation(UniformId uniformId)
 {
-#ifdef TRACY_ENABLE
-    ZoneNamedN(uniformLocationTrace, "Get Uniform Location", true);
-    TracyGpuNamedZone(uniformLocationGpuTrace, "Get Uniform Location", true);
-#endif
-    const auto uniformIt = uniformMap_.find(uniformName.data());
-    GLint uniformLocation;
-    if (uniformIt == uniformMap_.end())
-    {
-        uniformLocation = glGetUniformLocation(program_, uniformName.data());
-        uniformMap_[uniformName.data()] = uniformLocation;
-    } else
+    FinishCreation();
+    const auto uniformIt = uniformLocations_.find(uniformId.hash);
+    if (uniformIt == uniformLocations_.end())
     {
-        uniformLocation = uniformIt->second;
+        return {};
     }
-    glCheckError();
-    return uniformLocation;
+    return {uniformIt->second};
 }
 
-unsigned ShaderProgram::CreateShaderProgram(unsigned vertexShader, unsigned fragmentShader)
+void ShaderProgram::ResolveUniforms()
 {
 #ifdef TRACY_ENABLE
-    ZoneNamedN(createShaderProgram, "Link Shader Program", true);
-    TracyGpuNamedZone(createShaderProgramGpu, "Link Shader Program", true);
+    ZoneNamedN(resolveUniforms, "Resolve Uniforms", true);
 #endif
-    GLuint program = glCreateProgram();
-    glCheckError();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    glCheckError();
-    //Check if shader program was linked correctly
-    GLint success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success)
+    uniformLocations_.clear();
+    if (program_ == 0)
+        return;
+    GLint uniformCount = 0;
+    glGetProgramInterfaceiv(program_, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+    GLint maxNameLength = 0;
+    glGetProgramInterfaceiv(program_, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+    std::string name(static_cast<std::size_t>(maxNameLength), '\0');
+    constexpr std::array<GLenum, 2> properties = {GL_LOCATION, GL_ARRAY_SIZE};
+    for (GLint i = 0; i < uniformCount; i++)
     {
-        char infoLog[512];
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        core::LogError(fmt::format("[Error] Shader program with vertex {} and fragment {}: LINK_FAILED with infoLog:\n{}",
-                                 vertexShader,
-                                 fragmentShader,
-                                 infoLog));
-        return 0;
+        std::array<GLint, 2> values{};
+        glGetProgramResourceiv(program_, GL_UNIFORM, i, properties.size(), properties.data(),
+                               values.size(), nullptr, values.data());
+        //Members of uniform blocks have no location
+        if (values[0] < 0)
+            continue;
+        GLsizei nameLength = 0;
+        glGetProgramResourceName(program_, GL_UNIFORM, i, maxNameLength, &nameLength, name.data());
+        const std::string_view resourceName(name.data(), nameLength);
+        uniformLocations_[core::HashFnv1a(resourceName)] = values[0];
+        //Arrays are reported as name[0], the other elements are resolved here once
+        if (resourceName.ends_with("[0]"))
+        {
+            const auto baseName = resourceName.substr(0, resourceName.size() - 3);
+            uniformLocations_[core::HashFnv1a(baseName)] = values[0];
+            for (GLint element = 1; element < values[1]; element++)
+            {
+                const auto elementName = fmt::format("{}[{}]", baseName, element);
+                uniformLocations_[core::HashFnv1a(elementName)] = glGetUniformLocation(program_, elementName.c_str());
+            }
+        }
     }
-    return program;
-}
 
+    //Shared blocks go to their fixed binding point, GLSL 300 es has no layout(binding) on blocks
+    GLint blockCount = 0;
+    glGetProgramInterfaceiv(program_, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+    GLint maxBlockNameLength = 0;
+    glGetProgramInterfaceiv(program_, GL_UNIFORM_BLOCK, GL_MAX_NAME_LENGTH, &maxBlockNameLength);
+    std::string blockName(static_cast<std::size_t>(maxBlockNameLength), '\0');
+    for (GLint i = 0; i < blockCount; i++)
+    {
+        GLsizei nameLength = 0;
+        glGetProgramResourceName(program_, GL_UNIFORM_BLOCK, i, maxBlockNameLength, &nameLength, blockName.data());
+        const auto binding = GetUniformBlockBinding(std::string_view(blockName.data(), nameLength));
+        if (!binding)
+        {
+            core::LogWarning(fmt::format("Uniform block {} has no shared binding point",
+                                         std::string_view(blockName.data(), nameLength)));
+            continue;
+        }
+        glUniformBlockBinding(program_, i, static_cast<GLuint>(*binding));
+    }
+    glCheckError();
+}
 
 }
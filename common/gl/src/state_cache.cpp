@@ -0,0 +1,302 @@
+#include "gl/state_cache.h"
+
+#include <GL/glew.h>
+
+namespace gl
+{
+namespace
+{
+constexpr std::array<GLenum, StateCache::BUFFER_TARGET_NMB> BUFFER_TARGETS =
+        {
+                GL_ARRAY_BUFFER,
+                GL_UNIFORM_BUFFER,
+                GL_SHADER_STORAGE_BUFFER,
+                GL_DRAW_INDIRECT_BUFFER,
+                GL_COPY_READ_BUFFER,
+                GL_COPY_WRITE_BUFFER
+        };
+
+constexpr std::array<GLenum, StateCache::TEXTURE_TARGET_NMB> TEXTURE_TARGETS =
+        {
+                GL_TEXTURE_2D,
+                GL_TEXTURE_CUBE_MAP,
+                GL_TEXTURE_2D_ARRAY,
+                GL_TEXTURE_3D,
+                GL_TEXTURE_2D_MULTISAMPLE
+        };
+
+constexpr std::array<GLenum, StateCache::CAPABILITY_NMB> CAPABILITIES =
+        {
+                GL_DEPTH_TEST,
+                GL_BLEND,
+                GL_CULL_FACE,
+                GL_STENCIL_TEST
+        };
+
+/**
+ * \brief Index of value in values or values.size() when it is not shadowed
+ */
+template<std::size_t N>
+constexpr std::size_t IndexOf(const std::array<GLenum, N>& values, GLenum value)
+{
+    for (std::size_t i = 0; i < N; i++)
+    {
+        if (values[i] == value)
+            return i;
+    }
+    return N;
+}
+}
+
+StateCache::State StateCache::state_ = StateCache::MakeUnknownState();
+StateCache::Statistics StateCache::statistics_{};
+StateCache::Statistics StateCache::lastFrameStatistics_{};
+
+StateCache::State StateCache::MakeUnknownState()
+{
+    State state;
+    state.buffers.fill(UNKNOWN);
+    for (auto& unit : state.textures)
+    {
+        unit.fill(UNKNOWN);
+    }
+    state.capabilities.fill(UNKNOWN);
+    return state;
+}
+
+bool StateCache::Update(unsigned& shadow, unsigned value)
+{
+    if (shadow == value)
+    {
+        statistics_.elidedNmb++;
+        return false;
+    }
+    shadow = value;
+    statistics_.issuedNmb++;
+    return true;
+}
+
+void StateCache::UseProgram(unsigned program)
+{
+    if (Update(state_.program, program))
+    {
+        glUseProgram(program);
+    }
+}
+
+void StateCache::BindVertexArray(unsigned vao)
+{
+    if (Update(state_.vao, vao))
+    {
+        glBindVertexArray(vao);
+    }
+}
+
+void StateCache::BindBuffer(unsigned target, unsigned buffer)
+{
+    const auto index = IndexOf(BUFFER_TARGETS, target);
+    if (index == BUFFER_TARGETS.size())
+    {
+        statistics_.issuedNmb++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Update(state_.buffers[index], buffer))
+    {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void StateCache::BindBufferBase(unsigned target, unsigned index, unsigned buffer)
+{
+    //Indexed binding points are not shadowed, but they also replace the generic binding
+    statistics_.issuedNmb++;
+    glBindBufferBase(target, index, buffer);
+    if (const auto targetIndex = IndexOf(BUFFER_TARGETS, target); targetIndex != BUFFER_TARGETS.size())
+    {
+        state_.buffers[targetIndex] = buffer;
+    }
+}
+
+void StateCache::BindBufferRange(unsigned target, unsigned index, unsigned buffer, std::ptrdiff_t offset,
+                                 std::ptrdiff_t size)
+{
+    statistics_.issuedNmb++;
+    glBindBufferRange(target, index, buffer, offset, size);
+    if (const auto targetIndex = IndexOf(BUFFER_TARGETS, target); targetIndex != BUFFER_TARGETS.size())
+    {
+        state_.buffers[targetIndex] = buffer;
+    }
+}
+
+void StateCache::ActiveTexture(unsigned textureUnit)
+{
+    if (Update(state_.activeTextureUnit, textureUnit - GL_TEXTURE0))
+    {
+        glActiveTexture(textureUnit);
+    }
+}
+
+void StateCache::BindTexture(unsigned target, unsigned texture)
+{
+    const auto unit = state_.activeTextureUnit;
+    const auto targetIndex = IndexOf(TEXTURE_TARGETS, target);
+    if (unit >= MAX_TEXTURE_UNITS || targetIndex == TEXTURE_TARGETS.size())
+    {
+        statistics_.issuedNmb++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (Update(state_.textures[unit][targetIndex], texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
+
+void StateCache::BindTexture(int unit, unsigned target, unsigned texture)
+{
+    const auto targetIndex = IndexOf(TEXTURE_TARGETS, target);
+    if (static_cast<std::size_t>(unit) < MAX_TEXTURE_UNITS && targetIndex != TEXTURE_TARGETS.size() &&
+        state_.textures[unit][targetIndex] == texture)
+    {
+        statistics_.elidedNmb++;
+        return;
+    }
+    ActiveTexture(GL_TEXTURE0 + unit);
+    BindTexture(target, texture);
+}
+
+void StateCache::SetCapability(unsigned capability, bool enabled)
+{
+    const auto index = IndexOf(CAPABILITIES, capability);
+    if (index == CAPABILITIES.size())
+    {
+        statistics_.issuedNmb++;
+    }
+    else if (!Update(state_.capabilities[index], enabled))
+    {
+        return;
+    }
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+}
+
+void StateCache::Enable(unsigned capability)
+{
+    SetCapability(capability, true);
+}
+
+void StateCache::Disable(unsigned capability)
+{
+    SetCapability(capability, false);
+}
+
+void StateCache::DepthFunc(unsigned func)
+{
+    if (Update(state_.depthFunc, func))
+    {
+        glDepthFunc(func);
+    }
+}
+
+void StateCache::BlendFunc(unsigned sourceFactor, unsigned destinationFactor)
+{
+    //Both factors are counted as one call
+    if (state_.blendFunc[0] == sourceFactor && state_.blendFunc[1] == destinationFactor)
+    {
+        statistics_.elidedNmb++;
+        return;
+    }
+    state_.blendFunc = {sourceFactor, destinationFactor};
+    statistics_.issuedNmb++;
+    glBlendFunc(sourceFactor, destinationFactor);
+}
+
+void StateCache::CullFace(unsigned mode)
+{
+    if (Update(state_.cullFace, mode))
+    {
+        glCullFace(mode);
+    }
+}
+
+void StateCache::FrontFace(unsigned mode)
+{
+    if (Update(state_.frontFace, mode))
+    {
+        glFrontFace(mode);
+    }
+}
+
+void StateCache::DeleteProgram(unsigned program)
+{
+    glDeleteProgram(program);
+    //A program in use is only flagged for deletion, but its name can be returned again once it is unused
+    if (state_.program == program)
+    {
+        state_.program = UNKNOWN;
+    }
+}
+
+void StateCache::DeleteVertexArrays(int count, const unsigned* vaos)
+{
+    glDeleteVertexArrays(count, vaos);
+    for (int i = 0; i < count; i++)
+    {
+        if (state_.vao == vaos[i])
+        {
+            state_.vao = 0;
+        }
+    }
+}
+
+void StateCache::DeleteBuffers(int count, const unsigned* buffers)
+{
+    glDeleteBuffers(count, buffers);
+    for (int i = 0; i < count; i++)
+    {
+        for (auto& binding : state_.buffers)
+        {
+            if (binding == buffers[i])
+            {
+                binding = 0;
+            }
+        }
+    }
+}
+
+void StateCache::DeleteTextures(int count, const unsigned* textures)
+{
+    glDeleteTextures(count, textures);
+    for (int i = 0; i < count; i++)
+    {
+        for (auto& unit : state_.textures)
+        {
+            for (auto& binding : unit)
+            {
+                if (binding == textures[i])
+                {
+                    binding = 0;
+                }
+            }
+        }
+    }
+}
+
+void StateCache::Invalidate()
+{
+    state_ = MakeUnknownState();
+}
+
+void StateCache::EndFrame()
+{
+    lastFrameStatistics_ = statistics_;
+    statistics_ = {};
+}
+}
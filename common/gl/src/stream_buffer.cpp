@@ -0,0 +1,95 @@
+#include "gl/stream_buffer.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+#include "log.h"
+
+#include <GL/glew.h>
+#include <fmt/core.h>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace gl
+{
+
+StreamBuffer::~StreamBuffer()
+{
+    if (buffer_ != 0)
+    {
+        core::LogWarning("Stream buffer is not free");
+    }
+}
+
+void StreamBuffer::Create(std::size_t regionSize, std::size_t alignment)
+{
+    regionSize_ = (regionSize + alignment - 1) / alignment * alignment;
+    regionIndex_ = 0;
+    const auto bufferSize = static_cast<GLsizeiptr>(regionSize_ * REGION_COUNT);
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer_);
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, flags);
+    mappedData_ = static_cast<std::byte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bufferSize, flags));
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (mappedData_ == nullptr)
+    {
+        core::LogError(fmt::format("[Error] Could not map stream buffer of size {}", bufferSize));
+    }
+    glCheckError();
+}
+
+void StreamBuffer::Destroy()
+{
+    for (auto& fence : fences_)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    if (buffer_ != 0)
+    {
+        StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        StateCache::DeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+    }
+    mappedData_ = nullptr;
+    glCheckError();
+}
+
+void* StreamBuffer::BeginRegion()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    auto& fence = fences_[regionIndex_];
+    if (fence != nullptr)
+    {
+        const auto sync = static_cast<GLsync>(fence);
+        //The first wait flushes so the fence reaches the GPU, the next ones only need to wait
+        GLenum waitResult = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            waitResult = glClientWaitSync(sync, 0, 1'000'000);
+        }
+        if (waitResult == GL_WAIT_FAILED)
+        {
+            core::LogError("[Error] Stream buffer fence wait failed");
+        }
+        glDeleteSync(sync);
+        fence = nullptr;
+    }
+    return mappedData_ + GetRegionOffset();
+}
+
+void StreamBuffer::EndRegion()
+{
+    fences_[regionIndex_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    regionIndex_ = (regionIndex_ + 1) % REGION_COUNT;
+    glCheckError();
+}
+}
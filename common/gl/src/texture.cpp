@@ -5,6 +5,9 @@
 #include <GL/glew.h>
 #include "fmt/core.h"
 #include "gl/error.h"
+#include "gl/state_cache.h"
+#include "gl/texture_loader.h"
+#include "texture_compression.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -18,6 +21,22 @@
 
 namespace gl
 {
+namespace
+{
+gli::format ToSrgbFormat(gli::format format)
+{
+    switch (format)
+    {
+    case gli::FORMAT_RGB_DXT1_UNORM_BLOCK8:
+        return gli::FORMAT_RGB_DXT1_SRGB_BLOCK8;
+    case gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16:
+        return gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16;
+    default:
+        return format;
+    }
+}
+}
+
 Texture::~Texture()
 {
     if (textureName_)
@@ -33,8 +52,14 @@ Texture::LoadTexture(std::string_view path, std::uint8_t textureFlags, int chann
     ZoneNamedN(loadTexture, "Texture Loading", true);
     TracyGpuNamedZone(loadTextureGpu, "Texture Loading", true);
 #endif
-    stbi_set_flip_vertically_on_load(textureFlags & FLIP_Y);
     auto& filesystem = core::FilesystemLocator::get();
+    //The cooked file stores the channels of the source, forcing another number needs the source
+    const auto cookedPath = GetCookedPath(path, textureFlags);
+    if (channelsDesired == 0 && filesystem.FileExists(cookedPath))
+    {
+        LoadCookedTexture(cookedPath, textureFlags);
+        return;
+    }
     if (!filesystem.FileExists(path))
     {
         core::LogError(fmt::format("[Error] Texture: {} does not exist", path));
@@ -48,55 +73,107 @@ Texture::LoadTexture(std::string_view path, std::uint8_t textureFlags, int chann
         textureFile = filesystem.LoadFile(path);
     }
     const auto extension = core::FilesystemInterface::GetExtension(path);
-    bool hdr = false;
-    if (extension == ".hdr")
+    if (extension == ".ktx" || extension == ".dds")
     {
-        hdr = true;
+        LoadCompressedTexture(std::move(textureFile));
+        return;
     }
-    else if (extension == ".ktx" || extension == ".dds")
+    //The mips are generated from RGBA8 pixels
+    const auto isStreaming = textureFlags & STREAMING && extension != ".hdr" &&
+                             (channelsDesired == 0 || channelsDesired == 4);
+    auto image = DecodeImage(textureFile, extension == ".hdr", textureFlags & FLIP_Y,
+                             isStreaming ? 4 : channelsDesired);
+    textureFile.Destroy();
+    if (image.pixels == nullptr)
     {
-        LoadCompressedTexture(std::move(textureFile));
+        core::LogError(fmt::format("[Error] Texture: cannot load {}", path));
         return;
     }
-    int imageWidth, imageHeight;
-    int channelNb;
-    stbi_uc* imageData = nullptr;
-    float* hdrImageData = nullptr;
-    if (hdr)
+    textureSize_ = glm::vec2(image.width, image.height);
+    if (isStreaming)
     {
-        hdrImageData = stbi_loadf_from_memory(
-            static_cast<unsigned char*>(textureFile.dataBuffer),
-            textureFile.dataLength, &imageWidth,
-            &imageHeight, &channelNb, channelsDesired);
+        glGenTextures(1, &textureName_);
+        StreamMipChain(textureName_, BuildMipChain(image, textureFlags), textureFlags);
+        image.Free();
+        return;
     }
-    else
+#ifdef TRACY_ENABLE
+    ZoneNamedN(gpuUpload, "GPU Upload", true);
+    TracyGpuNamedZone(uploadTextureGpu, "GPU Upload", true);
+#endif
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glCheckError();
+
+    StateCache::BindTexture(GL_TEXTURE_2D, texture);
+    SetParameters(textureFlags);
+    UploadImage(image, textureFlags, image.pixels);
+    if (textureFlags & MIPMAP)
     {
 #ifdef TRACY_ENABLE
-        ZoneNamedN(stbLoad, "STB Load", true);
+        ZoneNamedN(mipmapGenerationCpu, "Mipmap Generation", true);
+        TracyGpuNamedZone(mipmapGeneration, "Mipmap Generation", true);
 #endif
-        imageData = stbi_load_from_memory(
-            textureFile.dataBuffer,
-            static_cast<int>(textureFile.dataLength),
-            &imageWidth,
-            &imageHeight,
-            &channelNb, channelsDesired);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glCheckError();
     }
+    image.Free();
+    textureName_ = texture;
+}
 
-    textureFile.Destroy();
-    if (imageData == nullptr && hdrImageData == nullptr)
+void Texture::LoadTextureAsync(std::string_view path, std::uint8_t textureFlags)
+{
+    const auto extension = core::FilesystemInterface::GetExtension(path);
+    if (!TextureLoader::IsEnabled() || extension == ".ktx" || extension == ".dds" ||
+        core::FilesystemLocator::get().FileExists(GetCookedPath(path, textureFlags)))
     {
-        core::LogError(fmt::format("[Error] Texture: cannot load {}", path));
+        LoadTexture(path, textureFlags);
+        return;
+    }
+    if (!core::FilesystemLocator::get().FileExists(path))
+    {
+        core::LogError(fmt::format("[Error] Texture: {} does not exist", path));
         return;
     }
+    CreateWhiteTexture();
+    TextureLoader::LoadTexture(textureName_, path, textureFlags);
+}
+
+Texture::Image Texture::DecodeImage(const core::BufferFile& file, bool hdr, bool flipY, int channelsDesired)
+{
 #ifdef TRACY_ENABLE
-    ZoneNamedN(gpuUpload, "GPU Upload", true);
-    TracyGpuNamedZone(uploadTextureGpu, "GPU Upload", true);
+    ZoneNamedN(stbLoad, "STB Load", true);
 #endif
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glCheckError();
+    //The flag is per thread, textures can be decoded on several workers at once
+    stbi_set_flip_vertically_on_load_thread(flipY);
+    Image image;
+    image.hdr = hdr;
+    if (hdr)
+    {
+        image.pixels = stbi_loadf_from_memory(
+            file.dataBuffer,
+            static_cast<int>(file.dataLength), &image.width,
+            &image.height, &image.channelNb, channelsDesired);
+    }
+    else
+    {
+        image.pixels = stbi_load_from_memory(
+            file.dataBuffer,
+            static_cast<int>(file.dataLength),
+            &image.width,
+            &image.height,
+            &image.channelNb, channelsDesired);
+    }
+    //stb_image gives the channel number of the file, not the one it converted to
+    if (channelsDesired != 0)
+    {
+        image.channelNb = channelsDesired;
+    }
+    return image;
+}
 
-    glBindTexture(GL_TEXTURE_2D, texture);
+void Texture::SetParameters(std::uint8_t textureFlags)
+{
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
                     textureFlags & CLAMP_WRAP
                         ? GL_CLAMP_TO_EDGE
@@ -126,18 +203,22 @@ Texture::LoadTexture(std::string_view path, std::uint8_t textureFlags, int chann
                         textureFlags & SMOOTH ? GL_LINEAR : GL_NEAREST);
         glCheckError();
     }
+}
 
-    switch (channelNb)
+void Texture::UploadImage(const Image& image, std::uint8_t textureFlags, const void* pixels)
+{
+    const auto hdr = image.hdr;
+    switch (image.channelNb)
     {
     case 1:
     {
 #ifdef TRACY_ENABLE
         TracyGpuNamedZone(textureRUpload, "Texture RED Upload", true);
 #endif
-        glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_R16F : GL_R8, imageWidth, imageHeight,
+        glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_R16F : GL_R8, image.width, image.height,
                      0,
                      GL_RED, hdr ? GL_FLOAT : GL_UNSIGNED_BYTE,
-                     hdr ? static_cast<void*>(hdrImageData) : static_cast<void*>(imageData));
+                     pixels);
         break;
     }
     case 2:
@@ -145,10 +226,10 @@ Texture::LoadTexture(std::string_view path, std::uint8_t textureFlags, int chann
 #ifdef TRACY_ENABLE
         TracyGpuNamedZone(textureRGUpload, "Texture RG Upload", true);
 #endif
-        glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_RG16F : GL_RG8, imageWidth, imageHeight,
+        glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_RG16F : GL_RG8, image.width, image.height,
                      0,
                      GL_RG, hdr ? GL_FLOAT : GL_UNSIGNED_BYTE,
-                     hdr ? static_cast<void*>(hdrImageData) : static_cast<void*>(imageData));
+                     pixels);
         break;
     }
     case 3:
@@ -157,11 +238,11 @@ Texture::LoadTexture(std::string_view path, std::uint8_t textureFlags, int chann
         ZoneNamedN(textureRGBUploadCpu, "Texture RGB Upload", true);
         TracyGpuNamedZone(textureRGBUpload, "Texture RGB Upload", true);
 #endif
-        glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_RGB16F : textureFlags & GAMMA_CORRECTION ? GL_SRGB : GL_RGB, imageWidth,
-                     imageHeight,
+        glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_RGB16F : textureFlags & GAMMA_CORRECTION ? GL_SRGB : GL_RGB, image.width,
+                     image.height,
                      0,
                      GL_RGB, hdr ? GL_FLOAT : GL_UNSIGNED_BYTE,
-                     hdr ? static_cast<void*>(hdrImageData) : static_cast<void*>(imageData));
+                     pixels);
         break;
     }
     case 4:
@@ -170,38 +251,65 @@ Texture::LoadTexture(std::string_view path, std::uint8_t textureFlags, int chann
         TracyGpuNamedZone(textureRGBAUpload, "Texture RGBA Upload", true);
 #endif
         glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_RGBA16F : textureFlags & GAMMA_CORRECTION ? GL_SRGB_ALPHA : GL_RGBA,
-                     imageWidth,
-                     imageHeight,
+                     image.width,
+                     image.height,
                      0,
                      GL_RGBA, hdr ? GL_FLOAT : GL_UNSIGNED_BYTE,
-                     hdr ? static_cast<void*>(hdrImageData) : static_cast<void*>(imageData));
+                     pixels);
         break;
     }
     default:
         break;
     }
-
-
     glCheckError();
-    if (textureFlags & MIPMAP)
-    {
+}
+
+TextureResidency::MipChain Texture::BuildMipChain(const Image& image, std::uint8_t textureFlags)
+{
 #ifdef TRACY_ENABLE
-        ZoneNamedN(mipmapGenerationCpu, "Mipmap Generation", true);
-        TracyGpuNamedZone(mipmapGeneration, "Mipmap Generation", true);
+    ZoneNamedN(buildMipChain, "Build Mip Chain", true);
 #endif
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glCheckError();
-    }
-    textureSize_ = glm::vec2(imageWidth, imageHeight);
-    if (imageData)
+    TextureResidency::MipChain mipChain;
+    if (image.pixels == nullptr || image.hdr || image.channelNb != 4)
     {
-        free(imageData);
+        return mipChain;
     }
-    else if (hdrImageData)
+    const auto srgb = static_cast<bool>(textureFlags & GAMMA_CORRECTION);
+    mipChain.width = image.width;
+    mipChain.height = image.height;
+    mipChain.internalFormat = srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+    mipChain.format = GL_RGBA;
+    mipChain.type = GL_UNSIGNED_BYTE;
+    const auto* pixels = static_cast<const std::uint8_t*>(image.pixels);
+    mipChain.levels.emplace_back(pixels, pixels + image.GetSize());
+    int width = image.width;
+    int height = image.height;
+    while (width > 1 || height > 1)
     {
-        free(hdrImageData);
+        mipChain.levels.push_back(core::DownsampleImage(mipChain.levels.back(), width, height, srgb));
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
     }
-    textureName_ = texture;
+    return mipChain;
+}
+
+void Texture::StreamMipChain(unsigned int textureName, TextureResidency::MipChain&& mipChain,
+                             std::uint8_t textureFlags)
+{
+    StateCache::BindTexture(GL_TEXTURE_2D, textureName);
+    SetParameters(textureFlags | MIPMAP);
+    TextureResidency::AddTexture(textureName, std::move(mipChain));
+}
+
+std::size_t Texture::Image::GetSize() const
+{
+    return static_cast<std::size_t>(width) * height * channelNb * (hdr ? sizeof(float) : sizeof(stbi_uc));
+}
+
+void Texture::Image::Free()
+{
+    stbi_image_free(pixels);
+    pixels = nullptr;
 }
 
 void Texture::Destroy()
@@ -212,7 +320,10 @@ void Texture::Destroy()
         ZoneNamedN(textureDestroy, "Texture Destroy", true);
         TracyGpuNamedZone(textureDestroyGpu, "Texture Destroy", true);
 #endif
-        glDeleteTextures(1, &textureName_);
+        //The name could be given to another texture before the pending image is uploaded in it
+        TextureLoader::Cancel(textureName_);
+        TextureResidency::RemoveTexture(textureName_);
+        StateCache::DeleteTextures(1, &textureName_);
         textureName_ = 0;
         glCheckError();
     }
@@ -221,7 +332,7 @@ void Texture::Destroy()
 void Texture::CreateWhiteTexture()
 {
     glGenTextures(1, &textureName_);
-    glBindTexture(GL_TEXTURE_2D, textureName_);
+    StateCache::BindTexture(GL_TEXTURE_2D, textureName_);
     unsigned char white[] = {255, 255, 255};
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE,
                  white);
@@ -260,7 +371,7 @@ void Texture::LoadCubemap(const std::vector<std::string_view>& paths)
     TracyGpuNamedZone(loadTextureGpu, "Cubemap Texture Loading", true);
 #endif
     glGenTextures(1, &textureName_);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureName_);
+    StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, textureName_);
     textureType_ = GL_TEXTURE_CUBE_MAP;
 
 
@@ -341,7 +452,39 @@ void Texture::SetType(unsigned textureType)
     textureType_ = textureType;
 }
 
-void Texture::LoadCompressedTexture(core::BufferFile&& textureFile)
+std::string Texture::GetCookedPath(std::string_view path, std::uint8_t textureFlags)
+{
+    return fmt::format("{}{}", path, textureFlags & FLIP_Y
+                                         ? core::FLIPPED_COOKED_TEXTURE_EXTENSION
+                                         : core::COOKED_TEXTURE_EXTENSION);
+}
+
+void Texture::LoadCookedTexture(std::string_view cookedPath, std::uint8_t textureFlags)
+{
+    auto cookedFile = core::FilesystemLocator::get().LoadFile(cookedPath);
+    if (textureFlags & STREAMING)
+    {
+        auto mipChain = LoadCompressedMipChain(std::move(cookedFile), textureFlags & GAMMA_CORRECTION);
+        if (mipChain.levels.empty())
+        {
+            core::LogError(fmt::format("[Error] Texture: cannot stream {}", cookedPath));
+            return;
+        }
+        textureSize_ = glm::vec2(mipChain.width, mipChain.height);
+        glGenTextures(1, &textureName_);
+        StreamMipChain(textureName_, std::move(mipChain), textureFlags);
+        return;
+    }
+    LoadCompressedTexture(std::move(cookedFile), textureFlags & GAMMA_CORRECTION);
+    if (textureName_ == 0 || textureType_ != GL_TEXTURE_2D)
+    {
+        return;
+    }
+    //The mips are in the file, without MIPMAP only the level 0 is sampled
+    SetParameters(textureFlags);
+}
+
+void Texture::LoadCompressedTexture(core::BufferFile&& textureFile, bool srgb)
 {
 #ifdef TRACY_ENABLE
     ZoneNamedN(loadTexture, "Compress Texture Loading", true);
@@ -363,7 +506,8 @@ void Texture::LoadCompressedTexture(core::BufferFile&& textureFile)
         return;
     }
     textureFile.Destroy();
-    const gli::gl::format format = glProfile.translate(texture.format(),
+    const auto textureFormat = srgb ? ToSrgbFormat(texture.format()) : texture.format();
+    const gli::gl::format format = glProfile.translate(textureFormat,
                                                        texture.swizzles());
 
     GLenum target = glProfile.translate(texture.target());
@@ -383,7 +527,7 @@ void Texture::LoadCompressedTexture(core::BufferFile&& textureFile)
         TracyGpuNamedZone(genTexturesGpu, "glGenTextures", true);
 #endif
         glGenTextures(1, &textureName_);
-        glBindTexture(target, textureName_);
+        StateCache::BindTexture(target, textureName_);
     }
     glCheckError();
     glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
@@ -403,6 +547,7 @@ void Texture::LoadCompressedTexture(core::BufferFile&& textureFile)
                        format.Internal, extent.x, extent.y);
     }
     textureType_ = target;
+    textureSize_ = glm::vec2(extent.x, extent.y);
     glCheckError();
 #ifdef TRACY_ENABLE
     ZoneNamedN(loadingFaces, "Loading Faces", true);
@@ -440,4 +585,35 @@ void Texture::LoadCompressedTexture(core::BufferFile&& textureFile)
     }
     glCheckError();
 }
+
+TextureResidency::MipChain Texture::LoadCompressedMipChain(core::BufferFile&& file, bool srgb)
+{
+#ifdef TRACY_ENABLE
+    ZoneNamedN(loadMipChain, "Compressed Mip Chain Loading", true);
+#endif
+    const gli::texture texture = gli::load(reinterpret_cast<const char*>(file.dataBuffer), file.dataLength);
+    file.Destroy();
+    TextureResidency::MipChain mipChain;
+    if (texture.empty() || texture.target() != gli::TARGET_2D)
+    {
+        return mipChain;
+    }
+    //The cooked formats have the default swizzles, which the streamed textures keep
+    gli::gl glProfile(gli::gl::PROFILE_GL33);
+    const auto textureFormat = srgb ? ToSrgbFormat(texture.format()) : texture.format();
+    const gli::gl::format format = glProfile.translate(textureFormat, texture.swizzles());
+    const glm::tvec3<GLsizei> extent{texture.extent()};
+    mipChain.width = extent.x;
+    mipChain.height = extent.y;
+    mipChain.internalFormat = format.Internal;
+    mipChain.format = format.External;
+    mipChain.type = format.Type;
+    mipChain.compressed = gli::is_compressed(textureFormat);
+    for (std::size_t level = 0; level < texture.levels(); level++)
+    {
+        const auto* data = static_cast<const std::uint8_t*>(texture.data(0, 0, level));
+        mipChain.levels.emplace_back(data, data + texture.size(level));
+    }
+    return mipChain;
+}
 }
@@ -0,0 +1,272 @@
+#include "gl/texture_loader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <GL/glew.h>
+#include "fmt/core.h"
+
+#include "filesystem.h"
+#include "log.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+std::unique_ptr<core::WorkerQueue> TextureLoader::workerQueue_;
+std::vector<std::unique_ptr<core::WorkerThread>> TextureLoader::workerThreads_;
+std::deque<std::shared_ptr<TextureLoader::Request>> TextureLoader::requests_;
+std::vector<std::shared_ptr<TextureLoader::Request>> TextureLoader::cancelledRequests_;
+std::array<TextureLoader::StagingBuffer, TextureLoader::STAGING_BUFFER_COUNT> TextureLoader::stagingBuffers_{};
+TextureLoader::Statistics TextureLoader::statistics_;
+
+void TextureLoader::Init()
+{
+    workerQueue_ = std::make_unique<core::WorkerQueue>();
+    const auto workerNmb = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned i = 0; i < workerNmb; i++)
+    {
+        workerThreads_.push_back(std::make_unique<core::WorkerThread>(*workerQueue_));
+        workerThreads_.back()->Start();
+    }
+    for (auto& stagingBuffer : stagingBuffers_)
+    {
+        glGenBuffers(1, &stagingBuffer.buffer);
+    }
+    glCheckError();
+}
+
+void TextureLoader::Destroy()
+{
+    for (auto& request : requests_)
+    {
+        request->task->Join();
+        request->image.Free();
+    }
+    requests_.clear();
+    for (auto& request : cancelledRequests_)
+    {
+        request->task->Join();
+        request->image.Free();
+    }
+    cancelledRequests_.clear();
+    statistics_.pendingNmb = 0;
+
+    if (workerQueue_ != nullptr)
+    {
+        workerQueue_->Destroy();
+        for (auto& workerThread : workerThreads_)
+        {
+            workerThread->Destroy();
+        }
+        workerThreads_.clear();
+        workerQueue_.reset();
+    }
+    for (auto& stagingBuffer : stagingBuffers_)
+    {
+        if (stagingBuffer.fence != nullptr)
+        {
+            glDeleteSync(static_cast<GLsync>(stagingBuffer.fence));
+            stagingBuffer.fence = nullptr;
+        }
+        if (stagingBuffer.buffer != 0)
+        {
+            StateCache::DeleteBuffers(1, &stagingBuffer.buffer);
+            stagingBuffer.buffer = 0;
+        }
+        stagingBuffer.size = 0;
+    }
+    glCheckError();
+}
+
+void TextureLoader::LoadTexture(unsigned int textureName, std::string_view path, std::uint8_t textureFlags)
+{
+    auto request = std::make_shared<Request>();
+    request->textureName = textureName;
+    request->path = path;
+    request->textureFlags = textureFlags;
+    request->task = std::make_shared<core::Task>([request = request.get()]()
+    {
+#ifdef TRACY_ENABLE
+        ZoneNamedN(decodeTexture, "Decode Texture", true);
+#endif
+        auto file = core::FilesystemLocator::get().LoadFile(request->path);
+        const auto hdr = core::FilesystemInterface::GetExtension(request->path) == ".hdr";
+        const auto isStreaming = request->textureFlags & Texture::STREAMING && !hdr;
+        request->image = Texture::DecodeImage(file, hdr, request->textureFlags & Texture::FLIP_Y,
+                                              isStreaming ? 4 : 0);
+        file.Destroy();
+        if (isStreaming && request->image.pixels != nullptr)
+        {
+            //The whole image is given to the TextureResidency, which uploads its levels itself
+            request->mipChain = Texture::BuildMipChain(request->image, request->textureFlags);
+            request->image.Free();
+        }
+    });
+    workerQueue_->AddTask(request->task);
+    requests_.push_back(std::move(request));
+    statistics_.pendingNmb = requests_.size();
+}
+
+void TextureLoader::Cancel(unsigned int textureName)
+{
+    const auto it = std::ranges::find_if(requests_, [textureName](const auto& request)
+    {
+        return request->textureName == textureName;
+    });
+    if (it == requests_.end())
+    {
+        return;
+    }
+    cancelledRequests_.push_back(*it);
+    requests_.erase(it);
+    statistics_.pendingNmb = requests_.size();
+    FreeCancelled();
+}
+
+void TextureLoader::Update()
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Texture Loader Update");
+    TracyGpuZone("Texture Loader Update");
+#endif
+    FreeCancelled();
+    ReleaseStagingBuffers(false);
+    UploadDecoded(UPLOAD_BUDGET, false);
+}
+
+void TextureLoader::Flush()
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Texture Loader Flush");
+#endif
+    for (auto& request : requests_)
+    {
+        request->task->Join();
+    }
+    UploadDecoded(std::numeric_limits<std::size_t>::max(), true);
+}
+
+void TextureLoader::UploadDecoded(std::size_t budget, bool waitForStaging)
+{
+    std::size_t uploadedBytes = 0;
+    auto it = requests_.begin();
+    while (it != requests_.end() && uploadedBytes < budget)
+    {
+        auto& request = **it;
+        if (!request.task->IsDone())
+        {
+            ++it;
+            continue;
+        }
+        if (!request.mipChain.levels.empty())
+        {
+            Texture::StreamMipChain(request.textureName, std::move(request.mipChain), request.textureFlags);
+            it = requests_.erase(it);
+            continue;
+        }
+        if (request.image.pixels == nullptr)
+        {
+            core::LogError(fmt::format("[Error] Texture: cannot load {}", request.path));
+            it = requests_.erase(it);
+            continue;
+        }
+        auto stagingBuffer = std::ranges::find_if(stagingBuffers_, [](const StagingBuffer& buffer)
+        {
+            return buffer.fence == nullptr;
+        });
+        if (stagingBuffer == stagingBuffers_.end())
+        {
+            if (!waitForStaging)
+            {
+                break;
+            }
+            ReleaseStagingBuffers(true);
+            continue;
+        }
+        uploadedBytes += request.image.GetSize();
+        Upload(request, *stagingBuffer);
+        it = requests_.erase(it);
+    }
+    statistics_.pendingNmb = requests_.size();
+}
+
+void TextureLoader::Upload(Request& request, StagingBuffer& stagingBuffer)
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Upload Texture");
+    TracyGpuZone("Upload Texture");
+#endif
+    auto& image = request.image;
+    const auto size = image.GetSize();
+    StateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer.buffer);
+    if (stagingBuffer.size < size)
+    {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+        stagingBuffer.size = size;
+    }
+    //The fence of the buffer was signaled, the GPU is done reading the previous image
+    auto* mappedData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT |
+                                        GL_MAP_UNSYNCHRONIZED_BIT);
+    std::memcpy(mappedData, image.pixels, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    //The copy from the buffer to the texture is done by the driver without blocking the CPU
+    StateCache::BindTexture(GL_TEXTURE_2D, request.textureName);
+    Texture::SetParameters(request.textureFlags);
+    Texture::UploadImage(image, request.textureFlags, nullptr);
+    if (request.textureFlags & Texture::MIPMAP)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    StateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    stagingBuffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glCheckError();
+
+    statistics_.uploadedNmb++;
+    statistics_.uploadedBytes += size;
+    image.Free();
+}
+
+void TextureLoader::ReleaseStagingBuffers(bool wait)
+{
+    for (auto& stagingBuffer : stagingBuffers_)
+    {
+        if (stagingBuffer.fence == nullptr)
+        {
+            continue;
+        }
+        const auto sync = static_cast<GLsync>(stagingBuffer.fence);
+        GLenum waitResult = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (wait && waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            waitResult = glClientWaitSync(sync, 0, 1'000'000);
+        }
+        if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED)
+        {
+            glDeleteSync(sync);
+            stagingBuffer.fence = nullptr;
+        }
+    }
+}
+
+void TextureLoader::FreeCancelled()
+{
+    std::erase_if(cancelledRequests_, [](const auto& request)
+    {
+        if (!request->task->IsDone())
+        {
+            return false;
+        }
+        request->image.Free();
+        return true;
+    });
+}
+}
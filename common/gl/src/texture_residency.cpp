@@ -0,0 +1,274 @@
+#include "gl/texture_residency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <GL/glew.h>
+
+#include "gl/error.h"
+#include "gl/state_cache.h"
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#include "tracy/TracyOpenGL.hpp"
+#endif
+
+namespace gl
+{
+std::vector<TextureResidency::Entry> TextureResidency::entries_;
+TextureResidency::Statistics TextureResidency::statistics_;
+
+void TextureResidency::AddTexture(unsigned int textureName, MipChain&& mipChain)
+{
+    RemoveTexture(textureName);
+    if (mipChain.levels.empty())
+    {
+        return;
+    }
+    auto& entry = entries_.emplace_back();
+    entry.textureName = textureName;
+    entry.mipChain = std::move(mipChain);
+    const auto levelCount = static_cast<int>(entry.mipChain.levels.size());
+    entry.residentLevel = levelCount;
+    entry.reportedLevel = levelCount;
+    entry.lastUsedFrame = frameIndex_;
+    entry.minResidentLevel = levelCount - 1;
+    while (entry.minResidentLevel > 0 &&
+           std::max(entry.mipChain.width, entry.mipChain.height) >> (entry.minResidentLevel - 1) <= MIN_RESIDENT_SIZE)
+    {
+        entry.minResidentLevel--;
+    }
+
+    StateCache::BindTexture(GL_TEXTURE_2D, textureName);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    for (int level = levelCount - 1; level >= entry.minResidentLevel; level--)
+    {
+        UploadLevel(entry, level);
+    }
+    statistics_.textureNmb = entries_.size();
+}
+
+void TextureResidency::RemoveTexture(unsigned int textureName)
+{
+    const auto it = std::ranges::find(entries_, textureName, &Entry::textureName);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    const auto& levels = it->mipChain.levels;
+    for (auto level = static_cast<std::size_t>(it->residentLevel); level < levels.size(); level++)
+    {
+        statistics_.residentBytes -= levels[level].size();
+    }
+    entries_.erase(it);
+    statistics_.textureNmb = entries_.size();
+}
+
+void TextureResidency::Pin(unsigned int textureName)
+{
+    auto* entry = FindEntry(textureName);
+    if (entry == nullptr)
+    {
+        return;
+    }
+    entry->pinned = true;
+    entry->wantedLevel = 0;
+    while (entry->residentLevel > 0)
+    {
+        UploadLevel(*entry, entry->residentLevel - 1);
+    }
+}
+
+void TextureResidency::ReportUsage(unsigned int textureName, float screenSize)
+{
+    auto* entry = FindEntry(textureName);
+    if (entry == nullptr)
+    {
+        return;
+    }
+    const auto textureSize = static_cast<float>(std::max(entry->mipChain.width, entry->mipChain.height));
+    //One texel per pixel, the finer levels would be minified
+    const auto level = static_cast<int>(std::floor(std::log2(textureSize / std::max(screenSize, 1.0f))));
+    const auto levelCount = static_cast<int>(entry->mipChain.levels.size());
+    entry->reportedLevel = std::min(entry->reportedLevel, std::clamp(level, 0, levelCount - 1));
+    entry->hasFeedback = true;
+    entry->lastUsedFrame = frameIndex_;
+}
+
+float TextureResidency::GetScreenSize(float worldSize, float distance, float fovY, int screenHeight)
+{
+    if (distance <= 0.0f)
+    {
+        return static_cast<float>(screenHeight);
+    }
+    return worldSize / (2.0f * distance * std::tan(fovY / 2.0f)) * static_cast<float>(screenHeight);
+}
+
+void TextureResidency::Update()
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Texture Residency Update");
+    TracyGpuZone("Texture Residency Update");
+#endif
+    for (auto& entry : entries_)
+    {
+        const auto levelCount = static_cast<int>(entry.mipChain.levels.size());
+        if (entry.pinned || !entry.hasFeedback)
+        {
+            entry.wantedLevel = 0;
+        }
+        //A texture not drawn last frame keeps its wanted level, it is the first evicted instead
+        else if (entry.reportedLevel < levelCount)
+        {
+            entry.wantedLevel = entry.reportedLevel;
+        }
+        entry.reportedLevel = levelCount;
+    }
+    frameIndex_++;
+
+    while (statistics_.residentBytes > memoryBudget_)
+    {
+        auto* candidate = FindEvictionCandidate(nullptr);
+        if (candidate == nullptr)
+        {
+            break;
+        }
+        EvictLevel(*candidate);
+    }
+
+    //The most recently used textures get their levels first, coarse to fine one level at a time
+    std::vector<std::size_t> uploadOrder(entries_.size());
+    std::iota(uploadOrder.begin(), uploadOrder.end(), 0);
+    std::ranges::stable_sort(uploadOrder, [](std::size_t a, std::size_t b)
+    {
+        return entries_[a].lastUsedFrame > entries_[b].lastUsedFrame;
+    });
+    std::size_t uploadedBytes = 0;
+    bool hasUploaded = true;
+    while (hasUploaded && uploadedBytes < UPLOAD_BUDGET)
+    {
+        hasUploaded = false;
+        for (const auto index : uploadOrder)
+        {
+            auto& entry = entries_[index];
+            if (entry.residentLevel <= entry.wantedLevel || uploadedBytes >= UPLOAD_BUDGET)
+            {
+                continue;
+            }
+            const auto levelSize = entry.mipChain.levels[entry.residentLevel - 1].size();
+            while (statistics_.residentBytes + levelSize > memoryBudget_)
+            {
+                auto* candidate = FindEvictionCandidate(&entry);
+                if (candidate == nullptr)
+                {
+                    break;
+                }
+                EvictLevel(*candidate);
+            }
+            if (statistics_.residentBytes + levelSize > memoryBudget_)
+            {
+                continue;
+            }
+            UploadLevel(entry, entry.residentLevel - 1);
+            uploadedBytes += levelSize;
+            hasUploaded = true;
+        }
+    }
+
+    statistics_.pendingNmb = 0;
+    for (const auto& entry : entries_)
+    {
+        statistics_.pendingNmb += static_cast<std::size_t>(std::max(entry.residentLevel - entry.wantedLevel, 0));
+    }
+}
+
+void TextureResidency::Destroy()
+{
+    entries_.clear();
+    statistics_ = {};
+    frameIndex_ = 0;
+}
+
+TextureResidency::Entry* TextureResidency::FindEntry(unsigned int textureName)
+{
+    const auto it = std::ranges::find(entries_, textureName, &Entry::textureName);
+    return it == entries_.end() ? nullptr : &*it;
+}
+
+void TextureResidency::UploadLevel(Entry& entry, int level)
+{
+#ifdef TRACY_ENABLE
+    ZoneScopedN("Upload Texture Level");
+    TracyGpuZone("Upload Texture Level");
+#endif
+    const auto& mipChain = entry.mipChain;
+    const auto& data = mipChain.levels[level];
+    const auto width = std::max(mipChain.width >> level, 1);
+    const auto height = std::max(mipChain.height >> level, 1);
+    StateCache::BindTexture(GL_TEXTURE_2D, entry.textureName);
+    if (mipChain.compressed)
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, mipChain.internalFormat, width, height, 0,
+                               static_cast<GLsizei>(data.size()), data.data());
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(mipChain.internalFormat), width, height, 0,
+                     mipChain.format, mipChain.type, data.data());
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    glCheckError();
+    entry.residentLevel = level;
+    statistics_.residentBytes += data.size();
+    statistics_.uploadedNmb++;
+}
+
+void TextureResidency::EvictLevel(Entry& entry)
+{
+    const auto& mipChain = entry.mipChain;
+    const auto level = entry.residentLevel;
+    StateCache::BindTexture(GL_TEXTURE_2D, entry.textureName);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+    //Respecifying the level as empty releases its storage, it is below the base level and not sampled anymore
+    if (mipChain.compressed)
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, mipChain.internalFormat, 0, 0, 0, 0, nullptr);
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(mipChain.internalFormat), 0, 0, 0,
+                     mipChain.format, mipChain.type, nullptr);
+    }
+    glCheckError();
+    entry.residentLevel = level + 1;
+    statistics_.residentBytes -= mipChain.levels[level].size();
+    statistics_.evictionNmb++;
+}
+
+TextureResidency::Entry* TextureResidency::FindEvictionCandidate(const Entry* requester)
+{
+    Entry* candidate = nullptr;
+    bool isCandidateOverResident = false;
+    for (auto& entry : entries_)
+    {
+        if (&entry == requester || entry.pinned || entry.residentLevel >= entry.minResidentLevel)
+        {
+            continue;
+        }
+        const bool isOverResident = entry.residentLevel < entry.wantedLevel;
+        //Textures as recent as the requester would evict each other back and forth
+        if (requester != nullptr && !isOverResident && entry.lastUsedFrame >= requester->lastUsedFrame)
+        {
+            continue;
+        }
+        if (candidate == nullptr || (isOverResident && !isCandidateOverResident) ||
+            (isOverResident == isCandidateOverResident && entry.lastUsedFrame < candidate->lastUsedFrame))
+        {
+            candidate = &entry;
+            isCandidateOverResident = isOverResident;
+        }
+    }
+    return candidate;
+}
+}
@@ -0,0 +1,81 @@
+#include "gl/uniform_buffer.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+#include "log.h"
+
+#include <GL/glew.h>
+#include <fmt/core.h>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace gl
+{
+
+std::optional<UniformBlockBinding> GetUniformBlockBinding(std::string_view blockName)
+{
+    for (std::size_t i = 0; i < UNIFORM_BLOCK_NAMES.size(); i++)
+    {
+        if (UNIFORM_BLOCK_NAMES[i] == blockName)
+        {
+            return static_cast<UniformBlockBinding>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    if (buffer_ != 0)
+    {
+        core::LogWarning("Uniform buffer is not free");
+    }
+}
+
+void UniformBuffer::Create(std::size_t size, UniformBlockBinding binding)
+{
+    size_ = size;
+    binding_ = binding;
+    glGenBuffers(1, &buffer_);
+    StateCache::BindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size_), nullptr, GL_DYNAMIC_DRAW);
+    StateCache::BindBuffer(GL_UNIFORM_BUFFER, 0);
+    Bind();
+    glCheckError();
+}
+
+void UniformBuffer::Destroy()
+{
+    if (buffer_ != 0)
+    {
+        StateCache::DeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+    }
+    size_ = 0;
+    glCheckError();
+}
+
+void UniformBuffer::Update(const void* data, std::size_t size, std::size_t offset)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (offset + size > size_)
+    {
+        core::LogError(fmt::format("[Error] Uniform buffer update of {} bytes at {} overflows its {} bytes",
+                                   size, offset, size_));
+        return;
+    }
+    StateCache::BindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    StateCache::BindBuffer(GL_UNIFORM_BUFFER, 0);
+    glCheckError();
+}
+
+void UniformBuffer::Bind() const
+{
+    StateCache::BindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(binding_), buffer_);
+    glCheckError();
+}
+}
@@ -3,6 +3,7 @@
 #include "log.h"
 #include <gl/vertex_array.h>
 #include "gl/error.h"
+#include "gl/state_cache.h"
 #include "GL/glew.h"
 #include <cmath>
 
@@ -43,7 +44,7 @@ void VertexArray::FreeVao()
         ZoneNamedN(freeVao, "Free VAO", true);
         TracyGpuNamedZone(freeVaoGpu, "Free VAO", true);
 #endif
-        glDeleteVertexArrays(1, &vao_);
+        StateCache::DeleteVertexArrays(1, &vao_);
         vao_ = 0;
         glCheckError();
     }
@@ -116,36 +117,36 @@ void Quad::Init()
     glGenBuffers(1, &ebo_);
     glCheckError();
 
-    glBindVertexArray(vao_);
+    StateCache::BindVertexArray(vao_);
     // 2. copy our vertices array in a buffer for OpenGL to use
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2),
                           (void*) 0);
     glEnableVertexAttribArray(0);
     //bind texture coords data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[1]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[1]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords, GL_STATIC_DRAW);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
                           (void*) 0);
     glEnableVertexAttribArray(1);
     // bind normals data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[2]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[2]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(normals), normals, GL_STATIC_DRAW);
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3),
                           (void*) 0);
     glEnableVertexAttribArray(2);
     // bind tangent data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[3]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[3]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(tangent), &tangent[0], GL_STATIC_DRAW);
     glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3),
                           (void*) 0);
     glEnableVertexAttribArray(3);
     //bind EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices,
                  GL_STATIC_DRAW);
-    glBindVertexArray(0);
+    StateCache::BindVertexArray(0);
     glCheckError();
 }
 
@@ -161,7 +162,7 @@ void Quad::Draw()
     ZoneNamedN(drawQuad, "Draw Quad", true);
     TracyGpuNamedZone(drawQuadGpu, "Draw Quad", true);
 #endif
-    glBindVertexArray(vao_);
+    StateCache::BindVertexArray(vao_);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
     glCheckError();
 }
@@ -174,8 +175,8 @@ void Quad::FreeBuffers()
         ZoneNamedN(freeBuffers, "Free Buffers", true);
         TracyGpuNamedZone(freeBuffersGpu, "Free Buffers", true);
 #endif
-        glDeleteBuffers(4, &vbo_[0]);
-        glDeleteBuffers(1, &ebo_);
+        StateCache::DeleteBuffers(4, &vbo_[0]);
+        StateCache::DeleteBuffers(1, &ebo_);
         ebo_ = 0;
         glCheckError();
     }
@@ -354,29 +355,29 @@ void Cuboid::Init()
     glGenBuffers(4, &vbo_[0]);
     glCheckError();
 
-    glBindVertexArray(vao_);
+    StateCache::BindVertexArray(vao_);
     // position attribute
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(position), position, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
     glEnableVertexAttribArray(0);
     // texture coord attribute
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[1]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[1]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords, GL_STATIC_DRAW);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
     glEnableVertexAttribArray(1);
     // normal attribute
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[2]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[2]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(normals), normals, GL_STATIC_DRAW);
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
     glEnableVertexAttribArray(2);
     //tangent attribute
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[3]);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[3]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(tangent), tangent, GL_STATIC_DRAW);
     glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
     glEnableVertexAttribArray(3);
 
-    glBindVertexArray(0);
+    StateCache::BindVertexArray(0);
     glCheckError();
 }
 
@@ -392,7 +393,7 @@ void Cuboid::Draw()
     ZoneNamedN(drawCube, "Draw Cube", true);
     TracyGpuNamedZone(drawCubeGpu, "Draw Cube", true);
 #endif
-    glBindVertexArray(vao_);
+    StateCache::BindVertexArray(vao_);
     glDrawArrays(GL_TRIANGLES, 0, 36);
     glCheckError();
 }
@@ -405,7 +406,7 @@ void Cuboid::FreeBuffers()
         ZoneNamedN(freeBuffers, "Free Buffers", true);
         TracyGpuNamedZone(freeBuffersGpu, "Free Buffers", true);
 #endif
-        glDeleteBuffers(4, &vbo_[0]);
+        StateCache::DeleteBuffers(4, &vbo_[0]);
         vbo_[0] = 0;
         glCheckError();
     }
@@ -520,11 +521,11 @@ void Sphere::Init()
             data.push_back(tangent[i].z);
         }
     }
-    glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+    StateCache::BindVertexArray(vao_);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
     glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0],
                  GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
                  &indices[0], GL_STATIC_DRAW);
     const auto stride = (3 + 2 + 3 + 3) * sizeof(float);
@@ -539,7 +540,7 @@ void Sphere::Init()
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride,
                           (void*) (8 * sizeof(float)));
-    glBindVertexArray(0);
+    StateCache::BindVertexArray(0);
     glCheckError();
 }
 
@@ -551,7 +552,7 @@ void Sphere::Destroy()
 
 void Sphere::Draw()
 {
-    glBindVertexArray(vao_);
+    StateCache::BindVertexArray(vao_);
     glDrawElements(GL_TRIANGLE_STRIP, indexCount_, GL_UNSIGNED_INT, 0);
 }
 
@@ -573,8 +574,8 @@ void Sphere::FreeBuffers()
 {
     if (ebo_)
     {
-        glDeleteBuffers(1, &ebo_);
-        glDeleteBuffers(4, &vbo_[0]);
+        StateCache::DeleteBuffers(1, &ebo_);
+        StateCache::DeleteBuffers(4, &vbo_[0]);
         ebo_ = 0;
         std::ranges::fill(vbo_, 0);
     }
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <glm/vec3.hpp>
+
+namespace core
+{
+
+template<class T, std::size_t Alignment>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template<class U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+    {}
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* p, [[maybe_unused]] std::size_t n) noexcept
+    {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template<class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept
+    { return true; }
+};
+
+template<class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+
+/**
+ * \brief Orbital simulation of asteroids around a central mass.
+ * Positions and velocities are stored as separate x/y/z arrays so that force, velocity and
+ * position are computed in a single vectorized pass.
+ */
+class AsteroidSimulation
+{
+public:
+    void Resize(std::size_t count);
+
+    /**
+     * \brief Fused force/velocity/position integration of the asteroids in [begin, end)
+     */
+    void Update(float dt, std::size_t begin, std::size_t end);
+
+    void SetPosition(std::size_t index, glm::vec3 position);
+
+    void SetVelocity(std::size_t index, glm::vec3 velocity);
+
+    [[nodiscard]] glm::vec3 GetPosition(std::size_t index) const;
+
+    [[nodiscard]] glm::vec3 GetVelocity(std::size_t index) const;
+
+    /**
+     * \brief Interleave the positions in [begin, end) into destination, used to fill instance buffers
+     */
+    void CopyPositions(glm::vec3* destination, std::size_t begin, std::size_t end) const;
+
+    [[nodiscard]] std::size_t GetSize() const
+    { return positionsX_.size(); }
+
+    float gravityConst = 1000.0f;
+    float centerMass = 1000.0f;
+private:
+    void UpdateScalar(float dt, std::size_t begin, std::size_t end);
+
+    AlignedVector<float> positionsX_;
+    AlignedVector<float> positionsY_;
+    AlignedVector<float> positionsZ_;
+    AlignedVector<float> velocitiesX_;
+    AlignedVector<float> velocitiesY_;
+    AlignedVector<float> velocitiesZ_;
+};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/vec3.hpp>
+
+namespace core
+{
+class WorkerQueue;
+
+/**
+ * \brief Barnes-Hut octree used to approximate the gravity between n bodies in O(n log n).
+ * Bodies are reordered along the tree so that a leaf references a contiguous range of bodies.
+ */
+class BarnesHutTree
+{
+public:
+    static constexpr std::int32_t INVALID_NODE = -1;
+    static constexpr int MAX_DEPTH = 32;
+
+    struct Node
+    {
+        glm::vec3 centerOfMass{};
+        float mass = 0.0f;
+        glm::vec3 center{};
+        float halfSize = 0.0f;
+        std::array<std::int32_t, 8> children{
+                INVALID_NODE, INVALID_NODE, INVALID_NODE, INVALID_NODE,
+                INVALID_NODE, INVALID_NODE, INVALID_NODE, INVALID_NODE};
+        std::uint32_t bodyBegin = 0;
+        std::uint32_t bodyEnd = 0;
+        bool isLeaf = true;
+    };
+
+    /**
+     * \brief Build the tree on the calling thread
+     */
+    void Build(std::span<const glm::vec3> positions, std::span<const float> masses);
+
+    /**
+     * \brief Build the tree, each octant of the root is built as a separate task on the queue
+     */
+    void Build(std::span<const glm::vec3> positions, std::span<const float> masses, WorkerQueue& queue);
+
+    /**
+     * \brief Gravitational acceleration at position, the body at skipIndex is ignored to avoid self interaction
+     */
+    [[nodiscard]] glm::vec3 ComputeAcceleration(glm::vec3 position, std::size_t skipIndex = SIZE_MAX) const;
+
+    /**
+     * \brief Acceleration of the bodies in [begin, end) of the tree order, written at their original index
+     */
+    void ComputeAccelerations(std::span<glm::vec3> accelerations, std::size_t begin, std::size_t end) const;
+
+    /**
+     * \brief Acceleration of all bodies, split in tasks of chunkSize bodies on the queue
+     */
+    void ComputeAccelerations(std::span<glm::vec3> accelerations, WorkerQueue& queue,
+                              std::size_t chunkSize = 4'096) const;
+
+    [[nodiscard]] const std::vector<Node>& GetNodes() const
+    { return nodes_; }
+
+    [[nodiscard]] std::size_t GetBodyCount() const
+    { return bodyPositions_.size(); }
+
+    /**
+     * \brief Opening angle, a node is approximated by its center of mass when size / distance < theta
+     */
+    float theta = 0.5f;
+    float gravityConst = 1.0f;
+    /**
+     * \brief Plummer softening length, keeps close encounters finite
+     */
+    float softening = 0.01f;
+    std::size_t leafCapacity = 8;
+private:
+    void Build(std::span<const glm::vec3> positions, std::span<const float> masses, WorkerQueue* queue);
+
+    std::vector<Node> nodes_;
+    /**
+     * Original index of the bodies in tree order
+     */
+    std::vector<std::uint32_t> sortedIndices_;
+    std::vector<glm::vec3> bodyPositions_;
+    std::vector<float> bodyMasses_;
+};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <service_locator.h>
+#include <cstddef>
+#include <span>
 #include <string_view>
 #include <string>
 
@@ -31,6 +33,43 @@ struct BufferFile
 
 };
 
+/**
+ * \brief Non-copyable RAII read only mapping of a file, its pages are loaded by the OS when first read
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& mappedFile) noexcept;
+
+    MappedFile& operator=(MappedFile&& mappedFile) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * \brief Map the whole file at path, false if it could not be opened or is empty
+     */
+    bool Open(std::string_view path);
+
+    void Close();
+
+    [[nodiscard]] std::span<const std::byte> GetData() const
+    { return {static_cast<const std::byte*>(data_), size_}; }
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
 class FilesystemInterface
 {
 public:
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace core
+{
+constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+/**
+ * \brief 64-bit FNV-1a hash, usable at compile time. Pass the previous hash to chain several strings.
+ */
+constexpr std::uint64_t HashFnv1a(std::string_view value, std::uint64_t hash = FNV_OFFSET_BASIS)
+{
+    for (const auto c : value)
+    {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+}
@@ -3,6 +3,8 @@
 #include <condition_variable>
 #include <future>
 #include <shared_mutex>
+#include <functional>
+#include <vector>
 
 #ifdef TRACY_ENABLE
 #include "tracy/Tracy.hpp"
@@ -48,12 +50,16 @@ class WorkerQueue
 public:
     ~WorkerQueue();
     [[nodiscard]] bool IsEmpty() const;
+    /**
+     * \brief Returns nullptr when another worker already took the last task
+     */
     [[nodiscard]] std::shared_ptr<Task> PopNextTask();
     void AddTask(std::shared_ptr<Task> task);
     void WaitForTask();
     void Destroy();
 private:
     std::vector<std::shared_ptr<Task>> tasks_;
+    bool isDestroyed_ = false;
 #ifdef TRACY_ENABLE
     mutable TracySharedLockable ( std::shared_mutex , queueMutex_ );
 #else
@@ -74,7 +80,7 @@ private:
     void Loop();
     WorkerQueue& taskQueue_;
     std::thread thread_;
-    bool isRunning_ = true;
+    std::atomic<bool> isRunning_ = true;
 };
 
 class Jobsystem
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace core
+{
+/**
+ * \brief Cooked model file, read in place from its mapping without parsing:
+ * header, meshes, materials, textures, string table, vertices then indices, each section 4 bytes aligned.
+ */
+constexpr std::array<char, 4> MESH_FILE_MAGIC = {'G', 'P', 'M', 'F'};
+constexpr std::uint32_t MESH_FILE_VERSION = 1;
+constexpr std::string_view MESH_FILE_EXTENSION = ".mesh";
+
+struct MeshFileVertex
+{
+    glm::vec3 position;
+    glm::vec2 texCoords;
+    glm::vec3 normal;
+    glm::vec3 tangent;
+};
+
+struct MeshFileHeader
+{
+    std::array<char, 4> magic = MESH_FILE_MAGIC;
+    std::uint32_t version = MESH_FILE_VERSION;
+    std::uint32_t vertexSize = sizeof(MeshFileVertex);
+    std::uint32_t meshCount = 0;
+    std::uint32_t materialCount = 0;
+    std::uint32_t textureCount = 0;
+    std::uint32_t stringTableSize = 0;
+    std::uint32_t vertexCount = 0;
+    std::uint32_t indexCount = 0;
+};
+
+struct MeshFileMesh
+{
+    std::uint32_t firstVertex = 0;
+    std::uint32_t vertexCount = 0;
+    std::uint32_t firstIndex = 0;
+    std::uint32_t indexCount = 0;
+    std::uint32_t materialIndex = 0;
+};
+
+struct MeshFileMaterial
+{
+    std::uint32_t firstTexture = 0;
+    std::uint32_t textureCount = 0;
+};
+
+/**
+ * \brief Texture path relative to the model directory and sampler type name, both in the string table
+ */
+struct MeshFileTexture
+{
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    std::uint32_t typeOffset = 0;
+    std::uint32_t typeLength = 0;
+};
+
+/**
+ * \brief Content of a mesh file to write
+ */
+struct MeshFileData
+{
+    std::vector<MeshFileMesh> meshes;
+    std::vector<MeshFileMaterial> materials;
+    std::vector<MeshFileTexture> textures;
+    std::string stringTable;
+    std::vector<MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+
+    /**
+     * \brief Append a texture to the table, materials reference a range of consecutive ones
+     */
+    void AddTexture(std::string_view path, std::string_view type);
+};
+
+/**
+ * \brief Sections of a mesh file pointing in its memory, which has to outlive the view
+ */
+struct MeshFileView
+{
+    std::span<const MeshFileMesh> meshes;
+    std::span<const MeshFileMaterial> materials;
+    std::span<const MeshFileTexture> textures;
+    std::string_view stringTable;
+    std::span<const MeshFileVertex> vertices;
+    std::span<const std::uint32_t> indices;
+
+    [[nodiscard]] std::string_view GetTexturePath(const MeshFileTexture& texture) const
+    { return stringTable.substr(texture.pathOffset, texture.pathLength); }
+
+    [[nodiscard]] std::string_view GetTextureType(const MeshFileTexture& texture) const
+    { return stringTable.substr(texture.typeOffset, texture.typeLength); }
+};
+
+[[nodiscard]] std::vector<std::byte> WriteMeshFile(const MeshFileData& data);
+
+/**
+ * \brief Check the header and the bounds of every section and reference, nullopt if the file is invalid.
+ * data has to be 4 bytes aligned, which the mapping of a file always is.
+ */
+[[nodiscard]] std::optional<MeshFileView> ReadMeshFile(std::span<const std::byte> data);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "mesh_file.h"
+
+namespace core
+{
+/**
+ * \brief Post-transform cache efficiency of an index buffer simulated with a FIFO cache of cacheSize vertices.
+ * ACMR: vertex shader invocations per triangle, from 0.5 in the best case to 3.
+ * ATVR: vertex shader invocations per vertex, 1 in the best case.
+ */
+struct VertexCacheStatistics
+{
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+struct MeshOptimizationStatistics
+{
+    VertexCacheStatistics before;
+    VertexCacheStatistics after;
+};
+
+constexpr std::size_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+[[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(std::span<const std::uint32_t> indices,
+                                                       std::size_t vertexCount,
+                                                       std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * \brief Reorder the triangles so consecutive ones share vertices, with the scores of Tom Forsyth's
+ * linear-speed vertex cache optimization. Does not depend on the exact cache size of the GPU.
+ */
+void OptimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount);
+
+/**
+ * \brief Reorder clusters of triangles, split where the cache restarts, so the ones facing out of the mesh
+ * are drawn first and occlude the others. Run after OptimizeVertexCache, whose order it keeps in each cluster.
+ */
+void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const MeshFileVertex> vertices,
+                      std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * \brief Number the vertices in the order the indices first use them and rewrite the indices,
+ * remap gets the new index of each old vertex (or ~0u if unused). Returns the number of used vertices.
+ */
+std::size_t OptimizeVertexFetch(std::span<std::uint32_t> indices, std::span<std::uint32_t> remap);
+
+/**
+ * \brief Move the vertices to the index remap gives them, dropping the unused ones
+ */
+template<typename T>
+void RemapVertices(std::vector<T>& vertices, std::span<const std::uint32_t> remap, std::size_t usedVertexCount)
+{
+    std::vector<T> remapped(usedVertexCount);
+    for (std::size_t i = 0; i < vertices.size(); i++)
+    {
+        if (remap[i] != ~0u)
+        {
+            remapped[remap[i]] = vertices[i];
+        }
+    }
+    vertices = std::move(remapped);
+}
+
+/**
+ * \brief Run the vertex cache, overdraw and vertex fetch optimizations in that order
+ */
+MeshOptimizationStatistics OptimizeMesh(std::vector<MeshFileVertex>& vertices, std::vector<std::uint32_t>& indices);
+}
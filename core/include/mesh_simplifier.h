@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "mesh_file.h"
+
+namespace core
+{
+/**
+ * \brief Collapse edges by increasing quadric error (Garland and Heckbert) until at most targetIndexCount indices
+ * are left or no collapse is possible. Vertices are only moved onto their neighbours, so the result indexes
+ * the same vertices and every level of detail can share one vertex buffer. The vertices of open borders and
+ * attribute seams, where the indexed mesh is not closed, never move so the silhouette and the UVs do not tear.
+ */
+[[nodiscard]] std::vector<std::uint32_t> SimplifyMesh(std::span<const std::uint32_t> indices,
+                                                      std::span<const MeshFileVertex> vertices,
+                                                      std::size_t targetIndexCount);
+
+/**
+ * \brief Indices of up to lodCount - 1 levels of detail, each simplified from the previous one to reduction
+ * times its triangles and optimized for the vertex cache. The chain stops early when the mesh does not
+ * simplify any further, LOD 0 is indices itself and is not part of the result.
+ */
+[[nodiscard]] std::vector<std::vector<std::uint32_t>> GenerateLodChain(std::span<const std::uint32_t> indices,
+                                                                       std::span<const MeshFileVertex> vertices,
+                                                                       std::size_t lodCount,
+                                                                       float reduction = 0.5f);
+}
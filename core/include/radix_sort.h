@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace core
+{
+/**
+ * \brief 64-bit sort key and the index of the element it orders
+ */
+struct SortItem
+{
+    std::uint64_t key = 0;
+    std::uint32_t index = 0;
+};
+
+/**
+ * \brief Stable LSD radix sort on the keys, one byte per pass.
+ * scratch must be as large as items, the passes where every key has the same byte are skipped.
+ */
+void RadixSort(std::span<SortItem> items, std::span<SortItem> scratch);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Block compressed formats of 4x4 texels: BC1 for RGB, BC3 for RGBA, BC4 for one channel
+ * and BC5 for two channels, e.g. the xy of a tangent space normal map whose z is rebuilt in the shader
+ */
+enum class BlockFormat
+{
+    BC1,
+    BC3,
+    BC4,
+    BC5
+};
+
+/**
+ * \brief Suffix of the cooked file next to a source texture, gl::Texture loads it instead when it exists.
+ * The rows of the flipped one are stored bottom to top for the textures loaded with FLIP_Y.
+ */
+constexpr std::string_view COOKED_TEXTURE_EXTENSION = ".ktx";
+constexpr std::string_view FLIPPED_COOKED_TEXTURE_EXTENSION = ".flipped.ktx";
+
+constexpr std::size_t BLOCK_SIZE = 4;
+constexpr std::size_t BLOCK_TEXEL_COUNT = BLOCK_SIZE * BLOCK_SIZE;
+
+/**
+ * \brief RGBA8 texels of a block, row by row
+ */
+using ColorBlock = std::array<std::uint8_t, BLOCK_TEXEL_COUNT * 4>;
+
+[[nodiscard]] std::size_t GetBlockByteSize(BlockFormat format);
+
+/**
+ * \brief Endpoints along the principal axis of the colors, refined once by least squares, in 4-color mode
+ */
+[[nodiscard]] std::array<std::uint8_t, 8> EncodeBc1Block(const ColorBlock& block);
+
+/**
+ * \brief Endpoints at the min and max of the values, in 8-value mode
+ */
+[[nodiscard]] std::array<std::uint8_t, 8> EncodeBc4Block(const std::array<std::uint8_t, BLOCK_TEXEL_COUNT>& values);
+
+[[nodiscard]] ColorBlock DecodeBc1Block(std::span<const std::uint8_t, 8> block);
+
+[[nodiscard]] std::array<std::uint8_t, BLOCK_TEXEL_COUNT> DecodeBc4Block(std::span<const std::uint8_t, 8> block);
+
+/**
+ * \brief Compress a RGBA8 image, the blocks past its right and bottom edges repeat the last texels
+ */
+[[nodiscard]] std::vector<std::uint8_t> CompressImage(std::span<const std::uint8_t> rgba, int width, int height,
+                                                      BlockFormat format);
+
+/**
+ * \brief Next mip level of a RGBA8 image with a box filter, averaging the colors in linear space if srgb
+ */
+[[nodiscard]] std::vector<std::uint8_t> DownsampleImage(std::span<const std::uint8_t> rgba, int width, int height,
+                                                        bool srgb);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <glm/vec3.hpp>
+
+#include "mesh_file.h"
+
+namespace core
+{
+/**
+ * \brief 20 bytes vertex: positions in 16-bit unorm relative to the mesh bounds (w is padding),
+ * normal and tangent octahedral encoded in 2 16-bit snorm and texture coordinates in half floats
+ */
+struct QuantizedVertex
+{
+    std::array<std::uint16_t, 4> position{};
+    std::array<std::int16_t, 2> normal{};
+    std::array<std::int16_t, 2> tangent{};
+    std::array<std::uint16_t, 2> texCoords{};
+};
+static_assert(sizeof(QuantizedVertex) == 20);
+
+/**
+ * \brief IEEE 754 binary16 of value, rounded to nearest even
+ */
+[[nodiscard]] std::uint16_t FloatToHalf(float value);
+
+[[nodiscard]] float HalfToFloat(std::uint16_t value);
+
+/**
+ * \brief Unit direction folded on the octahedron, then its xy in snorm16
+ */
+[[nodiscard]] std::array<std::int16_t, 2> EncodeOctahedral(glm::vec3 direction);
+
+[[nodiscard]] glm::vec3 DecodeOctahedral(std::array<std::int16_t, 2> encoded);
+
+[[nodiscard]] QuantizedVertex QuantizeVertex(const MeshFileVertex& vertex, glm::vec3 boundsMin, glm::vec3 boundsMax);
+}
@@ -0,0 +1,127 @@
+#include <asteroid_simulation.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASTEROID_SIMULATION_SSE
+#include <emmintrin.h>
+#endif
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+
+void AsteroidSimulation::Resize(std::size_t count)
+{
+    positionsX_.resize(count);
+    positionsY_.resize(count);
+    positionsZ_.resize(count);
+    velocitiesX_.resize(count);
+    velocitiesY_.resize(count);
+    velocitiesZ_.resize(count);
+}
+
+void AsteroidSimulation::Update(float dt, std::size_t begin, std::size_t end)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    end = std::min(end, GetSize());
+    if (begin >= end)
+        return;
+#ifdef ASTEROID_SIMULATION_SSE
+    float* px = positionsX_.data();
+    float* py = positionsY_.data();
+    float* pz = positionsZ_.data();
+    float* vx = velocitiesX_.data();
+    float* vy = velocitiesY_.data();
+    float* vz = velocitiesZ_.data();
+    const __m128 gravityMass = _mm_set1_ps(gravityConst * centerMass);
+    const __m128 deltaTime = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(px + i);
+        const __m128 y = _mm_loadu_ps(py + i);
+        const __m128 z = _mm_loadu_ps(pz + i);
+        const __m128 sqrXz = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z));
+        const __m128 r = _mm_sqrt_ps(_mm_add_ps(sqrXz, _mm_mul_ps(y, y)));
+        // circular orbit: |F| / m * r = G * M / r
+        const __m128 speed = _mm_sqrt_ps(_mm_div_ps(gravityMass, r));
+        // tangent direction (z, 0, -x) normalized on the xz plane
+        const __m128 scale = _mm_div_ps(speed, _mm_sqrt_ps(sqrXz));
+        const __m128 newVx = _mm_mul_ps(z, scale);
+        const __m128 newVz = _mm_sub_ps(zero, _mm_mul_ps(x, scale));
+        _mm_storeu_ps(vx + i, newVx);
+        _mm_storeu_ps(vy + i, zero);
+        _mm_storeu_ps(vz + i, newVz);
+        _mm_storeu_ps(px + i, _mm_add_ps(x, _mm_mul_ps(newVx, deltaTime)));
+        _mm_storeu_ps(pz + i, _mm_add_ps(z, _mm_mul_ps(newVz, deltaTime)));
+    }
+    UpdateScalar(dt, i, end);
+#else
+    UpdateScalar(dt, begin, end);
+#endif
+}
+
+void AsteroidSimulation::UpdateScalar(float dt, std::size_t begin, std::size_t end)
+{
+    const float gravityMass = gravityConst * centerMass;
+    for (std::size_t i = begin; i < end; i++)
+    {
+        const float x = positionsX_[i];
+        const float y = positionsY_[i];
+        const float z = positionsZ_[i];
+        const float sqrXz = x * x + z * z;
+        const float r = std::sqrt(sqrXz + y * y);
+        const float speed = std::sqrt(gravityMass / r);
+        const float scale = speed / std::sqrt(sqrXz);
+        velocitiesX_[i] = z * scale;
+        velocitiesY_[i] = 0.0f;
+        velocitiesZ_[i] = -x * scale;
+        positionsX_[i] = x + velocitiesX_[i] * dt;
+        positionsZ_[i] = z + velocitiesZ_[i] * dt;
+    }
+}
+
+void AsteroidSimulation::SetPosition(std::size_t index, glm::vec3 position)
+{
+    positionsX_[index] = position.x;
+    positionsY_[index] = position.y;
+    positionsZ_[index] = position.z;
+}
+
+void AsteroidSimulation::SetVelocity(std::size_t index, glm::vec3 velocity)
+{
+    velocitiesX_[index] = velocity.x;
+    velocitiesY_[index] = velocity.y;
+    velocitiesZ_[index] = velocity.z;
+}
+
+glm::vec3 AsteroidSimulation::GetPosition(std::size_t index) const
+{
+    return {positionsX_[index], positionsY_[index], positionsZ_[index]};
+}
+
+glm::vec3 AsteroidSimulation::GetVelocity(std::size_t index) const
+{
+    return {velocitiesX_[index], velocitiesY_[index], velocitiesZ_[index]};
+}
+
+void AsteroidSimulation::CopyPositions(glm::vec3* destination, std::size_t begin, std::size_t end) const
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    end = std::min(end, GetSize());
+    for (std::size_t i = begin; i < end; i++)
+    {
+        destination[i - begin] = glm::vec3(positionsX_[i], positionsY_[i], positionsZ_[i]);
+    }
+}
+}
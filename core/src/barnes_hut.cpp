@@ -0,0 +1,319 @@
+#include <barnes_hut.h>
+#include <jobsystem.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <glm/geometric.hpp>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+namespace
+{
+struct BuildContext
+{
+    std::uint32_t* indices = nullptr;
+    const glm::vec3* positions = nullptr;
+    const float* masses = nullptr;
+    std::size_t leafCapacity = 8;
+};
+
+/**
+ * \brief Reorder indices[begin, end) by octant of center, octant bit 0 is x, bit 1 is y and bit 2 is z.
+ * Returns the 9 bounds of the 8 octant ranges.
+ */
+std::array<std::uint32_t, 9> PartitionOctants(const BuildContext& context,
+                                              std::uint32_t begin, std::uint32_t end,
+                                              glm::vec3 center)
+{
+    const auto split = [&context, center](std::uint32_t first, std::uint32_t last, int axis) {
+        const auto* middle = std::partition(context.indices + first, context.indices + last,
+                                            [&context, center, axis](std::uint32_t index) {
+                                                return context.positions[index][axis] < center[axis];
+                                            });
+        return static_cast<std::uint32_t>(middle - context.indices);
+    };
+    std::array<std::uint32_t, 9> bounds{};
+    bounds[0] = begin;
+    bounds[8] = end;
+    bounds[4] = split(bounds[0], bounds[8], 2);
+    bounds[2] = split(bounds[0], bounds[4], 1);
+    bounds[6] = split(bounds[4], bounds[8], 1);
+    bounds[1] = split(bounds[0], bounds[2], 0);
+    bounds[3] = split(bounds[2], bounds[4], 0);
+    bounds[5] = split(bounds[4], bounds[6], 0);
+    bounds[7] = split(bounds[6], bounds[8], 0);
+    return bounds;
+}
+
+glm::vec3 OctantCenter(glm::vec3 center, float halfSize, int octant)
+{
+    const float quarter = halfSize * 0.5f;
+    return center + glm::vec3(octant & 1 ? quarter : -quarter,
+                              octant & 2 ? quarter : -quarter,
+                              octant & 4 ? quarter : -quarter);
+}
+
+void AccumulateMass(BarnesHutTree::Node& node, glm::vec3 position, float mass)
+{
+    node.centerOfMass += position * mass;
+    node.mass += mass;
+}
+
+void FinalizeMass(BarnesHutTree::Node& node)
+{
+    if (node.mass > 0.0f)
+    {
+        node.centerOfMass /= node.mass;
+    }
+    else
+    {
+        node.centerOfMass = node.center;
+    }
+}
+
+std::int32_t BuildNode(std::vector<BarnesHutTree::Node>& nodes, const BuildContext& context,
+                       std::uint32_t begin, std::uint32_t end,
+                       glm::vec3 center, float halfSize, int depth)
+{
+    const auto nodeIndex = static_cast<std::int32_t>(nodes.size());
+    nodes.emplace_back();
+    //Children are appended to nodes while building, so the node is filled locally
+    BarnesHutTree::Node node;
+    node.center = center;
+    node.halfSize = halfSize;
+    node.bodyBegin = begin;
+    node.bodyEnd = end;
+    if (end - begin <= context.leafCapacity || depth >= BarnesHutTree::MAX_DEPTH)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            const auto body = context.indices[i];
+            AccumulateMass(node, context.positions[body], context.masses[body]);
+        }
+    }
+    else
+    {
+        node.isLeaf = false;
+        const auto bounds = PartitionOctants(context, begin, end, center);
+        for (int octant = 0; octant < 8; octant++)
+        {
+            if (bounds[octant] == bounds[octant + 1])
+                continue;
+            const auto child = BuildNode(nodes, context, bounds[octant], bounds[octant + 1],
+                                         OctantCenter(center, halfSize, octant), halfSize * 0.5f,
+                                         depth + 1);
+            node.children[octant] = child;
+            AccumulateMass(node, nodes[child].centerOfMass, nodes[child].mass);
+        }
+    }
+    FinalizeMass(node);
+    nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+glm::vec3 PairAcceleration(glm::vec3 delta, float mass, float softeningSqr)
+{
+    const float distanceSqr = glm::dot(delta, delta) + softeningSqr;
+    if (distanceSqr <= 0.0f)
+        return glm::vec3(0.0f);
+    const float invDistance = 1.0f / std::sqrt(distanceSqr);
+    return delta * (mass * invDistance * invDistance * invDistance);
+}
+}
+
+void BarnesHutTree::Build(std::span<const glm::vec3> positions, std::span<const float> masses)
+{
+    Build(positions, masses, nullptr);
+}
+
+void BarnesHutTree::Build(std::span<const glm::vec3> positions, std::span<const float> masses, WorkerQueue& queue)
+{
+    Build(positions, masses, &queue);
+}
+
+void BarnesHutTree::Build(std::span<const glm::vec3> positions, std::span<const float> masses, WorkerQueue* queue)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto count = static_cast<std::uint32_t>(std::min(positions.size(), masses.size()));
+    nodes_.clear();
+    sortedIndices_.resize(count);
+    bodyPositions_.resize(count);
+    bodyMasses_.resize(count);
+    if (count == 0)
+        return;
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        sortedIndices_[i] = i;
+    }
+
+    glm::vec3 minBound = positions[0];
+    glm::vec3 maxBound = positions[0];
+    for (std::uint32_t i = 1; i < count; i++)
+    {
+        minBound = glm::min(minBound, positions[i]);
+        maxBound = glm::max(maxBound, positions[i]);
+    }
+    const glm::vec3 extent = maxBound - minBound;
+    const glm::vec3 center = (minBound + maxBound) * 0.5f;
+    //Slightly larger than the bounds so that the bodies on the border fall inside
+    const float halfSize = std::max({extent.x, extent.y, extent.z, 1e-6f}) * 0.5f * 1.001f;
+
+    const BuildContext context{sortedIndices_.data(), positions.data(), masses.data(),
+                               std::max<std::size_t>(leafCapacity, 1)};
+    Node root;
+    root.center = center;
+    root.halfSize = halfSize;
+    root.bodyBegin = 0;
+    root.bodyEnd = count;
+    if (count <= context.leafCapacity)
+    {
+        BuildNode(nodes_, context, 0, count, center, halfSize, 0);
+    }
+    else
+    {
+        //The root octants are independent ranges of the index array, each one is built in its own node list
+        root.isLeaf = false;
+        const auto bounds = PartitionOctants(context, 0, count, center);
+        std::array<std::vector<Node>, 8> octantNodes;
+        const auto buildOctant = [&octantNodes, &context, &bounds, center, halfSize](int octant) {
+            BuildNode(octantNodes[octant], context, bounds[octant], bounds[octant + 1],
+                      OctantCenter(center, halfSize, octant), halfSize * 0.5f, 1);
+        };
+        std::vector<std::shared_ptr<Task>> tasks;
+        for (int octant = 0; octant < 8; octant++)
+        {
+            if (bounds[octant] == bounds[octant + 1])
+                continue;
+            if (queue == nullptr)
+            {
+                buildOctant(octant);
+                continue;
+            }
+            auto task = std::make_shared<Task>([&buildOctant, octant]() { buildOctant(octant); });
+            queue->AddTask(task);
+            tasks.push_back(std::move(task));
+        }
+        for (auto& task : tasks)
+        {
+            task->Join();
+        }
+
+        std::size_t nodeCount = 1;
+        for (const auto& octant : octantNodes)
+        {
+            nodeCount += octant.size();
+        }
+        nodes_.reserve(nodeCount);
+        nodes_.push_back(root);
+        for (int octant = 0; octant < 8; octant++)
+        {
+            if (octantNodes[octant].empty())
+                continue;
+            const auto offset = static_cast<std::int32_t>(nodes_.size());
+            for (auto node : octantNodes[octant])
+            {
+                for (auto& child : node.children)
+                {
+                    if (child != INVALID_NODE)
+                        child += offset;
+                }
+                nodes_.push_back(node);
+            }
+            nodes_[0].children[octant] = offset;
+            AccumulateMass(nodes_[0], nodes_[offset].centerOfMass, nodes_[offset].mass);
+        }
+        FinalizeMass(nodes_[0]);
+    }
+
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        bodyPositions_[i] = positions[sortedIndices_[i]];
+        bodyMasses_[i] = masses[sortedIndices_[i]];
+    }
+}
+
+glm::vec3 BarnesHutTree::ComputeAcceleration(glm::vec3 position, std::size_t skipIndex) const
+{
+    glm::vec3 acceleration(0.0f);
+    if (nodes_.empty())
+        return acceleration;
+    const float thetaSqr = theta * theta;
+    const float softeningSqr = softening * softening;
+    //Depth first traversal, each level pushes at most 8 children
+    std::array<std::int32_t, 8 * (MAX_DEPTH + 1)> stack{};
+    std::size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const Node& node = nodes_[stack[--stackSize]];
+        if (node.isLeaf)
+        {
+            for (auto i = node.bodyBegin; i < node.bodyEnd; i++)
+            {
+                if (sortedIndices_[i] == skipIndex)
+                    continue;
+                acceleration += PairAcceleration(bodyPositions_[i] - position, bodyMasses_[i], softeningSqr);
+            }
+            continue;
+        }
+        const glm::vec3 delta = node.centerOfMass - position;
+        const float size = node.halfSize * 2.0f;
+        if (size * size < thetaSqr * glm::dot(delta, delta))
+        {
+            acceleration += PairAcceleration(delta, node.mass, softeningSqr);
+            continue;
+        }
+        for (auto it = node.children.rbegin(); it != node.children.rend(); ++it)
+        {
+            if (*it != INVALID_NODE)
+                stack[stackSize++] = *it;
+        }
+    }
+    return acceleration * gravityConst;
+}
+
+void BarnesHutTree::ComputeAccelerations(std::span<glm::vec3> accelerations, std::size_t begin, std::size_t end) const
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    end = std::min(end, GetBodyCount());
+    //Neighbours in tree order walk the same nodes, which keeps the traversal in cache
+    for (std::size_t i = begin; i < end; i++)
+    {
+        accelerations[sortedIndices_[i]] = ComputeAcceleration(bodyPositions_[i], sortedIndices_[i]);
+    }
+}
+
+void BarnesHutTree::ComputeAccelerations(std::span<glm::vec3> accelerations, WorkerQueue& queue,
+                                         std::size_t chunkSize) const
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    const auto count = GetBodyCount();
+    std::vector<std::shared_ptr<Task>> tasks;
+    tasks.reserve((count + chunkSize - 1) / chunkSize);
+    for (std::size_t begin = 0; begin < count; begin += chunkSize)
+    {
+        const auto end = std::min(begin + chunkSize, count);
+        auto task = std::make_shared<Task>([this, accelerations, begin, end]() {
+            ComputeAccelerations(accelerations, begin, end);
+        });
+        queue.AddTask(task);
+        tasks.push_back(std::move(task));
+    }
+    for (auto& task : tasks)
+    {
+        task->Join();
+    }
+}
+}
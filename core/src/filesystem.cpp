@@ -7,6 +7,17 @@
 
 #include "log.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef TRACY_ENABLE
 #include "tracy/Tracy.hpp"
 #endif
@@ -50,6 +61,102 @@ void BufferFile::Destroy()
     }
 }
 
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& mappedFile) noexcept
+{
+    *this = std::move(mappedFile);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& mappedFile) noexcept
+{
+    std::swap(data_, mappedFile.data_);
+    std::swap(size_, mappedFile.size_);
+#ifdef _WIN32
+    std::swap(file_, mappedFile.file_);
+    std::swap(mapping_, mappedFile.mapping_);
+#endif
+    return *this;
+}
+
+bool MappedFile::Open(std::string_view path)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    Close();
+    const std::string pathString(path);
+#ifdef _WIN32
+    file_ = CreateFileA(pathString.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        file_ = nullptr;
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file_, &fileSize);
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    mapping_ = size_ == 0 ? nullptr : CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data_ = mapping_ == nullptr ? nullptr : MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+    const int fd = open(pathString.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        size_ = static_cast<std::size_t>(fileStat.st_size);
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ == MAP_FAILED)
+        {
+            data_ = nullptr;
+        }
+    }
+    //The mapping keeps its own reference to the file
+    close(fd);
+#endif
+    if (data_ == nullptr)
+    {
+        LogError(fmt::format("[Error] Could not map file: {}", path));
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != nullptr)
+    {
+        CloseHandle(file_);
+        file_ = nullptr;
+    }
+#else
+    if (data_ != nullptr)
+    {
+        munmap(data_, size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
 Filesystem::Filesystem()
 {
     FilesystemLocator::provide(this);
@@ -129,6 +129,10 @@ void WorkerThread::Loop()
             while (!taskQueue_.IsEmpty())
             {
                 auto newTask = taskQueue_.PopNextTask();
+                if (newTask == nullptr)
+                {
+                    break;
+                }
                 if (!newTask->CheckDependenciesStarted())
                 {
                     taskQueue_.AddTask(std::move(newTask));
@@ -173,6 +177,10 @@ std::shared_ptr<Task> WorkerQueue::PopNextTask()
 #else
     std::unique_lock<std::shared_mutex> lock(queueMutex_);
 #endif
+    if (tasks_.empty())
+    {
+        return nullptr;
+    }
     auto task = tasks_.front();
     tasks_.erase(tasks_.cbegin());
     return task;
@@ -196,11 +204,20 @@ void WorkerQueue::WaitForTask()
 #else
     std::unique_lock<std::shared_mutex> lock(queueMutex_);
 #endif
-    conditionVariable_.wait(lock);
+    //The predicate avoids missing a notification sent between IsEmpty and the wait
+    conditionVariable_.wait(lock, [this]() { return !tasks_.empty() || isDestroyed_; });
 }
 
 void WorkerQueue::Destroy()
 {
+    {
+#ifdef TRACY_ENABLE
+        std::unique_lock<SharedLockableBase (std::shared_mutex) > lock(queueMutex_);
+#else
+        std::unique_lock<std::shared_mutex> lock(queueMutex_);
+#endif
+        isDestroyed_ = true;
+    }
     conditionVariable_.notify_all();
 }
 
@@ -0,0 +1,155 @@
+#include "mesh_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+namespace
+{
+constexpr std::size_t SECTION_ALIGNMENT = 4;
+
+constexpr std::size_t Align(std::size_t size)
+{
+    return (size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+template<typename T>
+void AppendSection(std::vector<std::byte>& file, std::span<const T> section)
+{
+    const auto offset = file.size();
+    file.resize(offset + Align(section.size_bytes()));
+    if (!section.empty())
+    {
+        std::memcpy(file.data() + offset, section.data(), section.size_bytes());
+    }
+}
+
+/**
+ * \brief Section of count T at offset, advancing offset past it, empty if it does not fit in data
+ */
+template<typename T>
+std::optional<std::span<const T>> ReadSection(std::span<const std::byte> data, std::size_t& offset,
+                                              std::size_t count)
+{
+    const auto size = static_cast<std::uint64_t>(count) * sizeof(T);
+    if (size > data.size() - offset)
+    {
+        return std::nullopt;
+    }
+    const auto* begin = reinterpret_cast<const T*>(data.data() + offset);
+    offset += Align(static_cast<std::size_t>(size));
+    offset = std::min(offset, data.size());
+    return std::span<const T>(begin, count);
+}
+
+bool IsInRange(std::uint64_t first, std::uint64_t count, std::uint64_t size)
+{
+    return first + count <= size;
+}
+}
+
+void MeshFileData::AddTexture(std::string_view path, std::string_view type)
+{
+    MeshFileTexture texture;
+    texture.pathOffset = static_cast<std::uint32_t>(stringTable.size());
+    texture.pathLength = static_cast<std::uint32_t>(path.size());
+    stringTable += path;
+    texture.typeOffset = static_cast<std::uint32_t>(stringTable.size());
+    texture.typeLength = static_cast<std::uint32_t>(type.size());
+    stringTable += type;
+    textures.push_back(texture);
+}
+
+std::vector<std::byte> WriteMeshFile(const MeshFileData& data)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    MeshFileHeader header;
+    header.meshCount = static_cast<std::uint32_t>(data.meshes.size());
+    header.materialCount = static_cast<std::uint32_t>(data.materials.size());
+    header.textureCount = static_cast<std::uint32_t>(data.textures.size());
+    header.stringTableSize = static_cast<std::uint32_t>(data.stringTable.size());
+    header.vertexCount = static_cast<std::uint32_t>(data.vertices.size());
+    header.indexCount = static_cast<std::uint32_t>(data.indices.size());
+
+    std::vector<std::byte> file;
+    AppendSection(file, std::span<const MeshFileHeader>(&header, 1));
+    AppendSection(file, std::span(data.meshes));
+    AppendSection(file, std::span(data.materials));
+    AppendSection(file, std::span(data.textures));
+    AppendSection(file, std::span(data.stringTable));
+    AppendSection(file, std::span(data.vertices));
+    AppendSection(file, std::span(data.indices));
+    return file;
+}
+
+std::optional<MeshFileView> ReadMeshFile(std::span<const std::byte> data)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::size_t offset = 0;
+    const auto headerSection = ReadSection<MeshFileHeader>(data, offset, 1);
+    if (!headerSection)
+    {
+        return std::nullopt;
+    }
+    const auto& header = headerSection->front();
+    if (header.magic != MESH_FILE_MAGIC || header.version != MESH_FILE_VERSION ||
+        header.vertexSize != sizeof(MeshFileVertex))
+    {
+        return std::nullopt;
+    }
+
+    const auto meshes = ReadSection<MeshFileMesh>(data, offset, header.meshCount);
+    const auto materials = ReadSection<MeshFileMaterial>(data, offset, header.materialCount);
+    const auto textures = ReadSection<MeshFileTexture>(data, offset, header.textureCount);
+    const auto stringTable = ReadSection<char>(data, offset, header.stringTableSize);
+    const auto vertices = ReadSection<MeshFileVertex>(data, offset, header.vertexCount);
+    const auto indices = ReadSection<std::uint32_t>(data, offset, header.indexCount);
+    if (!meshes || !materials || !textures || !stringTable || !vertices || !indices)
+    {
+        return std::nullopt;
+    }
+
+    MeshFileView view{*meshes, *materials, *textures, std::string_view(stringTable->data(), stringTable->size()),
+                      *vertices, *indices};
+    for (const auto& texture : view.textures)
+    {
+        if (!IsInRange(texture.pathOffset, texture.pathLength, view.stringTable.size()) ||
+            !IsInRange(texture.typeOffset, texture.typeLength, view.stringTable.size()))
+        {
+            return std::nullopt;
+        }
+    }
+    for (const auto& material : view.materials)
+    {
+        if (!IsInRange(material.firstTexture, material.textureCount, view.textures.size()))
+        {
+            return std::nullopt;
+        }
+    }
+    for (const auto& mesh : view.meshes)
+    {
+        if (!IsInRange(mesh.firstVertex, mesh.vertexCount, view.vertices.size()) ||
+            !IsInRange(mesh.firstIndex, mesh.indexCount, view.indices.size()) ||
+            (!view.materials.empty() && mesh.materialIndex >= view.materials.size()))
+        {
+            return std::nullopt;
+        }
+        //Indices are relative to the first vertex of their mesh, one out of it would read another mesh on the GPU
+        const auto meshIndices = view.indices.subspan(mesh.firstIndex, mesh.indexCount);
+        if (std::ranges::any_of(meshIndices, [&mesh](std::uint32_t index) { return index >= mesh.vertexCount; }))
+        {
+            return std::nullopt;
+        }
+    }
+    return view;
+}
+}
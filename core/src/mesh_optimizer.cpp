@@ -0,0 +1,349 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <glm/geometric.hpp>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+namespace
+{
+//Scoring constants of Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+constexpr std::size_t FORSYTH_CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+constexpr std::size_t NO_TRIANGLE = ~std::size_t(0);
+
+float VertexScore(int cachePosition, std::uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0)
+    {
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+        {
+            //The vertices of the last triangle get a fixed score, so it is not rewarded to reuse them right away
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            const float scaler = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+    //Vertices with few triangles left are finished first, so they do not stay alone at the end
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+/**
+ * \brief FIFO post-transform cache, a vertex is a miss if more than cacheSize others were added since it was
+ */
+class FifoCache
+{
+public:
+    FifoCache(std::size_t vertexCount, std::size_t cacheSize) :
+            timestamps_(vertexCount, 0), cacheSize_(static_cast<std::uint32_t>(cacheSize)),
+            time_(static_cast<std::uint32_t>(cacheSize) + 1)
+    {}
+
+    bool Access(std::uint32_t vertex)
+    {
+        if (time_ - timestamps_[vertex] > cacheSize_)
+        {
+            timestamps_[vertex] = time_++;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::uint32_t> timestamps_;
+    std::uint32_t cacheSize_;
+    std::uint32_t time_;
+};
+}
+
+VertexCacheStatistics AnalyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount,
+                                         std::size_t cacheSize)
+{
+    VertexCacheStatistics statistics;
+    if (indices.size() < 3)
+    {
+        return statistics;
+    }
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> isUsed(vertexCount, false);
+    std::size_t missCount = 0;
+    std::size_t usedVertexCount = 0;
+    for (const auto index : indices)
+    {
+        if (!cache.Access(index))
+        {
+            missCount++;
+        }
+        if (!isUsed[index])
+        {
+            isUsed[index] = true;
+            usedVertexCount++;
+        }
+    }
+    statistics.acmr = static_cast<float>(missCount) / static_cast<float>(indices.size() / 3);
+    statistics.atvr = static_cast<float>(missCount) / static_cast<float>(usedVertexCount);
+    return statistics;
+}
+
+void OptimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+    //Triangles using each vertex, the ones not drawn yet come first in its range
+    std::vector<std::uint32_t> remainingTriangles(vertexCount, 0);
+    for (const auto index : indices)
+    {
+        remainingTriangles[index]++;
+    }
+    std::vector<std::size_t> adjacencyOffsets(vertexCount + 1, 0);
+    std::partial_sum(remainingTriangles.begin(), remainingTriangles.end(), adjacencyOffsets.begin() + 1);
+    std::vector<std::size_t> adjacency(triangleCount * 3);
+    {
+        std::vector<std::size_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (std::size_t i = 0; i < triangleCount * 3; i++)
+        {
+            adjacency[cursors[indices[i]]++] = i / 3;
+        }
+    }
+    const auto activeTriangles = [&](std::uint32_t vertex)
+    {
+        return std::span(adjacency).subspan(adjacencyOffsets[vertex], remainingTriangles[vertex]);
+    };
+
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (std::size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        vertexScores[vertex] = VertexScore(-1, remainingTriangles[vertex]);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> isAdded(triangleCount, false);
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+    {
+        triangleScores[triangle] = vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]] +
+                                   vertexScores[indices[triangle * 3 + 2]];
+    }
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<std::uint32_t> cache;
+    std::vector<std::uint32_t> newCache;
+    std::size_t bestTriangle = std::distance(triangleScores.begin(), std::ranges::max_element(triangleScores));
+    std::size_t scanCursor = 0;
+    for (std::size_t drawnCount = 0; drawnCount < triangleCount; drawnCount++)
+    {
+        if (bestTriangle == NO_TRIANGLE)
+        {
+            //No triangle left around the cache, restart from the next one not drawn
+            while (isAdded[scanCursor])
+            {
+                scanCursor++;
+            }
+            bestTriangle = scanCursor;
+        }
+        isAdded[bestTriangle] = true;
+        const auto triangle = indices.subspan(bestTriangle * 3, 3);
+        output.insert(output.end(), triangle.begin(), triangle.end());
+
+        newCache.clear();
+        for (const auto vertex : triangle)
+        {
+            auto vertexTriangles = activeTriangles(vertex);
+            const auto it = std::ranges::find(vertexTriangles, bestTriangle);
+            std::iter_swap(it, vertexTriangles.end() - 1);
+            remainingTriangles[vertex]--;
+            if (std::ranges::find(newCache, vertex) == newCache.end())
+            {
+                newCache.push_back(vertex);
+            }
+        }
+        for (const auto vertex : cache)
+        {
+            if (std::ranges::find(triangle, vertex) == triangle.end())
+            {
+                newCache.push_back(vertex);
+            }
+        }
+
+        //Vertices pushed out of the cache lose their cache score
+        for (std::size_t i = 0; i < newCache.size(); i++)
+        {
+            const auto vertex = newCache[i];
+            cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+            const float score = VertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+            const float delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+            for (const auto vertexTriangle : activeTriangles(vertex))
+            {
+                triangleScores[vertexTriangle] += delta;
+            }
+        }
+        newCache.resize(std::min(newCache.size(), FORSYTH_CACHE_SIZE));
+        std::swap(cache, newCache);
+
+        bestTriangle = NO_TRIANGLE;
+        float bestScore = -1.0f;
+        for (const auto vertex : cache)
+        {
+            for (const auto vertexTriangle : activeTriangles(vertex))
+            {
+                if (triangleScores[vertexTriangle] > bestScore)
+                {
+                    bestScore = triangleScores[vertexTriangle];
+                    bestTriangle = vertexTriangle;
+                }
+            }
+        }
+    }
+    std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const MeshFileVertex> vertices,
+                      std::size_t cacheSize)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+    //A triangle missing all its vertices starts a new cluster, moving clusters keeps the cache hits inside them
+    std::vector<std::size_t> clusterStarts;
+    FifoCache cache(vertices.size(), cacheSize);
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+    {
+        std::size_t missCount = 0;
+        for (std::size_t i = 0; i < 3; i++)
+        {
+            missCount += cache.Access(indices[triangle * 3 + i]) ? 0 : 1;
+        }
+        if (missCount == 3)
+        {
+            clusterStarts.push_back(triangle);
+        }
+    }
+    if (clusterStarts.empty() || clusterStarts.front() != 0)
+    {
+        clusterStarts.insert(clusterStarts.begin(), 0);
+    }
+    clusterStarts.push_back(triangleCount);
+    const auto clusterCount = clusterStarts.size() - 1;
+
+    //Area weighted centroid and normal of each cluster and of the whole mesh
+    std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (std::size_t cluster = 0; cluster < clusterCount; cluster++)
+    {
+        float clusterArea = 0.0f;
+        for (std::size_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+        {
+            const auto& p0 = vertices[indices[triangle * 3]].position;
+            const auto& p1 = vertices[indices[triangle * 3 + 1]].position;
+            const auto& p2 = vertices[indices[triangle * 3 + 2]].position;
+            const auto normal = glm::cross(p1 - p0, p2 - p0);
+            const float area = glm::length(normal);
+            clusterCentroids[cluster] += (p0 + p1 + p2) * (area / 3.0f);
+            clusterNormals[cluster] += normal;
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroids[cluster];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0f)
+        {
+            clusterCentroids[cluster] /= clusterArea;
+        }
+    }
+    if (meshArea > 0.0f)
+    {
+        meshCentroid /= meshArea;
+    }
+
+    //Clusters facing away from the center are on the outside and hide the ones behind them
+    std::vector<float> sortKeys(clusterCount);
+    for (std::size_t cluster = 0; cluster < clusterCount; cluster++)
+    {
+        const float normalLength = glm::length(clusterNormals[cluster]);
+        sortKeys[cluster] = normalLength > 0.0f ?
+                            glm::dot(clusterCentroids[cluster] - meshCentroid, clusterNormals[cluster]) /
+                            normalLength : 0.0f;
+    }
+    std::vector<std::size_t> clusterOrder(clusterCount);
+    std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+    std::ranges::stable_sort(clusterOrder, [&sortKeys](std::size_t a, std::size_t b)
+    {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    for (const auto cluster : clusterOrder)
+    {
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[cluster] * 3),
+                      indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[cluster + 1] * 3));
+    }
+    std::ranges::copy(output, indices.begin());
+}
+
+std::size_t OptimizeVertexFetch(std::span<std::uint32_t> indices, std::span<std::uint32_t> remap)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::ranges::fill(remap, ~0u);
+    std::uint32_t nextVertex = 0;
+    for (auto& index : indices)
+    {
+        if (remap[index] == ~0u)
+        {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+    return nextVertex;
+}
+
+MeshOptimizationStatistics OptimizeMesh(std::vector<MeshFileVertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    MeshOptimizationStatistics statistics;
+    statistics.before = AnalyzeVertexCache(indices, vertices.size());
+    OptimizeVertexCache(indices, vertices.size());
+    OptimizeOverdraw(indices, vertices);
+    std::vector<std::uint32_t> remap(vertices.size());
+    const auto usedVertexCount = OptimizeVertexFetch(indices, remap);
+    RemapVertices(vertices, remap, usedVertexCount);
+    statistics.after = AnalyzeVertexCache(indices, vertices.size());
+    return statistics;
+}
+}
@@ -0,0 +1,326 @@
+#include "mesh_simplifier.h"
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+#include <glm/geometric.hpp>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+namespace
+{
+/**
+ * \brief A level of detail has to remove at least this part of the previous one's triangles to be kept
+ */
+constexpr float MIN_LOD_REDUCTION = 0.1f;
+
+/**
+ * \brief Sum of the squared distances to a set of planes, weighted by the area of their triangles
+ */
+struct Quadric
+{
+    double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    double b2 = 0.0, bc = 0.0, bd = 0.0;
+    double c2 = 0.0, cd = 0.0;
+    double d2 = 0.0;
+
+    static Quadric FromPlane(glm::dvec3 normal, double distance, double weight)
+    {
+        Quadric quadric;
+        quadric.a2 = weight * normal.x * normal.x;
+        quadric.ab = weight * normal.x * normal.y;
+        quadric.ac = weight * normal.x * normal.z;
+        quadric.ad = weight * normal.x * distance;
+        quadric.b2 = weight * normal.y * normal.y;
+        quadric.bc = weight * normal.y * normal.z;
+        quadric.bd = weight * normal.y * distance;
+        quadric.c2 = weight * normal.z * normal.z;
+        quadric.cd = weight * normal.z * distance;
+        quadric.d2 = weight * distance * distance;
+        return quadric;
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a2 += other.a2;
+        ab += other.ab;
+        ac += other.ac;
+        ad += other.ad;
+        b2 += other.b2;
+        bc += other.bc;
+        bd += other.bd;
+        c2 += other.c2;
+        cd += other.cd;
+        d2 += other.d2;
+        return *this;
+    }
+
+    [[nodiscard]] double Evaluate(glm::dvec3 p) const
+    {
+        return a2 * p.x * p.x + 2.0 * ab * p.x * p.y + 2.0 * ac * p.x * p.z + 2.0 * ad * p.x +
+               b2 * p.y * p.y + 2.0 * bc * p.y * p.z + 2.0 * bd * p.y +
+               c2 * p.z * p.z + 2.0 * cd * p.z +
+               d2;
+    }
+};
+
+struct Collapse
+{
+    std::uint32_t from = 0;
+    std::uint32_t to = 0;
+    double error = 0.0;
+};
+
+std::uint64_t EdgeKey(std::uint32_t a, std::uint32_t b)
+{
+    return static_cast<std::uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+}
+
+glm::dvec3 TriangleNormal(glm::dvec3 p0, glm::dvec3 p1, glm::dvec3 p2)
+{
+    return glm::cross(p1 - p0, p2 - p0);
+}
+
+/**
+ * \brief Vertices on an edge not shared by exactly two triangles: open borders, attribute seams
+ * where the vertices are split, and non manifold edges
+ */
+std::vector<bool> FindLockedVertices(std::span<const std::uint32_t> indices, std::size_t vertexCount)
+{
+    std::unordered_map<std::uint64_t, std::uint32_t> edgeUses;
+    edgeUses.reserve(indices.size());
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (std::size_t edge = 0; edge < 3; edge++)
+        {
+            edgeUses[EdgeKey(indices[i + edge], indices[i + (edge + 1) % 3])]++;
+        }
+    }
+    std::vector<bool> isLocked(vertexCount, false);
+    for (const auto& [key, uses] : edgeUses)
+    {
+        if (uses != 2)
+        {
+            isLocked[static_cast<std::uint32_t>(key >> 32)] = true;
+            isLocked[static_cast<std::uint32_t>(key)] = true;
+        }
+    }
+    return isLocked;
+}
+
+/**
+ * \brief Triangles of each vertex, the ones of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]]
+ */
+struct Adjacency
+{
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> triangles;
+
+    void Build(std::span<const std::uint32_t> indices, std::size_t vertexCount)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        for (const auto index : indices)
+        {
+            offsets[index + 1]++;
+        }
+        for (std::size_t v = 0; v < vertexCount; v++)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+        triangles.resize(indices.size());
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); i++)
+        {
+            triangles[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+    }
+
+    [[nodiscard]] std::span<const std::uint32_t> GetTriangles(std::uint32_t vertex) const
+    {
+        return std::span(triangles).subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+    }
+};
+
+/**
+ * \brief Whether moving from onto to turns a triangle of from around, or makes it degenerate
+ */
+bool IsFlipping(const Collapse& collapse, std::span<const std::uint32_t> indices,
+                std::span<const MeshFileVertex> vertices, const Adjacency& adjacency)
+{
+    for (const auto triangle : adjacency.GetTriangles(collapse.from))
+    {
+        const auto* corners = &indices[triangle * 3];
+        if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+        {
+            //Removed by the collapse
+            continue;
+        }
+        std::array<glm::dvec3, 3> before{};
+        std::array<glm::dvec3, 3> after{};
+        for (std::size_t corner = 0; corner < 3; corner++)
+        {
+            before[corner] = glm::dvec3(vertices[corners[corner]].position);
+            after[corner] = corners[corner] == collapse.from ?
+                            glm::dvec3(vertices[collapse.to].position) : before[corner];
+        }
+        const auto normalBefore = TriangleNormal(before[0], before[1], before[2]);
+        const auto normalAfter = TriangleNormal(after[0], after[1], after[2]);
+        if (glm::dot(normalBefore, normalAfter) <= 0.0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+std::vector<std::uint32_t> SimplifyMesh(std::span<const std::uint32_t> indices,
+                                        std::span<const MeshFileVertex> vertices,
+                                        std::size_t targetIndexCount)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::vector<std::uint32_t> result(indices.begin(), indices.end());
+    const auto vertexCount = vertices.size();
+    const auto targetTriangleCount = targetIndexCount / 3;
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (std::size_t i = 0; i < result.size(); i += 3)
+    {
+        const glm::dvec3 p0(vertices[result[i]].position);
+        const glm::dvec3 p1(vertices[result[i + 1]].position);
+        const glm::dvec3 p2(vertices[result[i + 2]].position);
+        const auto normal = TriangleNormal(p0, p1, p2);
+        const auto length = glm::length(normal);
+        if (length == 0.0)
+        {
+            continue;
+        }
+        const auto unitNormal = normal / length;
+        const auto quadric = Quadric::FromPlane(unitNormal, -glm::dot(unitNormal, p0), length * 0.5);
+        quadrics[result[i]] += quadric;
+        quadrics[result[i + 1]] += quadric;
+        quadrics[result[i + 2]] += quadric;
+    }
+    const auto isLocked = FindLockedVertices(result, vertexCount);
+
+    Adjacency adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<std::uint32_t> remap(vertexCount);
+    std::vector<bool> isTouched(vertexCount);
+    //Each pass does the cheapest collapses not touching the same triangles, so they can be checked independently
+    while (result.size() / 3 > targetTriangleCount)
+    {
+        adjacency.Build(result, vertexCount);
+        collapses.clear();
+        for (std::size_t i = 0; i < result.size(); i += 3)
+        {
+            for (std::size_t edge = 0; edge < 3; edge++)
+            {
+                const auto a = result[i + edge];
+                const auto b = result[i + (edge + 1) % 3];
+                auto edgeQuadric = quadrics[a];
+                edgeQuadric += quadrics[b];
+                if (!isLocked[a])
+                {
+                    collapses.push_back({a, b, edgeQuadric.Evaluate(glm::dvec3(vertices[b].position))});
+                }
+                if (!isLocked[b])
+                {
+                    collapses.push_back({b, a, edgeQuadric.Evaluate(glm::dvec3(vertices[a].position))});
+                }
+            }
+        }
+        std::ranges::sort(collapses, [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+        isTouched.assign(vertexCount, false);
+        for (std::uint32_t v = 0; v < vertexCount; v++)
+        {
+            remap[v] = v;
+        }
+        auto triangleCount = result.size() / 3;
+        std::size_t collapseCount = 0;
+        for (const auto& collapse : collapses)
+        {
+            if (triangleCount <= targetTriangleCount)
+            {
+                break;
+            }
+            if (isTouched[collapse.from] || isTouched[collapse.to] ||
+                IsFlipping(collapse, result, vertices, adjacency))
+            {
+                continue;
+            }
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            for (const auto triangle : adjacency.GetTriangles(collapse.from))
+            {
+                const auto* corners = &result[triangle * 3];
+                if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+                {
+                    triangleCount--;
+                }
+                isTouched[corners[0]] = true;
+                isTouched[corners[1]] = true;
+                isTouched[corners[2]] = true;
+            }
+            collapseCount++;
+        }
+        if (collapseCount == 0)
+        {
+            break;
+        }
+
+        std::size_t writeIndex = 0;
+        for (std::size_t i = 0; i < result.size(); i += 3)
+        {
+            const auto v0 = remap[result[i]];
+            const auto v1 = remap[result[i + 1]];
+            const auto v2 = remap[result[i + 2]];
+            if (v0 == v1 || v1 == v2 || v2 == v0)
+            {
+                continue;
+            }
+            result[writeIndex++] = v0;
+            result[writeIndex++] = v1;
+            result[writeIndex++] = v2;
+        }
+        result.resize(writeIndex);
+    }
+    return result;
+}
+
+std::vector<std::vector<std::uint32_t>> GenerateLodChain(std::span<const std::uint32_t> indices,
+                                                         std::span<const MeshFileVertex> vertices,
+                                                         std::size_t lodCount, float reduction)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::vector<std::vector<std::uint32_t>> lods;
+    lods.reserve(lodCount);
+    auto previous = indices;
+    for (std::size_t lod = 1; lod < lodCount; lod++)
+    {
+        const auto targetIndexCount = static_cast<std::size_t>(
+                static_cast<float>(previous.size() / 3) * reduction) * 3;
+        auto lodIndices = SimplifyMesh(previous, vertices, targetIndexCount);
+        if (lodIndices.empty() ||
+            static_cast<float>(lodIndices.size()) > static_cast<float>(previous.size()) * (1.0f - MIN_LOD_REDUCTION))
+        {
+            break;
+        }
+        OptimizeVertexCache(lodIndices, vertices.size());
+        lods.push_back(std::move(lodIndices));
+        previous = lods.back();
+    }
+    return lods;
+}
+}
@@ -0,0 +1,57 @@
+#include "radix_sort.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+void RadixSort(std::span<SortItem> items, std::span<SortItem> scratch)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    assert(scratch.size() >= items.size());
+    constexpr std::size_t byteNmb = sizeof(std::uint64_t);
+    constexpr std::size_t bucketNmb = 256;
+    //All the histograms are built in a single read of the keys
+    std::array<std::array<std::size_t, bucketNmb>, byteNmb> histograms{};
+    for (const auto& item : items)
+    {
+        for (std::size_t byte = 0; byte < byteNmb; byte++)
+        {
+            histograms[byte][(item.key >> (byte * 8)) & 0xFFu]++;
+        }
+    }
+
+    auto source = items;
+    auto destination = scratch.first(items.size());
+    for (std::size_t byte = 0; byte < byteNmb; byte++)
+    {
+        auto& histogram = histograms[byte];
+        const auto firstKeyBucket = items.empty() ? 0 : (source.front().key >> (byte * 8)) & 0xFFu;
+        if (histogram[firstKeyBucket] == items.size())
+            continue;
+        std::size_t offset = 0;
+        for (auto& count : histogram)
+        {
+            const auto bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const auto& item : source)
+        {
+            destination[histogram[(item.key >> (byte * 8)) & 0xFFu]++] = item;
+        }
+        std::swap(source, destination);
+    }
+    if (source.data() != items.data())
+    {
+        std::copy(source.begin(), source.end(), items.begin());
+    }
+}
+}
@@ -0,0 +1,471 @@
+#include "texture_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef TRACY_ENABLE
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace core
+{
+namespace
+{
+using Color = std::array<float, 3>;
+using Rgb565Palette = std::array<std::array<int, 3>, 4>;
+
+constexpr int POWER_ITERATION_COUNT = 8;
+
+std::uint16_t ToRgb565(const Color& color)
+{
+    const auto quantize = [](float value, int maxValue)
+    {
+        return static_cast<std::uint16_t>(std::clamp(
+                static_cast<int>(std::lround(value / 255.0f * static_cast<float>(maxValue))), 0, maxValue));
+    };
+    return static_cast<std::uint16_t>(quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 |
+                                      quantize(color[2], 31));
+}
+
+std::array<int, 3> FromRgb565(std::uint16_t color)
+{
+    const int r = color >> 11 & 31;
+    const int g = color >> 5 & 63;
+    const int b = color & 31;
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+/**
+ * \brief Palette as the decoders expand it, in 4-color mode if color0 > color1 and 3-color mode otherwise
+ */
+Rgb565Palette Bc1Palette(std::uint16_t color0, std::uint16_t color1)
+{
+    Rgb565Palette palette{};
+    palette[0] = FromRgb565(color0);
+    palette[1] = FromRgb565(color1);
+    for (std::size_t channel = 0; channel < 3; channel++)
+    {
+        if (color0 > color1)
+        {
+            palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+            palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+        }
+        else
+        {
+            palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+            palette[3][channel] = 0;
+        }
+    }
+    return palette;
+}
+
+struct Bc1Encoding
+{
+    std::array<std::uint8_t, 8> bytes{};
+    std::array<std::uint8_t, BLOCK_TEXEL_COUNT> indices{};
+    int error = std::numeric_limits<int>::max();
+};
+
+Bc1Encoding EncodeBc1Endpoints(const std::array<Color, BLOCK_TEXEL_COUNT>& colors, const Color& endpoint0,
+                               const Color& endpoint1)
+{
+    auto color0 = ToRgb565(endpoint0);
+    auto color1 = ToRgb565(endpoint1);
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+    //Equal endpoints would be read in 3-color mode, only the first entry is used then
+    const std::size_t paletteSize = color0 == color1 ? 1 : 4;
+    const auto palette = Bc1Palette(color0, color1);
+
+    Bc1Encoding encoding;
+    encoding.error = 0;
+    std::uint32_t indexBits = 0;
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        int bestError = std::numeric_limits<int>::max();
+        std::uint8_t bestIndex = 0;
+        for (std::size_t index = 0; index < paletteSize; index++)
+        {
+            int error = 0;
+            for (std::size_t channel = 0; channel < 3; channel++)
+            {
+                const int difference = palette[index][channel] - static_cast<int>(colors[texel][channel]);
+                error += difference * difference;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                bestIndex = static_cast<std::uint8_t>(index);
+            }
+        }
+        encoding.error += bestError;
+        encoding.indices[texel] = bestIndex;
+        indexBits |= static_cast<std::uint32_t>(bestIndex) << (2 * texel);
+    }
+    encoding.bytes = {static_cast<std::uint8_t>(color0 & 0xFF), static_cast<std::uint8_t>(color0 >> 8),
+                      static_cast<std::uint8_t>(color1 & 0xFF), static_cast<std::uint8_t>(color1 >> 8),
+                      static_cast<std::uint8_t>(indexBits & 0xFF), static_cast<std::uint8_t>(indexBits >> 8 & 0xFF),
+                      static_cast<std::uint8_t>(indexBits >> 16 & 0xFF), static_cast<std::uint8_t>(indexBits >> 24)};
+    return encoding;
+}
+
+/**
+ * \brief Unit direction of the largest variance of the colors, by power iteration on their covariance
+ */
+Color PrincipalAxis(const std::array<Color, BLOCK_TEXEL_COUNT>& colors, const Color& mean)
+{
+    std::array<float, 6> covariance{};
+    for (const auto& color : colors)
+    {
+        const float r = color[0] - mean[0];
+        const float g = color[1] - mean[1];
+        const float b = color[2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+    //Starting from the row of the largest variance avoids an axis orthogonal to the principal one,
+    //as (1, 1, 1) is for anti-correlated channels
+    Color axis = {covariance[0], covariance[1], covariance[2]};
+    if (covariance[3] > covariance[0] && covariance[3] >= covariance[5])
+    {
+        axis = {covariance[1], covariance[3], covariance[4]};
+    }
+    else if (covariance[5] > covariance[0] && covariance[5] > covariance[3])
+    {
+        axis = {covariance[2], covariance[4], covariance[5]};
+    }
+    for (int iteration = 0; iteration < POWER_ITERATION_COUNT; iteration++)
+    {
+        const Color next = {
+                covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]};
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < std::numeric_limits<float>::epsilon())
+        {
+            break;
+        }
+        axis = {next[0] / length, next[1] / length, next[2] / length};
+    }
+    return axis;
+}
+
+/**
+ * \brief Endpoints minimizing the squared error of the colors for the interpolation weights of the indices
+ */
+bool SolveBc1Endpoints(const std::array<Color, BLOCK_TEXEL_COUNT>& colors,
+                       const std::array<std::uint8_t, BLOCK_TEXEL_COUNT>& indices,
+                       Color& endpoint0, Color& endpoint1)
+{
+    constexpr std::array<float, 4> weights = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    float a = 0.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    Color rhs0{};
+    Color rhs1{};
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        const float weight = weights[indices[texel]];
+        a += weight * weight;
+        b += (1.0f - weight) * (1.0f - weight);
+        c += weight * (1.0f - weight);
+        for (std::size_t channel = 0; channel < 3; channel++)
+        {
+            rhs0[channel] += weight * colors[texel][channel];
+            rhs1[channel] += (1.0f - weight) * colors[texel][channel];
+        }
+    }
+    const float determinant = a * b - c * c;
+    if (std::abs(determinant) < std::numeric_limits<float>::epsilon())
+    {
+        return false;
+    }
+    for (std::size_t channel = 0; channel < 3; channel++)
+    {
+        endpoint0[channel] = std::clamp((b * rhs0[channel] - c * rhs1[channel]) / determinant, 0.0f, 255.0f);
+        endpoint1[channel] = std::clamp((a * rhs1[channel] - c * rhs0[channel]) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+std::array<std::uint8_t, BLOCK_TEXEL_COUNT> GetChannel(const ColorBlock& block, std::size_t channel)
+{
+    std::array<std::uint8_t, BLOCK_TEXEL_COUNT> values{};
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        values[texel] = block[texel * 4 + channel];
+    }
+    return values;
+}
+
+float SrgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSrgb(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+}
+
+std::size_t GetBlockByteSize(BlockFormat format)
+{
+    switch (format)
+    {
+        case BlockFormat::BC1:
+        case BlockFormat::BC4:
+            return 8;
+        case BlockFormat::BC3:
+        case BlockFormat::BC5:
+            return 16;
+    }
+    return 0;
+}
+
+std::array<std::uint8_t, 8> EncodeBc1Block(const ColorBlock& block)
+{
+    std::array<Color, BLOCK_TEXEL_COUNT> colors{};
+    Color mean{};
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        for (std::size_t channel = 0; channel < 3; channel++)
+        {
+            colors[texel][channel] = static_cast<float>(block[texel * 4 + channel]);
+            mean[channel] += colors[texel][channel] / static_cast<float>(BLOCK_TEXEL_COUNT);
+        }
+    }
+    const auto axis = PrincipalAxis(colors, mean);
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = std::numeric_limits<float>::lowest();
+    for (const auto& color : colors)
+    {
+        const float projection = (color[0] - mean[0]) * axis[0] + (color[1] - mean[1]) * axis[1] +
+                                 (color[2] - mean[2]) * axis[2];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    Color endpoint0{};
+    Color endpoint1{};
+    for (std::size_t channel = 0; channel < 3; channel++)
+    {
+        endpoint0[channel] = std::clamp(mean[channel] + axis[channel] * maxProjection, 0.0f, 255.0f);
+        endpoint1[channel] = std::clamp(mean[channel] + axis[channel] * minProjection, 0.0f, 255.0f);
+    }
+    auto encoding = EncodeBc1Endpoints(colors, endpoint0, endpoint1);
+
+    //The extremes are rarely the best endpoints once the texels are snapped to the palette
+    if (encoding.error > 0 && SolveBc1Endpoints(colors, encoding.indices, endpoint0, endpoint1))
+    {
+        const auto refined = EncodeBc1Endpoints(colors, endpoint0, endpoint1);
+        if (refined.error < encoding.error)
+        {
+            encoding = refined;
+        }
+    }
+    return encoding.bytes;
+}
+
+std::array<std::uint8_t, 8> EncodeBc4Block(const std::array<std::uint8_t, BLOCK_TEXEL_COUNT>& values)
+{
+    const auto [minIt, maxIt] = std::ranges::minmax_element(values);
+    const int value0 = *maxIt;
+    const int value1 = *minIt;
+    std::array<int, 8> palette{};
+    palette[0] = value0;
+    palette[1] = value1;
+    for (int i = 1; i < 7; i++)
+    {
+        palette[i + 1] = ((7 - i) * value0 + i * value1) / 7;
+    }
+    //Equal endpoints would be read in 6-value mode, only the first entry is used then
+    const std::size_t paletteSize = value0 == value1 ? 1 : 8;
+
+    std::uint64_t indexBits = 0;
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        int bestError = std::numeric_limits<int>::max();
+        std::uint64_t bestIndex = 0;
+        for (std::size_t index = 0; index < paletteSize; index++)
+        {
+            const int error = std::abs(palette[index] - static_cast<int>(values[texel]));
+            if (error < bestError)
+            {
+                bestError = error;
+                bestIndex = index;
+            }
+        }
+        indexBits |= bestIndex << (3 * texel);
+    }
+    std::array<std::uint8_t, 8> bytes{};
+    bytes[0] = static_cast<std::uint8_t>(value0);
+    bytes[1] = static_cast<std::uint8_t>(value1);
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        bytes[2 + i] = static_cast<std::uint8_t>(indexBits >> (8 * i) & 0xFF);
+    }
+    return bytes;
+}
+
+ColorBlock DecodeBc1Block(std::span<const std::uint8_t, 8> block)
+{
+    const auto color0 = static_cast<std::uint16_t>(block[0] | block[1] << 8);
+    const auto color1 = static_cast<std::uint16_t>(block[2] | block[3] << 8);
+    const auto palette = Bc1Palette(color0, color1);
+    const std::uint32_t indexBits = block[4] | block[5] << 8 | block[6] << 16 | static_cast<std::uint32_t>(block[7]) << 24;
+    ColorBlock decoded{};
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        const auto index = indexBits >> (2 * texel) & 3;
+        for (std::size_t channel = 0; channel < 3; channel++)
+        {
+            decoded[texel * 4 + channel] = static_cast<std::uint8_t>(palette[index][channel]);
+        }
+        const bool isTransparent = color0 <= color1 && index == 3;
+        decoded[texel * 4 + 3] = isTransparent ? 0 : 255;
+    }
+    return decoded;
+}
+
+std::array<std::uint8_t, BLOCK_TEXEL_COUNT> DecodeBc4Block(std::span<const std::uint8_t, 8> block)
+{
+    const int value0 = block[0];
+    const int value1 = block[1];
+    std::array<int, 8> palette{value0, value1};
+    if (value0 > value1)
+    {
+        for (int i = 2; i < 8; i++)
+        {
+            palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7;
+        }
+    }
+    else
+    {
+        for (int i = 2; i < 6; i++)
+        {
+            palette[i] = ((6 - i) * value0 + (i - 1) * value1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    std::uint64_t indexBits = 0;
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        indexBits |= static_cast<std::uint64_t>(block[2 + i]) << (8 * i);
+    }
+    std::array<std::uint8_t, BLOCK_TEXEL_COUNT> decoded{};
+    for (std::size_t texel = 0; texel < BLOCK_TEXEL_COUNT; texel++)
+    {
+        decoded[texel] = static_cast<std::uint8_t>(palette[indexBits >> (3 * texel) & 7]);
+    }
+    return decoded;
+}
+
+std::vector<std::uint8_t> CompressImage(std::span<const std::uint8_t> rgba, int width, int height,
+                                        BlockFormat format)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto blockCountX = (static_cast<std::size_t>(width) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const auto blockCountY = (static_cast<std::size_t>(height) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const auto blockByteSize = GetBlockByteSize(format);
+    std::vector<std::uint8_t> compressed(blockCountX * blockCountY * blockByteSize);
+    auto* output = compressed.data();
+    for (std::size_t blockY = 0; blockY < blockCountY; blockY++)
+    {
+        for (std::size_t blockX = 0; blockX < blockCountX; blockX++)
+        {
+            ColorBlock block{};
+            for (std::size_t y = 0; y < BLOCK_SIZE; y++)
+            {
+                const auto imageY = std::min(blockY * BLOCK_SIZE + y, static_cast<std::size_t>(height) - 1);
+                for (std::size_t x = 0; x < BLOCK_SIZE; x++)
+                {
+                    const auto imageX = std::min(blockX * BLOCK_SIZE + x, static_cast<std::size_t>(width) - 1);
+                    const auto* texel = &rgba[(imageY * width + imageX) * 4];
+                    std::copy(texel, texel + 4, &block[(y * BLOCK_SIZE + x) * 4]);
+                }
+            }
+            std::array<std::uint8_t, 8> first{};
+            std::array<std::uint8_t, 8> second{};
+            switch (format)
+            {
+                case BlockFormat::BC1:
+                    first = EncodeBc1Block(block);
+                    break;
+                case BlockFormat::BC3:
+                    first = EncodeBc4Block(GetChannel(block, 3));
+                    second = EncodeBc1Block(block);
+                    break;
+                case BlockFormat::BC4:
+                    first = EncodeBc4Block(GetChannel(block, 0));
+                    break;
+                case BlockFormat::BC5:
+                    first = EncodeBc4Block(GetChannel(block, 0));
+                    second = EncodeBc4Block(GetChannel(block, 1));
+                    break;
+            }
+            output = std::copy(first.begin(), first.end(), output);
+            if (blockByteSize > first.size())
+            {
+                output = std::copy(second.begin(), second.end(), output);
+            }
+        }
+    }
+    return compressed;
+}
+
+std::vector<std::uint8_t> DownsampleImage(std::span<const std::uint8_t> rgba, int width, int height, bool srgb)
+{
+    const int mipWidth = std::max(width / 2, 1);
+    const int mipHeight = std::max(height / 2, 1);
+    std::array<float, 256> toLinear{};
+    for (std::size_t value = 0; value < toLinear.size(); value++)
+    {
+        const float normalized = static_cast<float>(value) / 255.0f;
+        toLinear[value] = srgb ? SrgbToLinear(normalized) : normalized;
+    }
+
+    std::vector<std::uint8_t> mip(static_cast<std::size_t>(mipWidth) * mipHeight * 4);
+    for (int y = 0; y < mipHeight; y++)
+    {
+        for (int x = 0; x < mipWidth; x++)
+        {
+            std::array<float, 4> sum{};
+            for (int dy = 0; dy < 2; dy++)
+            {
+                const int sourceY = std::min(2 * y + dy, height - 1);
+                for (int dx = 0; dx < 2; dx++)
+                {
+                    const int sourceX = std::min(2 * x + dx, width - 1);
+                    const auto* texel = &rgba[(static_cast<std::size_t>(sourceY) * width + sourceX) * 4];
+                    for (std::size_t channel = 0; channel < 3; channel++)
+                    {
+                        sum[channel] += toLinear[texel[channel]];
+                    }
+                    sum[3] += static_cast<float>(texel[3]) / 255.0f;
+                }
+            }
+            auto* texel = &mip[(static_cast<std::size_t>(y) * mipWidth + x) * 4];
+            for (std::size_t channel = 0; channel < 4; channel++)
+            {
+                float value = sum[channel] / 4.0f;
+                if (srgb && channel < 3)
+                {
+                    value = LinearToSrgb(value);
+                }
+                texel[channel] = static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+            }
+        }
+    }
+    return mip;
+}
+}
@@ -0,0 +1,130 @@
+#include "vertex_quantization.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace core
+{
+namespace
+{
+std::int16_t ToSnorm16(float value)
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+std::uint16_t ToUnorm16(float value)
+{
+    return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+float SignNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+}
+
+std::uint16_t FloatToHalf(float value)
+{
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    const auto exponent = static_cast<std::int32_t>((bits >> 23) & 0xffu);
+    auto mantissa = bits & 0x7fffffu;
+    if (exponent == 0xff)
+    {
+        //Infinity stays infinity and NaN stays a quiet NaN
+        return static_cast<std::uint16_t>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u));
+    }
+    const auto halfExponent = exponent - 127 + 15;
+    if (halfExponent >= 31)
+    {
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+    if (halfExponent <= 0)
+    {
+        //Denormal half, the implicit bit of the float becomes explicit
+        if (halfExponent < -10)
+        {
+            return sign;
+        }
+        mantissa |= 0x800000u;
+        const auto shift = static_cast<std::uint32_t>(14 - halfExponent);
+        auto half = mantissa >> shift;
+        const auto roundBit = 1u << (shift - 1);
+        if ((mantissa & roundBit) != 0 && ((mantissa & (roundBit - 1)) != 0 || (half & 1u) != 0))
+        {
+            half++;
+        }
+        return static_cast<std::uint16_t>(sign | half);
+    }
+    auto half = (static_cast<std::uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    //A carry out of the mantissa increments the exponent, up to infinity
+    if ((mantissa & 0x1000u) != 0 && ((mantissa & 0xfffu) != 0 || (half & 1u) != 0))
+    {
+        half++;
+    }
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+float HalfToFloat(std::uint16_t value)
+{
+    const auto sign = static_cast<std::uint32_t>(value & 0x8000u) << 16;
+    const auto exponent = (value >> 10) & 0x1fu;
+    const auto mantissa = value & 0x3ffu;
+    if (exponent == 0)
+    {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1f)
+    {
+        return std::bit_cast<float>(sign | 0x7f800000u | (static_cast<std::uint32_t>(mantissa) << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent - 15 + 127) << 23) | (static_cast<std::uint32_t>(mantissa) << 13));
+}
+
+std::array<std::int16_t, 2> EncodeOctahedral(glm::vec3 direction)
+{
+    const float norm = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (norm == 0.0f)
+    {
+        return {0, 0};
+    }
+    float x = direction.x / norm;
+    float y = direction.y / norm;
+    if (direction.z < 0.0f)
+    {
+        //The lower hemisphere is folded over the diagonals of the upper one
+        const float foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+        const float foldedY = (1.0f - std::abs(x)) * SignNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+    return {ToSnorm16(x), ToSnorm16(y)};
+}
+
+glm::vec3 DecodeOctahedral(std::array<std::int16_t, 2> encoded)
+{
+    const float x = std::max(static_cast<float>(encoded[0]) / 32767.0f, -1.0f);
+    const float y = std::max(static_cast<float>(encoded[1]) / 32767.0f, -1.0f);
+    glm::vec3 direction(x, y, 1.0f - std::abs(x) - std::abs(y));
+    const float t = std::max(-direction.z, 0.0f);
+    direction.x += direction.x >= 0.0f ? -t : t;
+    direction.y += direction.y >= 0.0f ? -t : t;
+    return direction / std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+}
+
+QuantizedVertex QuantizeVertex(const MeshFileVertex& vertex, glm::vec3 boundsMin, glm::vec3 boundsMax)
+{
+    QuantizedVertex quantizedVertex;
+    for (int i = 0; i < 3; i++)
+    {
+        const float extent = boundsMax[i] - boundsMin[i];
+        quantizedVertex.position[i] = extent > 0.0f ? ToUnorm16((vertex.position[i] - boundsMin[i]) / extent) : 0;
+    }
+    quantizedVertex.normal = EncodeOctahedral(vertex.normal);
+    quantizedVertex.tangent = EncodeOctahedral(vertex.tangent);
+    quantizedVertex.texCoords = {FloatToHalf(vertex.texCoords.x), FloatToHalf(vertex.texCoords.y)};
+    return quantizedVertex;
+}
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <asteroid_simulation.h>
+
+#include <cmath>
+
+namespace
+{
+glm::vec3 ReferenceUpdate(glm::vec3 position, float gravityMass, float dt)
+{
+    const auto deltaToCenter = -position;
+    const float r = std::sqrt(deltaToCenter.x * deltaToCenter.x +
+                              deltaToCenter.y * deltaToCenter.y +
+                              deltaToCenter.z * deltaToCenter.z);
+    const float force = gravityMass / (r * r);
+    glm::vec3 velDir(-deltaToCenter.z, 0.0f, deltaToCenter.x);
+    velDir /= std::sqrt(velDir.x * velDir.x + velDir.z * velDir.z);
+    const float speed = std::sqrt(force * r);
+    return position + velDir * speed * dt;
+}
+}
+
+TEST(AsteroidSimulation, MatchesReferenceIntegration)
+{
+    constexpr std::size_t count = 1'003;
+    constexpr float dt = 0.016f;
+    core::AsteroidSimulation simulation;
+    simulation.Resize(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const float angle = static_cast<float>(i) * 0.37f;
+        const float radius = 100.0f + static_cast<float>(i % 100);
+        simulation.SetPosition(i, glm::vec3(std::cos(angle) * radius, 0.0f, std::sin(angle) * radius));
+    }
+    std::vector<glm::vec3> expected(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        expected[i] = ReferenceUpdate(simulation.GetPosition(i),
+                                      simulation.gravityConst * simulation.centerMass, dt);
+    }
+    simulation.Update(dt, 0, count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const auto position = simulation.GetPosition(i);
+        EXPECT_NEAR(position.x, expected[i].x, 1e-3f);
+        EXPECT_NEAR(position.y, expected[i].y, 1e-3f);
+        EXPECT_NEAR(position.z, expected[i].z, 1e-3f);
+    }
+}
+
+TEST(AsteroidSimulation, UpdateOnlyTouchesRange)
+{
+    core::AsteroidSimulation simulation;
+    simulation.Resize(16);
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        simulation.SetPosition(i, glm::vec3(100.0f, 0.0f, 10.0f * static_cast<float>(i + 1)));
+    }
+    simulation.Update(1.0f, 3, 9);
+    EXPECT_EQ(simulation.GetPosition(2), glm::vec3(100.0f, 0.0f, 30.0f));
+    EXPECT_NE(simulation.GetPosition(3), glm::vec3(100.0f, 0.0f, 40.0f));
+    EXPECT_NE(simulation.GetPosition(8), glm::vec3(100.0f, 0.0f, 90.0f));
+    EXPECT_EQ(simulation.GetPosition(9), glm::vec3(100.0f, 0.0f, 100.0f));
+
+    std::vector<glm::vec3> positions(6);
+    simulation.CopyPositions(positions.data(), 3, 9);
+    for (std::size_t i = 0; i < positions.size(); i++)
+    {
+        EXPECT_EQ(positions[i], simulation.GetPosition(i + 3));
+    }
+}
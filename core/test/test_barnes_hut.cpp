@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <barnes_hut.h>
+#include <jobsystem.h>
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+struct Bodies
+{
+    std::vector<glm::vec3> positions;
+    std::vector<float> masses;
+};
+
+Bodies GenerateBodies(std::size_t count)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> massDistribution(0.5f, 2.0f);
+    Bodies bodies;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        bodies.positions.emplace_back(positionDistribution(generator),
+                                      positionDistribution(generator),
+                                      positionDistribution(generator));
+        bodies.masses.push_back(massDistribution(generator));
+    }
+    return bodies;
+}
+
+glm::vec3 BruteForceAcceleration(const Bodies& bodies, std::size_t index, const core::BarnesHutTree& tree)
+{
+    glm::vec3 acceleration(0.0f);
+    for (std::size_t j = 0; j < bodies.positions.size(); j++)
+    {
+        if (j == index)
+            continue;
+        const glm::vec3 delta = bodies.positions[j] - bodies.positions[index];
+        const float distanceSqr = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z +
+                                  tree.softening * tree.softening;
+        const float invDistance = 1.0f / std::sqrt(distanceSqr);
+        acceleration += delta * (bodies.masses[j] * invDistance * invDistance * invDistance);
+    }
+    return acceleration * tree.gravityConst;
+}
+
+float Length(glm::vec3 v)
+{
+    return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+}
+
+TEST(BarnesHut, ZeroThetaMatchesBruteForce)
+{
+    const auto bodies = GenerateBodies(300);
+    core::BarnesHutTree tree;
+    tree.theta = 0.0f;
+    tree.Build(bodies.positions, bodies.masses);
+    std::vector<glm::vec3> accelerations(bodies.positions.size());
+    tree.ComputeAccelerations(accelerations, 0, bodies.positions.size());
+    for (std::size_t i = 0; i < bodies.positions.size(); i++)
+    {
+        const auto expected = BruteForceAcceleration(bodies, i, tree);
+        EXPECT_NEAR(Length(accelerations[i] - expected), 0.0f, 1e-4f * Length(expected));
+    }
+}
+
+TEST(BarnesHut, ApproximationStaysClose)
+{
+    const auto bodies = GenerateBodies(2'000);
+    core::BarnesHutTree tree;
+    tree.theta = 0.5f;
+    tree.Build(bodies.positions, bodies.masses);
+    std::vector<glm::vec3> accelerations(bodies.positions.size());
+    tree.ComputeAccelerations(accelerations, 0, bodies.positions.size());
+    float errorSum = 0.0f;
+    for (std::size_t i = 0; i < bodies.positions.size(); i++)
+    {
+        const auto expected = BruteForceAcceleration(bodies, i, tree);
+        errorSum += Length(accelerations[i] - expected) / Length(expected);
+    }
+    EXPECT_LT(errorSum / static_cast<float>(bodies.positions.size()), 0.01f);
+}
+
+TEST(BarnesHut, RootMassIsTotalMass)
+{
+    const auto bodies = GenerateBodies(1'000);
+    core::BarnesHutTree tree;
+    tree.Build(bodies.positions, bodies.masses);
+    float totalMass = 0.0f;
+    for (const auto mass : bodies.masses)
+    {
+        totalMass += mass;
+    }
+    ASSERT_FALSE(tree.GetNodes().empty());
+    EXPECT_NEAR(tree.GetNodes()[0].mass, totalMass, 1e-3f * totalMass);
+    EXPECT_EQ(tree.GetBodyCount(), bodies.positions.size());
+}
+
+TEST(BarnesHut, CoincidentBodiesStopAtMaxDepth)
+{
+    Bodies bodies;
+    bodies.positions.assign(100, glm::vec3(1.0f, 2.0f, 3.0f));
+    bodies.positions.emplace_back(10.0f, 0.0f, 0.0f);
+    bodies.masses.assign(bodies.positions.size(), 1.0f);
+    core::BarnesHutTree tree;
+    tree.Build(bodies.positions, bodies.masses);
+    const auto acceleration = tree.ComputeAcceleration(bodies.positions.back(), bodies.positions.size() - 1);
+    EXPECT_LT(acceleration.x, 0.0f);
+}
+
+TEST(BarnesHut, ThreadedMatchesSerial)
+{
+    const auto bodies = GenerateBodies(20'000);
+    core::BarnesHutTree serialTree;
+    serialTree.Build(bodies.positions, bodies.masses);
+    std::vector<glm::vec3> serialAccelerations(bodies.positions.size());
+    serialTree.ComputeAccelerations(serialAccelerations, 0, bodies.positions.size());
+
+    core::WorkerQueue queue;
+    std::vector<std::unique_ptr<core::WorkerThread>> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.push_back(std::make_unique<core::WorkerThread>(queue));
+        threads.back()->Start();
+    }
+    core::BarnesHutTree threadedTree;
+    threadedTree.Build(bodies.positions, bodies.masses, queue);
+    std::vector<glm::vec3> threadedAccelerations(bodies.positions.size());
+    threadedTree.ComputeAccelerations(threadedAccelerations, queue, 1'000);
+    queue.Destroy();
+    for (auto& thread : threads)
+    {
+        thread->Destroy();
+    }
+
+    ASSERT_EQ(serialTree.GetNodes().size(), threadedTree.GetNodes().size());
+    for (std::size_t i = 0; i < bodies.positions.size(); i++)
+    {
+        EXPECT_FLOAT_EQ(serialAccelerations[i].x, threadedAccelerations[i].x);
+        EXPECT_FLOAT_EQ(serialAccelerations[i].y, threadedAccelerations[i].y);
+        EXPECT_FLOAT_EQ(serialAccelerations[i].z, threadedAccelerations[i].z);
+    }
+}
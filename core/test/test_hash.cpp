@@ -0,0 +1,22 @@
+#include <gtest/gtest.h>
+#include <hash.h>
+
+#include <string>
+
+TEST(Hash, KnownValues)
+{
+    static_assert(core::HashFnv1a("") == core::FNV_OFFSET_BASIS);
+    static_assert(core::HashFnv1a("a") == 0xaf63dc4c8601ec8cull);
+    EXPECT_EQ(core::HashFnv1a("foobar"), 0x85944171f73967e8ull);
+}
+
+TEST(Hash, ViewIsNotReadPastItsLength)
+{
+    const std::string uniforms = "viewPos";
+    EXPECT_EQ(core::HashFnv1a(std::string_view(uniforms).substr(0, 4)), core::HashFnv1a("view"));
+}
+
+TEST(Hash, Chaining)
+{
+    EXPECT_EQ(core::HashFnv1a("bar", core::HashFnv1a("foo")), core::HashFnv1a("foobar"));
+}
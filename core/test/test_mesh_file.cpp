@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <mesh_file.h>
+
+#include <cstring>
+
+namespace
+{
+core::MeshFileData MakeTriangleData()
+{
+    core::MeshFileData data;
+    data.AddTexture("diffuse.png", "texture_diffuse");
+    data.AddTexture("specular.png", "texture_specular");
+    data.materials.push_back({0, 2});
+    for (int i = 0; i < 3; i++)
+    {
+        core::MeshFileVertex vertex{};
+        vertex.position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+        data.vertices.push_back(vertex);
+        data.indices.push_back(static_cast<std::uint32_t>(i));
+    }
+    data.meshes.push_back({0, 3, 0, 3, 0});
+    return data;
+}
+
+/**
+ * \brief Copy in 4 bytes aligned storage like the mapping of the file
+ */
+std::vector<std::uint32_t> Align(const std::vector<std::byte>& file)
+{
+    std::vector<std::uint32_t> aligned((file.size() + 3) / 4);
+    std::memcpy(aligned.data(), file.data(), file.size());
+    return aligned;
+}
+
+std::span<const std::byte> AsBytes(const std::vector<std::uint32_t>& aligned, std::size_t size)
+{
+    return std::as_bytes(std::span(aligned)).first(size);
+}
+}
+
+TEST(MeshFile, RoundTrip)
+{
+    const auto file = core::WriteMeshFile(MakeTriangleData());
+    EXPECT_EQ(file.size() % 4, 0u);
+    const auto aligned = Align(file);
+    const auto view = core::ReadMeshFile(AsBytes(aligned, file.size()));
+    ASSERT_TRUE(view.has_value());
+    ASSERT_EQ(view->meshes.size(), 1u);
+    EXPECT_EQ(view->meshes[0].indexCount, 3u);
+    ASSERT_EQ(view->vertices.size(), 3u);
+    EXPECT_EQ(view->vertices[2].position.x, 2.0f);
+    ASSERT_EQ(view->textures.size(), 2u);
+    EXPECT_EQ(view->GetTexturePath(view->textures[1]), "specular.png");
+    EXPECT_EQ(view->GetTextureType(view->textures[0]), "texture_diffuse");
+}
+
+TEST(MeshFile, TruncatedFileIsRejected)
+{
+    const auto file = core::WriteMeshFile(MakeTriangleData());
+    const auto aligned = Align(file);
+    EXPECT_FALSE(core::ReadMeshFile(AsBytes(aligned, file.size() - 4)).has_value());
+    EXPECT_FALSE(core::ReadMeshFile(AsBytes(aligned, sizeof(core::MeshFileHeader) - 1)).has_value());
+}
+
+TEST(MeshFile, WrongMagicIsRejected)
+{
+    auto file = core::WriteMeshFile(MakeTriangleData());
+    file[0] = std::byte{'X'};
+    const auto aligned = Align(file);
+    EXPECT_FALSE(core::ReadMeshFile(AsBytes(aligned, file.size())).has_value());
+}
+
+TEST(MeshFile, IndexOutOfItsMeshIsRejected)
+{
+    auto data = MakeTriangleData();
+    data.indices[1] = 3;
+    const auto file = core::WriteMeshFile(data);
+    const auto aligned = Align(file);
+    EXPECT_FALSE(core::ReadMeshFile(AsBytes(aligned, file.size())).has_value());
+}
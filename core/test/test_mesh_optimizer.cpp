@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <mesh_optimizer.h>
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+constexpr std::uint32_t GRID_SIZE = 32;
+
+/**
+ * \brief Grid of GRID_SIZE x GRID_SIZE quads with its triangles in a random order
+ */
+void MakeShuffledGrid(std::vector<core::MeshFileVertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+    for (std::uint32_t y = 0; y <= GRID_SIZE; y++)
+    {
+        for (std::uint32_t x = 0; x <= GRID_SIZE; x++)
+        {
+            core::MeshFileVertex vertex{};
+            vertex.position = glm::vec3(static_cast<float>(x), static_cast<float>(y), 0.0f);
+            vertices.push_back(vertex);
+        }
+    }
+    std::vector<std::array<std::uint32_t, 3>> triangles;
+    for (std::uint32_t y = 0; y < GRID_SIZE; y++)
+    {
+        for (std::uint32_t x = 0; x < GRID_SIZE; x++)
+        {
+            const auto corner = y * (GRID_SIZE + 1) + x;
+            triangles.push_back({corner, corner + 1, corner + GRID_SIZE + 1});
+            triangles.push_back({corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1});
+        }
+    }
+    //Fixed permutation so the test does not depend on the standard library random engines
+    for (std::size_t i = 0; i < triangles.size(); i++)
+    {
+        std::swap(triangles[i], triangles[(i * 7919) % triangles.size()]);
+    }
+    for (const auto& triangle : triangles)
+    {
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    }
+}
+
+/**
+ * \brief Triangles as sorted vertex positions, to compare meshes whatever their order and vertex numbering
+ */
+std::vector<std::array<float, 6>> SortedTriangles(const std::vector<core::MeshFileVertex>& vertices,
+                                                  const std::vector<std::uint32_t>& indices)
+{
+    std::vector<std::array<float, 6>> triangles;
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<std::pair<float, float>, 3> corners{};
+        for (std::size_t j = 0; j < 3; j++)
+        {
+            const auto& position = vertices[indices[i + j]].position;
+            corners[j] = {position.x, position.y};
+        }
+        //Rotate the smallest corner first, which keeps the winding
+        std::ranges::rotate(corners, std::ranges::min_element(corners));
+        triangles.push_back({corners[0].first, corners[0].second, corners[1].first, corners[1].second,
+                             corners[2].first, corners[2].second});
+    }
+    std::ranges::sort(triangles);
+    return triangles;
+}
+}
+
+TEST(MeshOptimizer, AnalyzeSingleTriangle)
+{
+    //A single triangle loads each of its vertices once
+    const std::vector<std::uint32_t> indices = {0, 1, 2};
+    const auto statistics = core::AnalyzeVertexCache(indices, 3);
+    EXPECT_FLOAT_EQ(statistics.acmr, 3.0f);
+    EXPECT_FLOAT_EQ(statistics.atvr, 1.0f);
+}
+
+TEST(MeshOptimizer, VertexCacheImprovesAcmr)
+{
+    std::vector<core::MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeShuffledGrid(vertices, indices);
+    const auto before = core::AnalyzeVertexCache(indices, vertices.size());
+    const auto triangles = SortedTriangles(vertices, indices);
+
+    core::OptimizeVertexCache(indices, vertices.size());
+    const auto after = core::AnalyzeVertexCache(indices, vertices.size());
+    EXPECT_LT(after.acmr, before.acmr);
+    EXPECT_LT(after.acmr, 1.0f);
+    EXPECT_EQ(SortedTriangles(vertices, indices), triangles);
+}
+
+TEST(MeshOptimizer, OptimizeMeshKeepsTriangles)
+{
+    std::vector<core::MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeShuffledGrid(vertices, indices);
+    const auto triangles = SortedTriangles(vertices, indices);
+
+    const auto statistics = core::OptimizeMesh(vertices, indices);
+    EXPECT_LT(statistics.after.acmr, statistics.before.acmr);
+    EXPECT_LE(statistics.after.atvr, statistics.before.atvr);
+    EXPECT_EQ(SortedTriangles(vertices, indices), triangles);
+}
+
+TEST(MeshOptimizer, VertexFetchFollowsFirstUse)
+{
+    std::vector<std::uint32_t> indices = {3, 1, 3, 0};
+    std::vector<std::uint32_t> remap(5);
+    EXPECT_EQ(core::OptimizeVertexFetch(indices, remap), 3u);
+    EXPECT_EQ(indices, (std::vector<std::uint32_t>{0, 1, 0, 2}));
+    EXPECT_EQ(remap[2], ~0u);
+    EXPECT_EQ(remap[4], ~0u);
+
+    std::vector<int> vertices = {10, 11, 12, 13, 14};
+    core::RemapVertices(vertices, remap, 3);
+    EXPECT_EQ(vertices, (std::vector<int>{13, 11, 10}));
+}
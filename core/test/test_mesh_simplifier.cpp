@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <mesh_simplifier.h>
+
+#include <array>
+#include <map>
+#include <utility>
+
+#include <glm/geometric.hpp>
+
+namespace
+{
+constexpr std::uint32_t GRID_SIZE = 32;
+
+void MakeGrid(std::vector<core::MeshFileVertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+    for (std::uint32_t y = 0; y <= GRID_SIZE; y++)
+    {
+        for (std::uint32_t x = 0; x <= GRID_SIZE; x++)
+        {
+            core::MeshFileVertex vertex{};
+            vertex.position = glm::vec3(static_cast<float>(x), static_cast<float>(y), 0.0f);
+            vertices.push_back(vertex);
+        }
+    }
+    for (std::uint32_t y = 0; y < GRID_SIZE; y++)
+    {
+        for (std::uint32_t x = 0; x < GRID_SIZE; x++)
+        {
+            const auto corner = y * (GRID_SIZE + 1) + x;
+            indices.insert(indices.end(), {corner, corner + 1, corner + GRID_SIZE + 1});
+            indices.insert(indices.end(), {corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1});
+        }
+    }
+}
+
+/**
+ * \brief Closed sphere of radius 1 made by subdividing an octahedron, with no border or seam
+ */
+void MakeSphere(std::vector<core::MeshFileVertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+    const std::array<glm::vec3, 6> corners = {
+            glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+            glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+            glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)};
+    for (const auto& corner : corners)
+    {
+        core::MeshFileVertex vertex{};
+        vertex.position = corner;
+        vertices.push_back(vertex);
+    }
+    indices = {0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+               2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5};
+    for (int subdivision = 0; subdivision < 3; subdivision++)
+    {
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::uint32_t> middles;
+        const auto middle = [&vertices, &middles](std::uint32_t a, std::uint32_t b)
+        {
+            const auto key = std::minmax(a, b);
+            const auto it = middles.find(key);
+            if (it != middles.end())
+            {
+                return it->second;
+            }
+            core::MeshFileVertex vertex{};
+            vertex.position = glm::normalize(vertices[a].position + vertices[b].position);
+            vertices.push_back(vertex);
+            const auto index = static_cast<std::uint32_t>(vertices.size() - 1);
+            middles.emplace(key, index);
+            return index;
+        };
+        std::vector<std::uint32_t> subdivided;
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            const auto v0 = indices[i];
+            const auto v1 = indices[i + 1];
+            const auto v2 = indices[i + 2];
+            const auto m01 = middle(v0, v1);
+            const auto m12 = middle(v1, v2);
+            const auto m20 = middle(v2, v0);
+            subdivided.insert(subdivided.end(), {v0, m01, m20, m01, v1, m12, m20, m12, v2, m01, m12, m20});
+        }
+        indices = std::move(subdivided);
+    }
+}
+
+float SignedVolume(const std::vector<core::MeshFileVertex>& vertices, const std::vector<std::uint32_t>& indices)
+{
+    float volume = 0.0f;
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+    {
+        const auto& p0 = vertices[indices[i]].position;
+        const auto& p1 = vertices[indices[i + 1]].position;
+        const auto& p2 = vertices[indices[i + 2]].position;
+        volume += glm::dot(p0, glm::cross(p1, p2)) / 6.0f;
+    }
+    return volume;
+}
+}
+
+TEST(MeshSimplifier, FlatGridKeepsItsArea)
+{
+    std::vector<core::MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeGrid(vertices, indices);
+
+    const auto simplified = core::SimplifyMesh(indices, vertices, indices.size() / 4);
+    ASSERT_FALSE(simplified.empty());
+    EXPECT_LE(simplified.size(), indices.size() / 4);
+    //The border is locked and no triangle may fold over, so the simplified grid still covers the whole square
+    float area = 0.0f;
+    for (std::size_t i = 0; i < simplified.size(); i += 3)
+    {
+        const auto& p0 = vertices[simplified[i]].position;
+        const auto& p1 = vertices[simplified[i + 1]].position;
+        const auto& p2 = vertices[simplified[i + 2]].position;
+        const auto doubleArea = glm::cross(p1 - p0, p2 - p0).z;
+        EXPECT_GT(doubleArea, 0.0f);
+        area += doubleArea / 2.0f;
+    }
+    EXPECT_FLOAT_EQ(area, static_cast<float>(GRID_SIZE * GRID_SIZE));
+}
+
+TEST(MeshSimplifier, ClosedMeshKeepsItsVolume)
+{
+    std::vector<core::MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeSphere(vertices, indices);
+    const auto volume = SignedVolume(vertices, indices);
+
+    const auto simplified = core::SimplifyMesh(indices, vertices, indices.size() / 4);
+    EXPECT_LE(simplified.size(), indices.size() / 4);
+    EXPECT_GT(simplified.size(), 0u);
+    EXPECT_GT(SignedVolume(vertices, simplified), volume * 0.75f);
+}
+
+TEST(MeshSimplifier, LockedMeshIsUnchanged)
+{
+    //Every vertex of a lone triangle is on the border
+    std::vector<core::MeshFileVertex> vertices(3);
+    vertices[1].position = glm::vec3(1.0f, 0.0f, 0.0f);
+    vertices[2].position = glm::vec3(0.0f, 1.0f, 0.0f);
+    const std::vector<std::uint32_t> indices = {0, 1, 2};
+    EXPECT_EQ(core::SimplifyMesh(indices, vertices, 0), indices);
+    EXPECT_TRUE(core::GenerateLodChain(indices, vertices, 4).empty());
+}
+
+TEST(MeshSimplifier, LodChainDecreases)
+{
+    std::vector<core::MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeSphere(vertices, indices);
+
+    constexpr std::size_t lodCount = 4;
+    const auto lods = core::GenerateLodChain(indices, vertices, lodCount);
+    ASSERT_EQ(lods.size(), lodCount - 1);
+    auto previousSize = indices.size();
+    for (const auto& lod : lods)
+    {
+        EXPECT_LE(lod.size(), previousSize / 2);
+        EXPECT_EQ(lod.size() % 3, 0u);
+        for (const auto index : lod)
+        {
+            EXPECT_LT(index, vertices.size());
+        }
+        previousSize = lod.size();
+    }
+}
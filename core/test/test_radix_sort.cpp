@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <radix_sort.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(RadixSort, MatchesStableSort)
+{
+    std::mt19937_64 generator(0);
+    std::vector<core::SortItem> items(10'000);
+    for (std::uint32_t i = 0; i < items.size(); i++)
+    {
+        //Few distinct keys so the stability is exercised
+        items[i] = {generator() % 64 << 40 | generator() % 4, i};
+    }
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& a, const auto& b) { return a.key < b.key; });
+
+    std::vector<core::SortItem> scratch(items.size());
+    core::RadixSort(items, scratch);
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        EXPECT_EQ(items[i].key, expected[i].key);
+        EXPECT_EQ(items[i].index, expected[i].index);
+    }
+}
+
+TEST(RadixSort, SameKeysKeepTheirOrder)
+{
+    std::vector<core::SortItem> items = {{7, 0}, {7, 1}, {7, 2}};
+    std::vector<core::SortItem> scratch(items.size());
+    core::RadixSort(items, scratch);
+    for (std::uint32_t i = 0; i < items.size(); i++)
+    {
+        EXPECT_EQ(items[i].index, i);
+    }
+}
+
+TEST(RadixSort, Empty)
+{
+    std::vector<core::SortItem> items;
+    core::RadixSort(items, {});
+    EXPECT_TRUE(items.empty());
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <texture_compression.h>
+
+#include <cstdlib>
+
+namespace
+{
+std::vector<std::uint8_t> MakeGradient(int width, int height)
+{
+    std::vector<std::uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            auto* texel = &rgba[(static_cast<std::size_t>(y) * width + x) * 4];
+            texel[0] = static_cast<std::uint8_t>(x * 255 / (width - 1));
+            texel[1] = static_cast<std::uint8_t>(y * 255 / (height - 1));
+            texel[2] = static_cast<std::uint8_t>(128);
+            texel[3] = static_cast<std::uint8_t>(255 - x * 255 / (width - 1));
+        }
+    }
+    return rgba;
+}
+}
+
+TEST(TextureCompression, Bc1SolidColorIsExact)
+{
+    //A color exactly representable in 565
+    core::ColorBlock block{};
+    for (std::size_t texel = 0; texel < core::BLOCK_TEXEL_COUNT; texel++)
+    {
+        block[texel * 4] = 255;
+        block[texel * 4 + 1] = 0;
+        block[texel * 4 + 2] = 255;
+        block[texel * 4 + 3] = 255;
+    }
+    const auto encoded = core::EncodeBc1Block(block);
+    EXPECT_EQ(core::DecodeBc1Block(encoded), block);
+}
+
+TEST(TextureCompression, Bc1GradientIsClose)
+{
+    //Colors on a line, which the 4 colors of the palette approximate best
+    core::ColorBlock block{};
+    for (std::size_t texel = 0; texel < core::BLOCK_TEXEL_COUNT; texel++)
+    {
+        block[texel * 4] = static_cast<std::uint8_t>(texel * 16);
+        block[texel * 4 + 1] = static_cast<std::uint8_t>(255 - texel * 16);
+        block[texel * 4 + 2] = 64;
+        block[texel * 4 + 3] = 255;
+    }
+    const auto decoded = core::DecodeBc1Block(core::EncodeBc1Block(block));
+    for (std::size_t texel = 0; texel < core::BLOCK_TEXEL_COUNT; texel++)
+    {
+        for (std::size_t channel = 0; channel < 3; channel++)
+        {
+            //Half the step between two palette colors plus the 565 rounding
+            EXPECT_LE(std::abs(decoded[texel * 4 + channel] - block[texel * 4 + channel]), 48);
+        }
+        EXPECT_EQ(decoded[texel * 4 + 3], 255);
+    }
+}
+
+TEST(TextureCompression, Bc4KeepsItsExtremes)
+{
+    std::array<std::uint8_t, core::BLOCK_TEXEL_COUNT> values{};
+    for (std::size_t texel = 0; texel < values.size(); texel++)
+    {
+        values[texel] = static_cast<std::uint8_t>(10 + texel * 14);
+    }
+    const auto decoded = core::DecodeBc4Block(core::EncodeBc4Block(values));
+    EXPECT_EQ(decoded.front(), values.front());
+    EXPECT_EQ(decoded.back(), values.back());
+    for (std::size_t texel = 0; texel < values.size(); texel++)
+    {
+        //Half the step between two of the 8 values
+        EXPECT_LE(std::abs(decoded[texel] - values[texel]), 16);
+    }
+
+    values.fill(42);
+    EXPECT_EQ(core::DecodeBc4Block(core::EncodeBc4Block(values)), values);
+}
+
+TEST(TextureCompression, CompressedSizeRoundsUpToBlocks)
+{
+    constexpr int width = 6;
+    constexpr int height = 3;
+    const auto rgba = MakeGradient(width, height);
+    EXPECT_EQ(core::CompressImage(rgba, width, height, core::BlockFormat::BC1).size(), 2u * 8u);
+    EXPECT_EQ(core::CompressImage(rgba, width, height, core::BlockFormat::BC3).size(), 2u * 16u);
+    EXPECT_EQ(core::CompressImage(rgba, width, height, core::BlockFormat::BC4).size(), 2u * 8u);
+    EXPECT_EQ(core::CompressImage(rgba, width, height, core::BlockFormat::BC5).size(), 2u * 16u);
+}
+
+TEST(TextureCompression, Bc5StoresRedAndGreen)
+{
+    constexpr int size = 4;
+    const auto rgba = MakeGradient(size, size);
+    const auto compressed = core::CompressImage(rgba, size, size, core::BlockFormat::BC5);
+    const auto red = core::DecodeBc4Block(std::span<const std::uint8_t, 8>(compressed.data(), 8));
+    const auto green = core::DecodeBc4Block(std::span<const std::uint8_t, 8>(compressed.data() + 8, 8));
+    for (std::size_t texel = 0; texel < core::BLOCK_TEXEL_COUNT; texel++)
+    {
+        EXPECT_LE(std::abs(red[texel] - rgba[texel * 4]), 16);
+        EXPECT_LE(std::abs(green[texel] - rgba[texel * 4 + 1]), 16);
+    }
+}
+
+TEST(TextureCompression, DownsampleAverages)
+{
+    const std::vector<std::uint8_t> rgba = {
+            0, 0, 0, 0, 255, 255, 255, 255,
+            0, 0, 0, 0, 255, 255, 255, 255};
+    const auto linear = core::DownsampleImage(rgba, 2, 2, false);
+    ASSERT_EQ(linear.size(), 4u);
+    EXPECT_EQ(linear[0], 128);
+    EXPECT_EQ(linear[3], 128);
+    //Half the light is brighter than half the sRGB value
+    const auto srgb = core::DownsampleImage(rgba, 2, 2, true);
+    EXPECT_EQ(srgb[0], 188);
+    EXPECT_EQ(srgb[3], 128);
+
+    const auto last = core::DownsampleImage(std::vector<std::uint8_t>(4, 7), 1, 1, false);
+    EXPECT_EQ(last, std::vector<std::uint8_t>(4, 7));
+}
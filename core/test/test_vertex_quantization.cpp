@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <vertex_quantization.h>
+
+#include <cmath>
+#include <limits>
+
+TEST(VertexQuantization, HalfKnownValues)
+{
+    EXPECT_EQ(core::FloatToHalf(0.0f), 0x0000u);
+    EXPECT_EQ(core::FloatToHalf(-0.0f), 0x8000u);
+    EXPECT_EQ(core::FloatToHalf(1.0f), 0x3c00u);
+    EXPECT_EQ(core::FloatToHalf(-2.0f), 0xc000u);
+    EXPECT_EQ(core::FloatToHalf(65504.0f), 0x7bffu);
+    EXPECT_EQ(core::FloatToHalf(1.0e6f), 0x7c00u);
+    EXPECT_EQ(core::FloatToHalf(std::numeric_limits<float>::infinity()), 0x7c00u);
+    //Smallest denormal half
+    EXPECT_EQ(core::FloatToHalf(std::ldexp(1.0f, -24)), 0x0001u);
+}
+
+TEST(VertexQuantization, HalfRoundTrip)
+{
+    for (const float value : {0.5f, 0.333f, -7.25f, 1024.0f, 0.0001f})
+    {
+        const float roundTrip = core::HalfToFloat(core::FloatToHalf(value));
+        EXPECT_NEAR(roundTrip, value, std::abs(value) * 1.0e-3f + 1.0e-7f);
+    }
+}
+
+TEST(VertexQuantization, OctahedralRoundTrip)
+{
+    const glm::vec3 directions[] = {
+            glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f),
+            glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.267f, -0.535f, -0.802f), glm::vec3(-0.577f, 0.577f, 0.577f)};
+    for (const auto& direction : directions)
+    {
+        const auto decoded = core::DecodeOctahedral(core::EncodeOctahedral(direction));
+        const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y +
+                                       direction.z * direction.z);
+        EXPECT_NEAR(decoded.x, direction.x / length, 1.0e-3f);
+        EXPECT_NEAR(decoded.y, direction.y / length, 1.0e-3f);
+        EXPECT_NEAR(decoded.z, direction.z / length, 1.0e-3f);
+    }
+}
+
+TEST(VertexQuantization, PositionRelativeToBounds)
+{
+    core::MeshFileVertex vertex{};
+    vertex.position = glm::vec3(-1.0f, 0.5f, 3.0f);
+    vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    vertex.tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+    const auto quantized = core::QuantizeVertex(vertex, glm::vec3(-1.0f, 0.0f, 3.0f), glm::vec3(1.0f, 1.0f, 3.0f));
+    EXPECT_EQ(quantized.position[0], 0u);
+    EXPECT_EQ(quantized.position[1], 32768u);
+    //Flat extent
+    EXPECT_EQ(quantized.position[2], 0u);
+}
@@ -0,0 +1,18 @@
+#version 430
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec3 aNormal;
+layout (location = 4) in uint aMaterialIndex;
+
+out vec2 TexCoords;
+flat out uint MaterialIndex;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    TexCoords = aTexCoords;
+    MaterialIndex = aMaterialIndex;
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
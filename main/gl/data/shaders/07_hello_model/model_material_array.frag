@@ -0,0 +1,50 @@
+#version 430
+out vec4 FragColor;
+in vec2 TexCoords;
+flat in uint MaterialIndex;
+
+const uint NO_TEXTURE = 0xFFFFFFFFu;
+
+struct TextureData
+{
+    uint array;
+    uint layer;
+    uvec2 handle;
+};
+
+struct MaterialData
+{
+    TextureData diffuse;
+    TextureData specular;
+    TextureData normal;
+};
+
+layout(std430, binding = 0) readonly buffer Materials
+{
+    MaterialData materials[];
+};
+
+uniform sampler2DArray textureArrays[8];
+
+vec4 SampleTexture(TextureData textureData, vec2 texCoords)
+{
+    vec3 coords = vec3(texCoords, float(textureData.layer));
+    //The array changes between the draws of a multi draw, each sampler is only indexed with a constant
+    switch (textureData.array)
+    {
+        case 0u: return texture(textureArrays[0], coords);
+        case 1u: return texture(textureArrays[1], coords);
+        case 2u: return texture(textureArrays[2], coords);
+        case 3u: return texture(textureArrays[3], coords);
+        case 4u: return texture(textureArrays[4], coords);
+        case 5u: return texture(textureArrays[5], coords);
+        case 6u: return texture(textureArrays[6], coords);
+        case 7u: return texture(textureArrays[7], coords);
+    }
+    return vec4(1.0);
+}
+
+void main()
+{
+    FragColor = SampleTexture(materials[MaterialIndex].diffuse, TexCoords);
+}
@@ -0,0 +1,38 @@
+#version 430
+#extension GL_ARB_bindless_texture : require
+out vec4 FragColor;
+in vec2 TexCoords;
+flat in uint MaterialIndex;
+
+struct TextureData
+{
+    uint array;
+    uint layer;
+    uvec2 handle;
+};
+
+struct MaterialData
+{
+    TextureData diffuse;
+    TextureData specular;
+    TextureData normal;
+};
+
+layout(std430, binding = 0) readonly buffer Materials
+{
+    MaterialData materials[];
+};
+
+vec4 SampleTexture(TextureData textureData, vec2 texCoords)
+{
+    if (textureData.handle == uvec2(0u))
+    {
+        return vec4(1.0);
+    }
+    return texture(sampler2D(textureData.handle), texCoords);
+}
+
+void main()
+{
+    FragColor = SampleTexture(materials[MaterialIndex].diffuse, TexCoords);
+}
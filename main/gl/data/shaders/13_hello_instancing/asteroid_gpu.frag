@@ -0,0 +1,11 @@
+#version 430
+
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D texture_diffuse1;
+
+void main()
+{
+    FragColor = texture(texture_diffuse1, TexCoords);
+}
@@ -0,0 +1,33 @@
+#version 430
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoords;
+
+layout(std430, binding = 0) readonly buffer Positions
+{
+    vec4 positions[];
+};
+
+uniform mat4 view;
+//The positions are quantized relative to the bounds of the mesh
+uniform vec3 meshBoundsMin;
+uniform vec3 meshBoundsExtent;
+uniform mat4 projection;
+
+out vec2 TexCoords;
+
+mat4 translate(vec3 v)
+{
+    return mat4(
+        vec4(1.0,0.0,0.0,0.0),
+        vec4(0.0,1.0,0.0,0.0),
+        vec4(0.0,0.0,1.0,0.0),
+        vec4(v, 1.0)
+    );
+}
+
+void main()
+{
+    vec4 pos = projection * view * translate(positions[gl_InstanceID].xyz) * vec4(meshBoundsMin + aPos * meshBoundsExtent, 1.0);
+    gl_Position = pos;
+    TexCoords = aTexCoords;
+}
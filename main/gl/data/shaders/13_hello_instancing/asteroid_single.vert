@@ -14,13 +14,16 @@ mat4 translate(vec3 v)
 
 uniform vec3 position;
 uniform mat4 view;
+//The positions are quantized relative to the bounds of the mesh
+uniform vec3 meshBoundsMin;
+uniform vec3 meshBoundsExtent;
 uniform mat4 projection;
 
 out vec2 TexCoords;
 
 void main()
 {
-    vec4 pos = projection * view * translate(position) * vec4(aPos, 1.0);
+    vec4 pos = projection * view * translate(position) * vec4(meshBoundsMin + aPos * meshBoundsExtent, 1.0);
     gl_Position = pos;
     TexCoords = aTexCoords;
 }
\ No newline at end of file
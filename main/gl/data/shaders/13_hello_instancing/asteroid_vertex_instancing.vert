@@ -4,6 +4,9 @@ layout(location = 1) in vec2 aTexCoords;
 layout(location = 5) in vec3 aAsteroidPos;
 
 uniform mat4 view;
+//The positions are quantized relative to the bounds of the mesh
+uniform vec3 meshBoundsMin;
+uniform vec3 meshBoundsExtent;
 uniform mat4 projection;
 
 out vec2 TexCoords;
@@ -20,7 +23,7 @@ mat4 translate(vec3 v)
 
 void main()
 {
-    vec4 pos = projection * view * translate(aAsteroidPos) * vec4(aPos, 1.0);
+    vec4 pos = projection * view * translate(aAsteroidPos) * vec4(meshBoundsMin + aPos * meshBoundsExtent, 1.0);
     gl_Position = pos;
     TexCoords = aTexCoords;
 }
\ No newline at end of file
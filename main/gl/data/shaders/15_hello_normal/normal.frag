@@ -26,8 +26,10 @@ void main()
     vec3 normal;
     if(enableNormalMap)
     {
-        normal = texture(texture_normal1, TexCoords).rgb;
-        normal = normalize(normal * 2.0 - 1.0); //[0,1] -> [-1,1]
+        //Only xy is stored in a BC5 normal map, z is rebuilt from them
+        normal.xy = texture(texture_normal1, TexCoords).rg * 2.0 - 1.0; //[0,1] -> [-1,1]
+        normal.z = sqrt(max(1.0 - dot(normal.xy, normal.xy), 0.0));
+        normal = normalize(normal);
     }
     else
     {
@@ -14,11 +14,21 @@ uniform sampler2D texture_diffuse1;
 
 struct DirectionalLight
 {
+    mat4 lightSpaceMatrix;
     vec3 direction;
-    sampler2D shadowMap;
 };
-uniform DirectionalLight lights[3];
-uniform vec3 viewPos;
+layout(std140) uniform Lights
+{
+    DirectionalLight lights[3];
+};
+//Samplers cannot be part of a uniform block
+uniform sampler2D shadowMaps[3];
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
 
 uniform bool enableCascadeColor;
 uniform bool enableDepthColor;
@@ -36,7 +46,7 @@ float ShadowCalculation(int cascadeIndex)
     // transform to [0,1] range
     projCoords = projCoords * 0.5 + 0.5;
     // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(lights[cascadeIndex].shadowMap, projCoords.xy).r;
+    float closestDepth = texture(shadowMaps[cascadeIndex], projCoords.xy).r;
     // get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
 
@@ -12,11 +12,23 @@ out vec3 Normal;
 out vec2 TexCoords;
 
 
-uniform mat4 projection;
-uniform mat4 view;
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
+struct DirectionalLight
+{
+    mat4 lightSpaceMatrix;
+    vec3 direction;
+};
+layout(std140) uniform Lights
+{
+    DirectionalLight lights[3];
+};
 uniform mat4 model;
 uniform mat4 transposeInverseModel;
-uniform mat4 lightSpaceMatrices[3];
 
 void main()
 {
@@ -27,6 +39,6 @@ void main()
     ClipSpacePosZ = gl_Position.z;
     for(int i = 0; i < 3; i++)
     {
-        LightSpacePos[i] = lightSpaceMatrices[i] * vec4(FragPos, 1.0);
+        LightSpacePos[i] = lights[i].lightSpaceMatrix * vec4(FragPos, 1.0);
     }
 }
\ No newline at end of file
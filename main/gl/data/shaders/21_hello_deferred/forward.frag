@@ -14,8 +14,16 @@ struct Light {
     vec3 color;
 };
 const int NR_LIGHTS = 32;
-uniform Light lights[NR_LIGHTS];
-uniform vec3 viewPos;
+layout(std140) uniform Lights
+{
+    Light lights[NR_LIGHTS];
+};
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
 
 void main()
 {
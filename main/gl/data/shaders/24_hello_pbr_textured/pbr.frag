@@ -70,7 +70,10 @@ vec3 FresnelSchlick(float cosTheta, vec3 F0)
 // ----------------------------------------------------------------------------
 vec3 GetNormalFromNormalMap()
 {
-    vec3 tangentNormal = texture(normalMap, TexCoords).xyz * 2.0 - 1.0;
+    //Only xy is stored in a BC5 normal map, z is rebuilt from them
+    vec3 tangentNormal;
+    tangentNormal.xy = texture(normalMap, TexCoords).xy * 2.0 - 1.0;
+    tangentNormal.z = sqrt(max(1.0 - dot(tangentNormal.xy, tangentNormal.xy), 0.0));
     return normalize(TBN*tangentNormal);
 }
 // ----------------------------------------------------------------------------
@@ -23,9 +23,17 @@ struct Light
     vec3 position;
     vec3 color;
 };
-uniform Light lights[4];
+layout(std140) uniform Lights
+{
+    Light lights[4];
+};
 
-uniform vec3 viewPos;
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
 uniform bool gammaCorrect;
 uniform bool enableIrradiance;
 uniform bool enableSchlickRoughness;
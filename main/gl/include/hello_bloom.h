@@ -1,11 +1,14 @@
 #pragma once
 
+#include <array>
+
 #include "engine.h"
 #include "glm/vec3.hpp"
 #include "gl/vertex_array.h"
 #include "gl/shader.h"
 #include "gl/camera.h"
-#include "gl/framebuffer.h"
+#include "gl/frame_graph.h"
+#include "gl/texture.h"
 
 namespace gl
 {
@@ -30,8 +33,7 @@ private:
 		float angle = 0.0f;
 		glm::vec3 axis = glm::vec3(0,1,0);
 	};
-	Framebuffer hdrFramebuffer_;
-	std::array<Framebuffer, 2> pingpongFramebuffers_;
+	FrameGraph frameGraph_;
     bool enableBloom_ = false;
 	ShaderProgram cubeShader_;
 	ShaderProgram lightShader_;
@@ -5,8 +5,11 @@
 #include <gl/vertex_array.h>
 #include <gl/texture.h>
 #include <gl/camera.h>
+#include <gl/frame_graph.h>
 #include <gl/model.h>
+#include <gl/render_queue.h>
 #include <gl/shader.h>
+#include <gl/uniform_buffer.h>
 
 namespace gl
 {
@@ -38,6 +41,14 @@ private:
         glm::vec3 direction = glm::normalize(glm::vec3(-1.0f));
         glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
     };
+    /**
+     * std140 element of the Lights block, the shadow maps are bound as a separate sampler array
+     */
+    struct DirectionalLightData
+    {
+        std140::Mat4 lightSpaceMatrix{1.0f};
+        std140::Vec3 direction;
+    };
 
     [[nodiscard]] Camera2D CalculateOrthoLight(float cascadeNear, float cascadeFar, glm::vec3 lightDir) const;
 
@@ -46,8 +57,7 @@ private:
     void RenderScene(ShaderProgram& shader);
 
     sdl::Camera3D camera_;
-    Framebuffer shadowFramebuffer_;
-    std::array<unsigned int, 3> shadowMaps_{};
+    FrameGraph frameGraph_;
 
     ShaderProgram simpleDepthShader_;
     ShaderProgram shadowShader_;
@@ -59,11 +69,14 @@ private:
     float shadowBias_ = 0.005f;
     std::uint8_t flags_ = ENABLE_DEPTH_COLOR;
     std::array<DirectionalLight, 3> lights_;
+    UniformBuffer cameraBuffer_;
+    UniformBuffer lightsBuffer_;
 
     Quad plane_{glm::vec2(1.0f), glm::vec2()};
     Quad screenPlane_{glm::vec2 (2.0f), glm::vec2 ()};
-    Model model_;
-    Texture brickwall_;
+    std::shared_ptr<Model> model_;
+    RenderQueue renderQueue_;
+    std::shared_ptr<Texture> brickwall_;
     Texture whiteTexture_;
 
 };
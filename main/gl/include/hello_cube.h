@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "gl/engine.h"
 #include "GL/glew.h"
 #include "gl/shader.h"
@@ -27,7 +29,7 @@ public:
 private:
     Cuboid cuboid_{glm::vec3(1.0f), glm::vec3(0.0f)};
     ShaderProgram shader_;
-    Texture cubeTexture_{};
+    std::shared_ptr<Texture> cubeTexture_;
     constexpr static int cubeNmb = 10;
     std::array<glm::vec3, cubeNmb> positions_{};
     std::array<glm::quat, cubeNmb> quaternions_{};
@@ -48,7 +48,7 @@ private:
     ShaderProgram modelShader_;
     ShaderProgram modelReflectionShader_;
     ShaderProgram modelRefractionShader_;
-    Model model_;
+    std::shared_ptr<Model> model_;
     Cuboid cube_{glm::vec3(1.0f), glm::vec3()};
     Texture cubeTexture_;
 
@@ -30,10 +30,10 @@ private:
         CCW = 1u << 2u
     };
     sdl::Camera3D camera_;
-    Model model_;
+    std::shared_ptr<Model> model_;
     ShaderProgram modelShader_;
     Cuboid cube_{glm::vec3(1.0f), glm::vec3()};
-    Texture cubeTexture_;
+    std::shared_ptr<Texture> cubeTexture_;
     std::uint8_t flags_ = BACK_CULLING | CCW;
 
 };
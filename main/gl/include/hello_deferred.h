@@ -1,6 +1,10 @@
 #pragma once
 
+#include <memory>
+
 #include <engine.h>
+#include <gl/render_queue.h>
+#include <gl/uniform_buffer.h>
 
 namespace gl
 {
@@ -17,31 +21,29 @@ public:
 
     void DrawImGui() override;
 private:
-    struct PointLight
-    {
-        glm::vec3 position;
-        glm::vec3 color;
-    };
+    static constexpr std::size_t LIGHT_NMB = 32;
 
     void RenderScene(gl::ShaderProgram& shader);
 
 
-    std::array<PointLight, 32> lights_;
+    PointLightsBlock<LIGHT_NMB> lights_;
     sdl::Camera3D camera_;
     ShaderProgram deferredShader_;
     ShaderProgram lightingShader_;
     ShaderProgram forwardShader_;
+    UniformBuffer cameraBuffer_;
+    UniformBuffer lightsBuffer_;
 
     Quad floor_{glm::vec3(10.0f), glm::vec3()};
     Quad screenQuad_{glm::vec3 (2.0f), glm::vec3()};
     Cuboid cube_{glm::vec3(1.0f), glm::vec3(0,0.5f,0)};
-    Model model_;
+    std::shared_ptr<Model> model_;
+    RenderQueue renderQueue_;
 
     Texture container_;
     Texture containerSpecular_;
     Texture whiteTexture_;
 
-    Framebuffer gBuffer_;
     bool deferredRendering_ = false;
 };
 }
\ No newline at end of file
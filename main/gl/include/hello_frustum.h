@@ -1,11 +1,18 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "glm/vec3.hpp"
 #include "engine.h"
+#include "asteroid_simulation.h"
+#include "jobsystem.h"
 #include "gl/shader.h"
 #include "gl/model.h"
 #include "gl/framebuffer.h"
 #include "gl/camera.h"
+#include "gl/stream_buffer.h"
 
 namespace gl
 {
@@ -24,17 +31,34 @@ public:
     void DrawImGui() override;
     
 private:
-    void CalculateForce(uint64_t begin, uint64_t end);
-    void CalculateVelocity(uint64_t begin, uint64_t end);
-    void CalculatePositions(uint64_t begin, uint64_t end);
-    void Culling(unsigned long begin, unsigned long end);
+    struct DrawElementsIndirectCommand
+    {
+        unsigned int count;
+        unsigned int instanceCount;
+        unsigned int firstIndex;
+        unsigned int baseVertex;
+        unsigned int baseInstance;
+    };
+
+    static constexpr std::size_t maxLodCount_ = 4;
+    using LodPositions = std::array<std::vector<glm::vec3>, maxLodCount_>;
+
+    /**
+     * \brief Write the asteroids of [begin, end) inside the frustum to the LOD their projected size selects
+     */
+    void Culling(std::size_t begin, std::size_t end, LodPositions& culledPositions);
+    [[nodiscard]] std::size_t GetLodCount() const;
+    void CreateHiZ();
+    void DestroyHiZ();
+    void BuildHiZ();
+    void OcclusionCulling();
 
 
     sdl::Camera3D camera_;
     Camera3D overCamera_;
 
-    Model rockModel_;
-    static constexpr uint64_t maxAsteroidNmb_ = 100'000;
+    std::shared_ptr<Model> rockModel_;
+    static constexpr uint64_t maxAsteroidNmb_ = 1'000'000;
     static constexpr uint64_t minAsteroidNmb_ = 1'000;
     uint64_t instanceChunkSize_ = 1'000;
     uint64_t asteroidNmb_ = 1000;
@@ -42,25 +66,59 @@ private:
 
     ShaderProgram vertexInstancingDrawShader_;
     ShaderProgram screenShader_;
+    ShaderProgram hiZCopyShader_;
+    ShaderProgram hiZReduceShader_;
+    ShaderProgram occlusionCullingShader_;
 
-    std::vector<glm::vec3> asteroidPositions_;
-    std::vector<glm::vec3> asteroidVelocities_;
-    std::vector<glm::vec3> asteroidForces_;
+    core::AsteroidSimulation simulation_;
     /**
-     * Used by frustum culling before sending to GPU
+     * The workers simulate and frustum cull their chunk, then copy the survivors to the mapped region
+     * grouped by LOD, each LOD is drawn from its range of instances
      */
-    std::vector<glm::vec3> asteroidCulledPositions_;
-
+    StreamBuffer culledInstanceBuffer_;
+    std::size_t culledAsteroidNmb_ = 0;
+    std::vector<LodPositions> chunkCulledPositions_;
+    std::array<std::size_t, maxLodCount_> lodFirstInstance_{};
+    std::array<std::size_t, maxLodCount_> lodInstanceNmb_{};
+    bool enableLod_ = true;
+    /**
+     * Part of the screen height covered by an asteroid under which LOD 1 is used, each next LOD takes half of it
+     */
+    float lodScreenSize_ = 0.1f;
+    std::unique_ptr<core::WorkerQueue> workerQueue_;
+    std::vector<std::unique_ptr<core::WorkerThread>> workerThreads_;
+    static constexpr std::size_t jobChunkSize_ = 16'384;
 
+    /**
+     * Receives the instances surviving the occlusion culling
+     */
     unsigned int instanceVBO_ = 0;
 
-    const float gravityConst = 1000.0f;
-    const float centerMass = 1000.0f;
-    const float asteroidMass = 1.0f;
     float dt_ = 1.0f;
 
     Framebuffer overviewFramebuffer_;
     Quad screenPlan_{glm::vec2(2.0f), glm::vec2()};
+
+    /**
+     * Hierarchical-Z occlusion culling, the main view is rendered in sceneFramebuffer_
+     * and its depth is reduced into a max-depth mip pyramid used by the next frame
+     */
+    bool enableOcclusionCulling_ = false;
+    bool hiZReady_ = false;
+    Framebuffer sceneFramebuffer_;
+    unsigned int hiZTexture_ = 0;
+    int hiZMipCount_ = 0;
+    glm::mat4 previousViewProjection_{1.0f};
+    unsigned int drawCommandBuffer_ = 0;
+    /**
+     * Visible counts are copied to one of these each frame and read once their fence signaled, the count
+     * shown lags by the frames the GPU is behind but reading it never stalls
+     */
+    static constexpr std::size_t visibleCountBufferNmb_ = 3;
+    std::array<unsigned int, visibleCountBufferNmb_> visibleCountBuffers_{};
+    std::array<void*, visibleCountBufferNmb_> visibleCountFences_{};
+    std::size_t frameIndex_ = 0;
+    unsigned int occlusionVisibleNmb_ = 0;
 };
 
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
+
+#include <memory>
 #include "engine.h"
 #include "gl/camera.h"
 #include "gl/framebuffer.h"
@@ -41,7 +43,7 @@ private:
     ShaderProgram hdrShader_;
 
     Cuboid cube_{glm::vec3(5, 5, 50), glm::vec3(0, 0, 10)};
-    Texture cubeTexture_;
+    std::shared_ptr<Texture> cubeTexture_;
     ShaderProgram cubeShader_;
 
     sdl::Camera3D camera_;
@@ -6,6 +6,7 @@
 #include <gl/shader.h>
 #include <gl/framebuffer.h>
 #include <gl/camera.h>
+#include <gl/uniform_buffer.h>
 
 namespace gl
 {
@@ -30,17 +31,12 @@ private:
 		ENABLE_SCHLICK_ROUGHNESS = 1u << 5u,
 
 	};
-	struct Light
-	{
-		glm::vec3 position;
-		glm::vec3 color;
-	};
 	void GenerateCubemap();
 	void GenerateDiffuseIrradiance();
 	void GeneratePrefilter();
 	void GenerateLUT();
 
-	std::array<Light, 4> lights_{
+	PointLightsBlock<4> lights_{
             {
                     {glm::vec3(-10.0f, 10.0f, 10.0f), glm::vec3(300.0f, 300.0f, 300.0f)},
                     {glm::vec3(10.0f, 10.0f, 10.0f), glm::vec3(300.0f, 300.0f, 300.0f)},
@@ -61,6 +57,8 @@ private:
 	ShaderProgram brdfShader_;
 
 	sdl::Camera3D camera_;
+	UniformBuffer cameraBuffer_;
+	UniformBuffer lightsBuffer_;
 	glm::vec3 baseColor_ = { 1.0f,0.5f,0.5f };
 	float spacing_ = 2.5f;
 	std::uint8_t flags_ = NONE;
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <array>
+#include <memory>
+
 #include "engine.h"
+#include "asteroid_simulation.h"
+#include "jobsystem.h"
 #include "gl/camera.h"
 #include "gl/model.h"
 #include "gl/shader.h"
+#include "gl/stream_buffer.h"
 
 namespace gl
 {
@@ -28,17 +34,36 @@ private:
         BUFFER_INSTANCING,
         LENGTH
     };
-    void CalculateForce(unsigned long long begin, unsigned long long end);
-    void CalculateVelocity(unsigned long long begin, unsigned long long end);
-    void CalculatePositions(unsigned long long begin, unsigned long long end);
+    enum class SimulationType
+    {
+        CPU,
+        GPU_CENTER_MASS,
+        GPU_NBODY,
+        LENGTH
+    };
+    void UploadSimulationToGpu();
+    /**
+     * \brief Read the GPU state back into the CPU simulation, for the asteroids to go on from where they are
+     */
+    void ReadSimulationFromGpu();
+    /**
+     * \brief Asteroids added to the GPU simulation take the same positions in both ping-pong buffers
+     */
+    void CopyPositionsToNextSsbo(std::size_t begin, std::size_t end);
+    void UpdateGpu();
 
     InstancingType instancingType_ = InstancingType::NO_INSTANCING;
+    SimulationType simulationType_ = SimulationType::CPU;
 
     sdl::Camera3D camera_;
-    Model rockModel_;
+    std::shared_ptr<Model> rockModel_;
 
-    const unsigned long long maxAsteroidNmb_ = 100'000;
+    const unsigned long long maxAsteroidNmb_ = 1'000'000;
     const unsigned long long minAsteroidNmb_ = 1'000;
+    /**
+     * The n-body pass computes all the pairs, a million asteroids would trip the driver timeout
+     */
+    const unsigned long long maxNbodyAsteroidNmb_ = 65'536;
     const unsigned long long uniformChunkSize_ = 254;
     unsigned long long instanceChunkSize_ = 1'000;
     unsigned long long asteroidNmb_ = 1000;
@@ -46,16 +71,27 @@ private:
     ShaderProgram singleDrawShader_;
     ShaderProgram uniformInstancingShader_;
     ShaderProgram vertexInstancingDrawShader_;
+    ShaderProgram gpuInstancingDrawShader_;
+    ShaderProgram centerMassComputeShader_;
+    ShaderProgram nbodyComputeShader_;
 
-    std::vector<glm::vec3> asteroidPositions_;
-    std::vector<glm::vec3> asteroidVelocities_;
-    std::vector<glm::vec3> asteroidForces_;
-
-    unsigned int instanceVBO_ = 0;
+    core::AsteroidSimulation simulation_;
+    /**
+     * Buffer instancing writes the simulated positions straight into the mapped region from the workers
+     */
+    StreamBuffer instanceBuffer_;
+    std::unique_ptr<core::WorkerQueue> workerQueue_;
+    std::vector<std::unique_ptr<core::WorkerThread>> workerThreads_;
+    static constexpr std::size_t jobChunkSize_ = 16'384;
+    /**
+     * GPU simulation, positions are ping-ponged so that the n-body pass never reads what it writes
+     */
+    std::array<unsigned int, 2> positionSsbos_{};
+    unsigned int velocitySsbo_ = 0;
+    std::size_t currentPositionSsbo_ = 0;
+    float asteroidMass_ = 1.0f;
+    float softening_ = 1.0f;
 
-    const float gravityConst = 1000.0f;
-    const float centerMass = 1000.0f;
-    const float asteroidMass = 1.0f;
     float dt_ = 1.0f;
 };
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "gl/texture.h"
 #include "gl/vertex_array.h"
 #include "gl/camera.h"
+#include "gl/geometry_pool.h"
+#include "gl/material_system.h"
 #include "gl/model.h"
 
 namespace gl
@@ -25,11 +27,15 @@ public:
     void DrawImGui() override;
 
 private:
-    Model model_;
-    Model gltfModel_;
+    std::shared_ptr<Model> model_;
+    std::shared_ptr<Model> gltfModel_;
+    GeometryPool geometryPool_;
+    MaterialSystem materialSystem_;
     sdl::Camera3D camera_;
 
     ShaderProgram shader_;
+    ShaderProgram materialShader_;
     bool usingGltf_ = false;
+    bool usingGeometryPool_ = true;
 };
 }
\ No newline at end of file
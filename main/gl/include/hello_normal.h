@@ -33,13 +33,13 @@ private:
     };
     ShaderProgram diffuseShader_;
     ShaderProgram normalShader_;
-    Texture diffuseTexture_;
-    Texture normalTexture_;
+    std::shared_ptr<Texture> diffuseTexture_;
+    std::shared_ptr<Texture> normalTexture_;
 
     Quad plane_ {glm::vec2(1.0f), glm::vec2()};
     Cuboid cube_{glm::vec3(1.0f), glm::vec3()};
     Sphere sphere_{0.5f, glm::vec3()};
-    Model model_;
+    std::shared_ptr<Model> model_;
 
     sdl::Camera3D camera_;
     glm::vec3 lightPos_ = glm::vec3(3.0f);
@@ -23,8 +23,9 @@ private:
         glm::vec3 position;
         glm::vec3 color;
     };
+    static constexpr float SPHERE_RADIUS = 1.0f;
     std::array<Light, 4> lights_{};
-    Sphere sphere_{ 1.0f, glm::vec3() };
+    Sphere sphere_{ SPHERE_RADIUS, glm::vec3() };
     ShaderProgram pbrShader_;
     sdl::Camera3D camera_{};
     Texture albedo_;
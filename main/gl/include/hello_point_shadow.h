@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "engine.h"
 #include <gl/framebuffer.h>
 #include <glm/vec3.hpp>
@@ -42,7 +44,7 @@ private:
     ShaderProgram simpleDepthShader_;
 
     ShaderProgram cubeShader_;
-    Texture cubeTexture_;
+    std::shared_ptr<Texture> cubeTexture_;
 
     Framebuffer shadowFramebuffer_;
     float dt_ = 0.0f;
@@ -50,7 +50,7 @@ private:
     void RenderScene(ShaderProgram& shader);
 
     Quad floor_{glm::vec2(5.0f), glm::vec2()};
-    Texture floorTexture_;
+    std::shared_ptr<Texture> floorTexture_;
 
     Cuboid cube_{glm::vec3(1.0f), glm::vec3()};
     std::array<Transform, 4> cubeTransforms_{
@@ -63,7 +63,7 @@ private:
                             glm::vec3(1, 0, 1))}}
     };
 
-    Model model_;
+    std::shared_ptr<Model> model_;
 
     ShaderProgram simpleDepthShader_;
     ShaderProgram modelShader_;
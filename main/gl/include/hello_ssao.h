@@ -2,9 +2,9 @@
 #include "engine.h"
 #include <glm/vec3.hpp>
 #include <gl/camera.h>
+#include <gl/frame_graph.h>
 #include <gl/model.h>
 #include <gl/shader.h>
-#include <gl/framebuffer.h>
 #include <gl/vertex_array.h>
 
 namespace gl
@@ -38,11 +38,9 @@ private:
 
     Quad screenQuad_{ glm::vec2(2.0f), glm::vec2() };
     Quad plane_{ glm::vec2(1.0f), glm::vec2() };
-    Model model_;
+    std::shared_ptr<Model> model_;
 
-    Framebuffer gBuffer_;
-    Framebuffer ssaoFramebuffer_;
-    Framebuffer ssaoBlurFramebuffer_;
+    FrameGraph frameGraph_;
     float ssaoRadius_ = 0.5f;
     float ssaoBias_ = 0.025f;
     unsigned noiseTexture_ = 0;
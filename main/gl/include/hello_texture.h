@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "gl/engine.h"
 #include "GL/glew.h"
 #include "gl/shader.h"
@@ -26,9 +28,9 @@ private:
     };
     Quad quad_{glm::vec2(1.0f), glm::vec2(0.0f)};
     ShaderProgram shader_;
-    Texture texture_{};
-    Texture ktxTexture_{};
-    Texture ddsTexture_{};
+    std::shared_ptr<Texture> texture_;
+    std::shared_ptr<Texture> ktxTexture_;
+    std::shared_ptr<Texture> ddsTexture_;
     TextureType textureType_ = TextureType::NONE;
 };
 }
\ No newline at end of file
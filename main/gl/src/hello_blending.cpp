@@ -1,4 +1,5 @@
 #include "hello_blending.h"
+#include "gl/state_cache.h"
 
 #include <imgui.h>
 
@@ -18,7 +19,7 @@ void HelloBlending::Init()
     camera_.Init();
 
 
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloBlending::Update(core::seconds dt)
@@ -27,8 +28,8 @@ void HelloBlending::Update(core::seconds dt)
 
     if (flags_ & ENABLE_BLENDING)
     {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        StateCache::Enable(GL_BLEND);
+        StateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
     blendingProgram_.Bind();
     blendingProgram_.SetMat4("view", camera_.GetView());
@@ -97,13 +98,13 @@ void HelloBlending::Update(core::seconds dt)
     }
     if (flags_ & ENABLE_BLENDING)
     {
-        glDisable(GL_BLEND);
+        StateCache::Disable(GL_BLEND);
     }
 }
 
 void HelloBlending::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     plane_.Destroy();
     cube_.Destroy();
     blendingProgram_.Destroy();
@@ -1,5 +1,7 @@
 #include <GL/glew.h>
 #include "hello_bloom.h"
+#include "gl/framebuffer.h"
+#include "gl/state_cache.h"
 #include "imgui.h"
 
 namespace gl
@@ -20,20 +22,7 @@ void HelloBloom::Init()
     camera_.Init();
     camera_.position = glm::vec3(0, 0, 5);
     camera_.LookAt(glm::vec3());
-
-    const auto windowSize = Engine::GetInstance().GetWindowSize();
-    hdrFramebuffer_.SetSize({windowSize[0], windowSize[1]});
-    hdrFramebuffer_.SetType(Framebuffer::HDR | Framebuffer::DEFAULT);
-    hdrFramebuffer_.SetColorAttachmentNmb(2);
-    hdrFramebuffer_.Create();
-
-    for (auto& pingpongFramebuffer : pingpongFramebuffers_)
-    {
-        pingpongFramebuffer.SetSize({windowSize[0], windowSize[1]});
-        pingpongFramebuffer.SetType(Framebuffer::HDR | Framebuffer::DEFAULT);
-        pingpongFramebuffer.Create();
-    }
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloBloom::Update(core::seconds dt)
@@ -41,80 +30,110 @@ void HelloBloom::Update(core::seconds dt)
     camera_.Update(dt);
     const auto view = camera_.GetView();
     const auto projection = camera_.GetProjection();
-    hdrFramebuffer_.Bind();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    cubeShader_.Bind();
-    cubeShader_.SetMat4("view", view);
-    cubeShader_.SetMat4("projection", projection);
-    cubeShader_.SetTexture("diffuseTexture", cubeTexture_, 0);
-
-    for (size_t i = 0; i < lights_.size(); i++)
+    const auto windowSize = Engine::GetInstance().GetWindowSize();
+    const RenderTargetDesc hdrDesc{windowSize[0], windowSize[1], GL_RGB16F};
+    frameGraph_.Clear();
+    const auto scene = frameGraph_.CreateResource("Scene", hdrDesc);
+    const auto bright = frameGraph_.CreateResource("Bright", hdrDesc);
+    const auto depth = frameGraph_.CreateResource("Depth", {windowSize[0], windowSize[1], GL_DEPTH_COMPONENT16});
+    frameGraph_.AddPass("Scene Pass", [&](FrameGraph::PassBuilder& builder)
     {
-        cubeShader_.SetVec3("lights[" + std::to_string(i) + "}.Position", lights_[i].position_);
-        cubeShader_.SetVec3("lights[" + std::to_string(i) + "].Color", lights_[i].color_);
-    }
-    cubeShader_.SetInt("lightNmb", lights_.size());
-    cubeShader_.SetVec3("viewPos", camera_.position);
-    for (const auto& transform : cubeTransforms_)
+        builder.Write(scene);
+        builder.Write(bright);
+        builder.Write(depth);
+    }, [&](const FrameGraph::PassResources& resources)
     {
-        auto model = glm::mat4(1.0f);
-        model = glm::translate(model, transform.position);
-        model = glm::rotate(model, transform.angle, transform.axis);
-        model = glm::scale(model, transform.scale);
-        cubeShader_.SetMat4("model", model);
-        cubeShader_.SetMat4("transposeInverseModel", glm::transpose(glm::inverse(model)));
+        resources.BindFramebuffer({scene, bright}, depth);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        cubeShader_.Bind();
+        cubeShader_.SetMat4("view", view);
+        cubeShader_.SetMat4("projection", projection);
+        cubeShader_.SetTexture("diffuseTexture", cubeTexture_, 0);
 
-        cube_.Draw();
-    }
-    lightShader_.Bind();
-    lightShader_.SetMat4("view", view);
-    lightShader_.SetMat4("projection", projection);
-    for (const auto& light : lights_)
-    {
-        auto model = glm::mat4(1.0f);
-        model = glm::translate(model, light.position_);
-        model = glm::scale(model, glm::vec3(0.25f));
-        lightShader_.SetMat4("model", model);
-        lightShader_.SetVec3("lightColor", light.color_);
-        cube_.Draw();
-    }
+        for (size_t i = 0; i < lights_.size(); i++)
+        {
+            cubeShader_.SetVec3("lights[" + std::to_string(i) + "}.Position", lights_[i].position_);
+            cubeShader_.SetVec3("lights[" + std::to_string(i) + "].Color", lights_[i].color_);
+        }
+        cubeShader_.SetInt("lightNmb", lights_.size());
+        cubeShader_.SetVec3("viewPos", camera_.position);
+        for (const auto& transform : cubeTransforms_)
+        {
+            auto model = glm::mat4(1.0f);
+            model = glm::translate(model, transform.position);
+            model = glm::rotate(model, transform.angle, transform.axis);
+            model = glm::scale(model, transform.scale);
+            cubeShader_.SetMat4("model", model);
+            cubeShader_.SetMat4("transposeInverseModel", glm::transpose(glm::inverse(model)));
 
-    bool horizontal = true;
-    if (enableBloom_)
-    {
-        bool firstIteration = true;
-        blurShader_.Bind();
-        blurShader_.SetInt("image", 0);
-        for (int i = 0; i < blurAmount_; i++)
+            cube_.Draw();
+        }
+        lightShader_.Bind();
+        lightShader_.SetMat4("view", view);
+        lightShader_.SetMat4("projection", projection);
+        for (const auto& light : lights_)
         {
-            pingpongFramebuffers_[horizontal].Bind();
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            blurShader_.SetInt("horizontal", horizontal);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, firstIteration
-                                             ? hdrFramebuffer_.GetColorTexture(1)
-                                             : pingpongFramebuffers_[!horizontal].GetColorTexture());
-            // bind texture of other framebuffer (or scene if first iteration)
-            screenPlane_.Draw();
-            horizontal = !horizontal;
-            if (firstIteration)
-                firstIteration = false;
+            auto model = glm::mat4(1.0f);
+            model = glm::translate(model, light.position_);
+            model = glm::scale(model, glm::vec3(0.25f));
+            lightShader_.SetMat4("model", model);
+            lightShader_.SetVec3("lightColor", light.color_);
+            cube_.Draw();
         }
+    });
+
+    //Each blur iteration reads the previous one, the pool gives two targets to the whole chain
+    auto blurred = bright;
+    for (int i = 0; i < blurAmount_; i++)
+    {
+        const auto input = blurred;
+        const auto output = frameGraph_.CreateResource("Bloom Blur", hdrDesc);
+        const bool horizontal = i % 2 == 0;
+        frameGraph_.AddPass(horizontal ? "Horizontal Blur Pass" : "Vertical Blur Pass",
+                            [input, output](FrameGraph::PassBuilder& builder)
+                            {
+                                builder.Read(input);
+                                builder.Write(output);
+                            }, [this, input, output, horizontal](const FrameGraph::PassResources& resources)
+                            {
+                                resources.BindFramebuffer({output});
+                                glClear(GL_COLOR_BUFFER_BIT);
+                                blurShader_.Bind();
+                                blurShader_.SetInt("image", 0);
+                                blurShader_.SetInt("horizontal", horizontal);
+                                StateCache::ActiveTexture(GL_TEXTURE0);
+                                StateCache::BindTexture(GL_TEXTURE_2D, resources.GetTexture(input));
+                                screenPlane_.Draw();
+                            });
+        blurred = output;
     }
-    Framebuffer::Unbind();
     // 3. now render floating point color buffer to 2D quad and tonemap HDR colors to default framebuffer's (clamped) color range
     // --------------------------------------------------------------------------------------------------------------------------
-    bloomShader_.Bind();
-    bloomShader_.SetTexture("scene", hdrFramebuffer_.GetColorTexture(), 0);
-    bloomShader_.SetTexture("bloomBlur", pingpongFramebuffers_[!horizontal].GetColorTexture(), 1);
-    bloomShader_.SetInt("bloom", enableBloom_);
-    bloomShader_.SetFloat("exposure", exposure_);
-    screenPlane_.Draw();
+    //Without bloom the blur passes are not read and get culled
+    frameGraph_.AddPass("Composite Pass", [&](FrameGraph::PassBuilder& builder)
+    {
+        builder.Read(scene);
+        if (enableBloom_)
+        {
+            builder.Read(blurred);
+        }
+        builder.SetSideEffect();
+    }, [&](const FrameGraph::PassResources& resources)
+    {
+        Framebuffer::Unbind();
+        bloomShader_.Bind();
+        bloomShader_.SetTexture("scene", resources.GetTexture(scene), 0);
+        bloomShader_.SetTexture("bloomBlur", resources.GetTexture(enableBloom_ ? blurred : scene), 1);
+        bloomShader_.SetInt("bloom", enableBloom_);
+        bloomShader_.SetFloat("exposure", exposure_);
+        screenPlane_.Draw();
+    });
+    frameGraph_.Execute();
 }
 
 void HelloBloom::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     cube_.Destroy();
     cubeTexture_.Destroy();
     screenPlane_.Destroy();
@@ -123,24 +142,12 @@ void HelloBloom::Destroy()
     blurShader_.Destroy();
     cubeShader_.Destroy();
     lightShader_.Destroy();
-
-    hdrFramebuffer_.Destroy();
-    std::ranges::for_each(pingpongFramebuffers_, [](auto& f) { f.Destroy(); });
+    frameGraph_.Clear();
 }
 
 void HelloBloom::OnEvent(SDL_Event& event)
 {
     camera_.OnEvent(event);
-    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_RESIZED)
-    {
-        hdrFramebuffer_.SetSize({event.window.data1, event.window.data2});
-        hdrFramebuffer_.Reload();
-        for (auto& ppF : pingpongFramebuffers_)
-        {
-            ppF.SetSize({event.window.data1, event.window.data2});
-            ppF.Reload();
-        }
-    }
 }
 
 void HelloBloom::DrawImGui()
@@ -150,6 +157,9 @@ void HelloBloom::DrawImGui()
 
     ImGui::SliderFloat("Exposure", &exposure_, 0.1f, 10.0f);
     ImGui::SliderInt("Blur Amount", &blurAmount_, 2, 20);
+    const auto& frameGraphStatistics = frameGraph_.GetStatistics();
+    ImGui::Text("Passes: %zu culled: %zu targets: %zu", frameGraphStatistics.passNmb,
+                frameGraphStatistics.culledPassNmb, frameGraphStatistics.transientNmb);
     ImGui::End();
 }
 }
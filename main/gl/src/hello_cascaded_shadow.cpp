@@ -3,7 +3,9 @@
 //
 #include <GL/glew.h>
 #include "hello_cascaded_shadow.h"
+#include "gl/asset_registry.h"
 #include <gl/error.h>
+#include <gl/state_cache.h>
 #include <imgui.h>
 
 #ifdef TRACY_ENABLE
@@ -17,7 +19,7 @@ namespace gl
 void HelloCascadedShadow::Init()
 {
     plane_.Init();
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
     simpleDepthShader_.CreateDefaultProgram("data/shaders/18_hello_cascaded_shadow/simple_depth.vert",
                                             "data/shaders/18_hello_cascaded_shadow/simple_depth.frag");
     shadowShader_.CreateDefaultProgram("data/shaders/18_hello_cascaded_shadow/shadow.vert",
@@ -25,31 +27,16 @@ void HelloCascadedShadow::Init()
     screenShader_.CreateDefaultProgram("data/shaders/18_hello_cascaded_shadow/screen.vert",
                                        "data/shaders/18_hello_cascaded_shadow/screen.frag");
     screenPlane_.Init();
-    shadowFramebuffer_.SetType(Framebuffer::NO_DRAW | Framebuffer::DEPTH_ATTACHMENT);
-    shadowFramebuffer_.SetSize({SHADOW_WIDTH, SHADOW_HEIGHT});
-    shadowFramebuffer_.Create();
-    shadowMaps_[0] = shadowFramebuffer_.GetDepthTexture();
-    glGenTextures(shadowMaps_.size() - 1, &shadowMaps_[1]);
-    for (std::size_t i = 1; i < shadowMaps_.size(); i++)
-    {
-        glBindTexture(GL_TEXTURE_2D, shadowMaps_[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16,
-                     SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glCheckError();
-    }
-    brickwall_.LoadTexture("data/textures/brickwall.jpg");
+    brickwall_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg");
     whiteTexture_.CreateWhiteTexture();
 
     camera_.Init();
     camera_.position = glm::vec3(0, 3, -3);
     camera_.LookAt(glm::vec3(0, 0, 1) * camera_.farPlane / 2.0f);
     camera_.farPlane = 100.0f;
-    glEnable(GL_DEPTH_TEST);
+    cameraBuffer_.Create<CameraBlock>(UniformBlockBinding::CAMERA);
+    lightsBuffer_.Create<std::array<DirectionalLightData, 3>>(UniformBlockBinding::LIGHTS);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloCascadedShadow::Update(core::seconds dt)
@@ -59,71 +46,103 @@ void HelloCascadedShadow::Update(core::seconds dt)
     TracyGpuNamedZone(shadowUpdateGpu, "Cascaded Shadow Update", true);
 #endif
     camera_.Update(dt);
-    //Shadow passes
-    glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    shadowFramebuffer_.Bind();
-    simpleDepthShader_.Bind();
-    for (std::size_t i = 0; i < shadowMaps_.size(); i++)
+    cameraBuffer_.Update(CameraBlock{camera_.GetView(), camera_.GetProjection(), camera_.position});
+    frameGraph_.Clear();
+    std::array<FrameGraph::ResourceHandle, 3> shadowMaps{};
+    for (std::size_t i = 0; i < shadowMaps.size(); i++)
     {
-        ShadowPass(i);
+        shadowMaps[i] = frameGraph_.CreateResource("Shadow Map", {SHADOW_WIDTH, SHADOW_HEIGHT, GL_DEPTH_COMPONENT16});
+        const auto shadowMap = shadowMaps[i];
+        frameGraph_.AddPass("Shadow Pass", [shadowMap](FrameGraph::PassBuilder& builder)
+        {
+            builder.Write(shadowMap);
+        }, [this, shadowMap, i](const FrameGraph::PassResources& resources)
+        {
+            glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+            resources.BindFramebuffer({}, shadowMap);
+            simpleDepthShader_.Bind();
+            ShadowPass(static_cast<int>(i));
+        });
     }
-    Framebuffer::Unbind();
-    const auto windowSize = Engine::GetInstance().GetWindowSize();
-    glViewport(0, 0, windowSize[0], windowSize[1]);
-    shadowShader_.Bind();
-    shadowShader_.SetMat4("view", camera_.GetView());
-    shadowShader_.SetMat4("projection", camera_.GetProjection());
-    shadowShader_.SetTexture("material.texture_diffuse1", whiteTexture_, 0);
-    for (size_t i = 0; i < lights_.size(); i++)
+    frameGraph_.AddPass("Lighting Pass", [&shadowMaps](FrameGraph::PassBuilder& builder)
     {
-        shadowShader_.SetMat4("lightSpaceMatrices[" + std::to_string(i) + "]", lights_[i].lightSpaceMatrix);
-        shadowShader_.SetVec3("lights[" + std::to_string(i) + "].direction", lights_[i].direction);
-    }
-    shadowShader_.SetVec3("viewPos", camera_.position);
-    for (size_t i = 0; i < shadowMaps_.size(); i++)
+        for (const auto shadowMap : shadowMaps)
+        {
+            builder.Read(shadowMap);
+        }
+        builder.SetSideEffect();
+    }, [this, &shadowMaps](const FrameGraph::PassResources& resources)
     {
-        shadowShader_.SetTexture("lights[" + std::to_string(i) + "].shadowMap", shadowMaps_[i], i + 3);
-    }
-    shadowShader_.SetInt("enableCascadeColor", flags_ & ENABLE_CASCADE_COLOR);
-    shadowShader_.SetInt("enableDepthColor", flags_ & ENABLE_DEPTH_COLOR);
-    shadowShader_.SetFloat("farPlane", camera_.farPlane);
-    shadowShader_.SetFloat("bias", shadowBias_);
-    shadowShader_.SetFloat("maxNearCascade", camera_.farPlane * cascadedNearRatio_);
-    shadowShader_.SetFloat("maxMiddleCascade", camera_.farPlane * cascadedMiddleRatio_);
-    RenderScene(shadowShader_);
-    if(flags_ & SHOW_DEPTH_TEXTURES)
+        Framebuffer::Unbind();
+        //The light matrices are known once all the cascades are rendered
+        std::array<DirectionalLightData, 3> lightsData;
+        for (std::size_t i = 0; i < lights_.size(); i++)
+        {
+            lightsData[i] = {lights_[i].lightSpaceMatrix, lights_[i].direction};
+        }
+        lightsBuffer_.Update(lightsData);
+        const auto windowSize = Engine::GetInstance().GetWindowSize();
+        glViewport(0, 0, windowSize[0], windowSize[1]);
+        shadowShader_.Bind();
+        shadowShader_.SetTexture("material.texture_diffuse1", whiteTexture_, 0);
+        for (size_t i = 0; i < shadowMaps.size(); i++)
+        {
+            shadowShader_.SetTexture("shadowMaps[" + std::to_string(i) + "]", resources.GetTexture(shadowMaps[i]),
+                                     i + 3);
+        }
+        shadowShader_.SetInt("enableCascadeColor", flags_ & ENABLE_CASCADE_COLOR);
+        shadowShader_.SetInt("enableDepthColor", flags_ & ENABLE_DEPTH_COLOR);
+        shadowShader_.SetFloat("farPlane", camera_.farPlane);
+        shadowShader_.SetFloat("bias", shadowBias_);
+        shadowShader_.SetFloat("maxNearCascade", camera_.farPlane * cascadedNearRatio_);
+        shadowShader_.SetFloat("maxMiddleCascade", camera_.farPlane * cascadedMiddleRatio_);
+        RenderScene(shadowShader_);
+    });
+    if (flags_ & SHOW_DEPTH_TEXTURES)
     {
-        glDisable(GL_DEPTH_TEST);
-        screenShader_.Bind();
-        constexpr float miniMapSize = 1.0f/3.0f;
-        for (std::size_t i = 0; i < shadowMaps_.size(); i++)
+        frameGraph_.AddPass("Depth Textures Pass", [&shadowMaps](FrameGraph::PassBuilder& builder)
         {
-            screenShader_.SetVec2("offset", glm::vec2((1.0f - miniMapSize / camera_.aspect),
-                                                      1.0f - miniMapSize - (2.0f * i * miniMapSize)));
-            screenShader_.SetVec2("scale", glm::vec2(miniMapSize / camera_.aspect, miniMapSize));
+            for (const auto shadowMap : shadowMaps)
+            {
+                builder.Read(shadowMap);
+            }
+            builder.SetSideEffect();
+        }, [this, &shadowMaps](const FrameGraph::PassResources& resources)
+        {
+            StateCache::Disable(GL_DEPTH_TEST);
+            screenShader_.Bind();
+            constexpr float miniMapSize = 1.0f/3.0f;
+            for (std::size_t i = 0; i < shadowMaps.size(); i++)
+            {
+                screenShader_.SetVec2("offset", glm::vec2((1.0f - miniMapSize / camera_.aspect),
+                                                          1.0f - miniMapSize - (2.0f * i * miniMapSize)));
+                screenShader_.SetVec2("scale", glm::vec2(miniMapSize / camera_.aspect, miniMapSize));
 
-            screenShader_.SetInt("screenTexture", 0);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, shadowMaps_[i]);
-            screenPlane_.Draw();
-        }
-        glEnable(GL_DEPTH_TEST);
+                screenShader_.SetInt("screenTexture", 0);
+                StateCache::ActiveTexture(GL_TEXTURE0);
+                StateCache::BindTexture(GL_TEXTURE_2D, resources.GetTexture(shadowMaps[i]));
+                screenPlane_.Draw();
+            }
+            StateCache::Enable(GL_DEPTH_TEST);
+        });
     }
+    frameGraph_.Execute();
 }
 
 void HelloCascadedShadow::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     simpleDepthShader_.Destroy();
-    shadowFramebuffer_.Destroy();
     shadowShader_.Destroy();
     screenShader_.Destroy();
     screenPlane_.Destroy();
     plane_.Destroy();
-    model_.Destroy();
+    model_.reset();
     whiteTexture_.Destroy();
-    brickwall_.Destroy();
-    glDeleteTextures(shadowMaps_.size() - 1, &shadowMaps_[1]);
+    brickwall_.reset();
+    lightsBuffer_.Destroy();
+    cameraBuffer_.Destroy();
+    frameGraph_.Clear();
 }
 
 void HelloCascadedShadow::OnEvent(SDL_Event& event)
@@ -244,7 +263,6 @@ void HelloCascadedShadow::ShadowPass(int cascadeIndex)
     const auto cascadeFar = cascadeIndex == 0 ? camera_.farPlane * cascadedNearRatio_ :
                             cascadeIndex == 1 ? camera_.farPlane * cascadedMiddleRatio_ :
                             camera_.farPlane;
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMaps_[cascadeIndex], 0);
     glClear(GL_DEPTH_BUFFER_BIT);
 
 
@@ -266,6 +284,7 @@ void HelloCascadedShadow::RenderScene(gl::ShaderProgram& shader)
     ZoneNamedN(shadowUpdate, "Render Scene", true);
     TracyGpuNamedZone(shadowUpdateGpu, "Render Scene", true);
 #endif
+    renderQueue_.SetViewPosition(camera_.position, camera_.farPlane);
     for (int z = 0; z < 5; z++)
     {
         for (int x = -1; x < 2; x++)
@@ -275,11 +294,10 @@ void HelloCascadedShadow::RenderScene(gl::ShaderProgram& shader)
             model = glm::translate(model,
                                    glm::vec3(-10.0f * float(x), 0.0f, 10.0f * float(z) + 5.0f));
             model = glm::scale(model, glm::vec3(0.2f));
-            shader.SetMat4("model", model);
-            shader.SetMat4("transposeInverseModel", glm::transpose(glm::inverse(model)));
-            model_.Draw(shader);
+            renderQueue_.Submit(shader, *model_, model);
         }
     }
+    renderQueue_.Flush();
     auto model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(0, 0, 1) * camera_.farPlane / 2.0f);
     model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1, 0, 0));
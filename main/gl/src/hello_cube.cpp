@@ -1,6 +1,8 @@
 #include <algorithm>
 #include "hello_cube.h"
+#include "gl/asset_registry.h"
 #include "gl/error.h"
+#include "gl/state_cache.h"
 #include "imgui.h"
 #ifdef TRACY_ENABLE
 #include "tracy/Tracy.hpp"
@@ -13,10 +15,10 @@ namespace gl
 void HelloCube::Init()
 {
     cuboid_.Init();
-    cubeTexture_.LoadTexture("data/textures/brickwall.jpg");
+    cubeTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg");
     shader_.CreateDefaultProgram("data/shaders/03_hello_rotate_cube/cube.vert",
                                  "data/shaders/03_hello_rotate_cube/cube.frag");
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
     glCheckError();
 
     positions_ = {
@@ -61,7 +63,7 @@ void HelloCube::Update(core::seconds dt)
     projection = glm::perspective(glm::radians(45.0f), screenSize_.x / screenSize_.y, 0.1f, 100.0f);
     shader_.SetMat4("projection", projection);
 
-    shader_.SetTexture("ourTexture", cubeTexture_,0);
+    shader_.SetTexture("ourTexture", *cubeTexture_,0);
     for (std::size_t i = 0; i < cubeNmb; i++)
     {
         glm::mat4 model(1.0f);
@@ -74,11 +76,11 @@ void HelloCube::Update(core::seconds dt)
 
 void HelloCube::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     glCheckError();
     shader_.Destroy();
     cuboid_.Destroy();
-    cubeTexture_.Destroy();
+    cubeTexture_.reset();
 }
 
 void HelloCube::OnEvent(SDL_Event& event)
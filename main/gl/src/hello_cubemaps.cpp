@@ -3,6 +3,8 @@
 //
 
 #include "hello_cubemaps.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
 #include <imgui.h>
 
 namespace gl
@@ -23,7 +25,7 @@ void HelloCubemaps::Init()
     });
     ktxTexture_.LoadTexture("data/textures/skybox/skybox.ktx");
     ddsTexture_.LoadTexture("data/textures/skybox/skybox.dds");
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
     modelShader_.CreateDefaultProgram(
         "data/shaders/11_hello_cubemaps/model.vert",
         "data/shaders/11_hello_cubemaps/model.frag");
@@ -39,7 +41,7 @@ void HelloCubemaps::Init()
 
     camera_.Init();
 
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloCubemaps::Update(core::seconds dt)
@@ -61,7 +63,7 @@ void HelloCubemaps::Update(core::seconds dt)
             modelShader_.SetMat4("model", model);
             modelShader_.SetMat4("transposeInverseModel", glm::transpose(glm::inverse(model)));
 
-            model_.Draw(modelShader_);
+            model_->Draw(modelShader_);
             model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(-1, 0, 0) * 2.0f);
             modelShader_.SetMat4("model", model);
@@ -88,7 +90,7 @@ void HelloCubemaps::Update(core::seconds dt)
                                                   : textureExtension_ == TextureExtension::KTX
                                                   ? ktxTexture_
                                                   : ddsTexture_, 2);
-            model_.Draw(modelReflectionShader_);
+            model_->Draw(modelReflectionShader_);
             model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(-1, 0, 0) * 2.0f);
             modelReflectionShader_.SetMat4("model", model);
@@ -115,13 +117,13 @@ void HelloCubemaps::Update(core::seconds dt)
                                                             : textureExtension_ == TextureExtension::KTX
                                                             ? ktxTexture_
                                                             : ddsTexture_, 2);
-            model_.Draw(modelRefractionShader_);
+            model_->Draw(modelRefractionShader_);
             model = glm::mat4(1.0f);
             model = glm::translate(model, glm::vec3(-1, 0, 0) * 2.0f);
             modelRefractionShader_.SetMat4("model", model);
             modelRefractionShader_.SetMat4("transposeInverseModel", glm::transpose(glm::inverse(model)));
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, cubeTexture_.GetName());
+            StateCache::ActiveTexture(GL_TEXTURE0);
+            StateCache::BindTexture(GL_TEXTURE_2D, cubeTexture_.GetName());
             cube_.Draw();
             break;
         }
@@ -129,7 +131,7 @@ void HelloCubemaps::Update(core::seconds dt)
     }
 
     //Draw skybox
-    glDepthFunc(GL_LEQUAL);
+    StateCache::DepthFunc(GL_LEQUAL);
     skyboxShader_.Bind();
     skyboxShader_.SetMat4("view", glm::mat4(glm::mat3(view)));
     skyboxShader_.SetMat4("projection", projection);
@@ -147,19 +149,19 @@ void HelloCubemaps::Update(core::seconds dt)
     default: ;
     }
     skyboxCube_.Draw();
-    glDepthFunc(GL_LESS);
+    StateCache::DepthFunc(GL_LESS);
 }
 
 void HelloCubemaps::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     skyboxTexture_.Destroy();
     ktxTexture_.Destroy();
     ddsTexture_.Destroy();
     skyboxShader_.Destroy();
     skyboxCube_.Destroy();
 
-    model_.Destroy();
+    model_.reset();
     modelShader_.Destroy();
     modelRefractionShader_.Destroy();
     modelReflectionShader_.Destroy();
@@ -1,5 +1,7 @@
 #include "GL/glew.h"
 #include "hello_culling.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
 
 namespace gl
 {
@@ -8,13 +10,13 @@ namespace gl
 void HelloCulling::Init()
 {
     camera_.Init();
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
     modelShader_.CreateDefaultProgram(
             "data/shaders/12_hello_culling/model.vert",
             "data/shaders/12_hello_culling/model.frag");
     cube_.Init();
-    cubeTexture_.LoadTexture("data/textures/brickwall.ktx");
-    glEnable(GL_DEPTH_TEST);
+    cubeTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.ktx");
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloCulling::Update(core::seconds dt)
@@ -22,9 +24,9 @@ void HelloCulling::Update(core::seconds dt)
     camera_.Update(dt);
     if (flags_ & CULLING)
     {
-        glEnable(GL_CULL_FACE);
-        glCullFace(flags_ & BACK_CULLING ? GL_BACK : GL_FRONT);
-        glFrontFace(flags_ & CCW ? GL_CCW : GL_CW);
+        StateCache::Enable(GL_CULL_FACE);
+        StateCache::CullFace(flags_ & BACK_CULLING ? GL_BACK : GL_FRONT);
+        StateCache::FrontFace(flags_ & CCW ? GL_CCW : GL_CW);
     }
     modelShader_.Bind();
     modelShader_.SetMat4("view", camera_.GetView());
@@ -33,25 +35,25 @@ void HelloCulling::Update(core::seconds dt)
     model = glm::scale(model, glm::vec3(0.1f));
     modelShader_.SetMat4("model", model);
     modelShader_.SetMat4("transposeInverseModel", glm::transpose(glm::inverse(model)));
-    model_.Draw(modelShader_);
+    model_->Draw(modelShader_);
     model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(2.0f,0,0));
     modelShader_.SetMat4("model", model);
-    modelShader_.SetTexture("texture_diffuse1", cubeTexture_, 0);
+    modelShader_.SetTexture("texture_diffuse1", *cubeTexture_, 0);
     cube_.Draw();
 
     if (flags_ & CULLING)
     {
-        glDisable(GL_CULL_FACE);
+        StateCache::Disable(GL_CULL_FACE);
     }
 }
 
 void HelloCulling::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     cube_.Destroy();
-    cubeTexture_.Destroy();
-    model_.Destroy();
+    cubeTexture_.reset();
+    model_.reset();
     modelShader_.Destroy();
 }
 
@@ -1,4 +1,5 @@
 #include <hello_cutoff.h>
+#include <gl/state_cache.h>
 #include <imgui.h>
 
 namespace gl
@@ -14,7 +15,7 @@ void HelloCutoff::Init()
     cubeTexture_.LoadTexture("data/textures/container.jpg");
     whiteTexture_.CreateWhiteTexture();
     camera_.Init();
-	glEnable(GL_DEPTH_TEST);
+	StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloCutoff::Update(core::seconds dt)
@@ -72,7 +73,7 @@ void HelloCutoff::Update(core::seconds dt)
 void HelloCutoff::Destroy()
 {
 
-	glDisable(GL_DEPTH_TEST);
+	StateCache::Disable(GL_DEPTH_TEST);
     plane_.Destroy();
     cube_.Destroy();
     cutoffProgram_.Destroy();
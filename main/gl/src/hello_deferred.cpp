@@ -1,11 +1,17 @@
 #include <GL/glew.h>
 
 #include "hello_deferred.h"
+#include "gl/asset_registry.h"
+#include <algorithm>
+#include <array>
 #include <random>
 #include "fmt/core.h"
 #include <gl/framebuffer.h>
+#include <gl/render_target_pool.h>
 #include <gl/error.h>
+#include <gl/state_cache.h>
 #include <gl/shader.h>
+#include <gl/uniform_buffer.h>
 #include <engine.h>
 
 #include <glm/mat4x4.hpp>
@@ -40,20 +46,12 @@ void HelloDeferred::Init()
     container_.LoadTexture("data/textures/container2.png");
     containerSpecular_.LoadTexture("data/textures/container2_specular.png");
 
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
 
     camera_.Init();
     camera_.position = glm::vec3(0, 3, -3);
     camera_.LookAt(glm::vec3());
 
-    const auto windowSize = Engine::GetInstance().GetWindowSize();
-    gBuffer_.SetSize({windowSize[0], windowSize[1]});
-    gBuffer_.SetColorAttachmentNmb(3);
-    gBuffer_.SetType(Framebuffer::HDR | Framebuffer::COLOR_ATTACHMENT_0 |
-                     Framebuffer::DEPTH_RBO);
-	gBuffer_.SetChannelCount(4);
-    gBuffer_.Create();
-
     std::random_device rd;  //Will be used to obtain a seed for the random number engine
     std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
     std::uniform_real_distribution<> dis(0.0f, 1.0f);
@@ -69,8 +67,12 @@ void HelloDeferred::Init()
                                                                        2.0f));
         }
     }
+    //The lights do not move, both programs read them from the block uploaded once
+    cameraBuffer_.Create<CameraBlock>(UniformBlockBinding::CAMERA);
+    lightsBuffer_.Create<PointLightsBlock<LIGHT_NMB>>(UniformBlockBinding::LIGHTS);
+    lightsBuffer_.Update(lights_);
     glCheckError();
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloDeferred::Update(core::seconds dt)
@@ -80,6 +82,7 @@ void HelloDeferred::Update(core::seconds dt)
     TracyGpuNamedZone(updateGpu, "Update", true);
 #endif
     camera_.Update(dt);
+    cameraBuffer_.Update(CameraBlock{camera_.GetView(), camera_.GetProjection(), camera_.position});
 
     if (deferredRendering_)
     {
@@ -87,34 +90,31 @@ void HelloDeferred::Update(core::seconds dt)
         ZoneNamedN(deferred, "Deferred Rendering", true);
         TracyGpuNamedZone(deferredGpu, "Deferred Rendering", true);
 #endif
-        gBuffer_.Bind();
+        const auto windowSize = Engine::GetInstance().GetWindowSize();
+        const RenderTargetDesc gBufferDesc{windowSize[0], windowSize[1], GL_RGBA16F};
+        const std::array<unsigned int, 3> gBuffer = {RenderTargetPool::Acquire(gBufferDesc),
+                                                     RenderTargetPool::Acquire(gBufferDesc),
+                                                     RenderTargetPool::Acquire(gBufferDesc)};
+        const auto depthTarget = RenderTargetPool::Acquire({windowSize[0], windowSize[1], GL_DEPTH_COMPONENT16});
+        RenderTargetPool::BindFramebuffer({gBuffer[0], gBuffer[1], gBuffer[2]}, depthTarget);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         deferredShader_.Bind();
-        deferredShader_.SetMat4("view", camera_.GetView());
-        deferredShader_.SetMat4("projection", camera_.GetProjection());
 
         RenderScene(deferredShader_);
 
         Framebuffer::Unbind();
+        RenderTargetPool::Release(depthTarget);
 #ifdef TRACY_ENABLE
         ZoneNamedN(lighting, "Lighting Pass", true);
         TracyGpuNamedZone(lightingGpu, "Lighting Pass", true);
 #endif
         lightingShader_.Bind();
-        for (int i = 0; i < 32; i++)
-        {
-            lightingShader_.SetVec3(
-                    "lights[" + std::to_string(i) + "].position",
-                    lights_[i].position);
-            lightingShader_.SetVec3("lights[" + std::to_string(i) + "].color",
-                                    lights_[i].color);
-        }
-        lightingShader_.SetTexture("gPosition", gBuffer_.GetColorTexture(0), 0);
-        lightingShader_.SetTexture("gNormal", gBuffer_.GetColorTexture(1), 1);
-        lightingShader_.SetTexture("gAlbedoSpec", gBuffer_.GetColorTexture(2),
+        lightingShader_.SetTexture("gPosition", gBuffer[0], 0);
+        lightingShader_.SetTexture("gNormal", gBuffer[1], 1);
+        lightingShader_.SetTexture("gAlbedoSpec", gBuffer[2],
                                    2);
-        lightingShader_.SetVec3("viewPos", camera_.position);
         screenQuad_.Draw();
+        std::ranges::for_each(gBuffer, RenderTargetPool::Release);
     }
     else
     {
@@ -124,57 +124,47 @@ void HelloDeferred::Update(core::seconds dt)
         TracyGpuNamedZone(forwardGpu, "Forward Rendering", true);
 #endif
         forwardShader_.Bind();
-        forwardShader_.SetMat4("view", camera_.GetView());
-        forwardShader_.SetMat4("projection", camera_.GetProjection());
-        forwardShader_.SetVec3("viewPos", camera_.position);
-        for (int i = 0; i < 32; i++)
-        {
-            forwardShader_.SetVec3(fmt::format("lights[{}].position", i),
-                                   lights_[i].position);
-            forwardShader_.SetVec3(fmt::format("lights[{}].color", i),
-                                   lights_[i].color);
-        }
         RenderScene(forwardShader_);
     }
 }
 
 void HelloDeferred::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     cube_.Destroy();
     screenQuad_.Destroy();
     floor_.Destroy();
     forwardShader_.Destroy();
     lightingShader_.Destroy();
     deferredShader_.Destroy();
-    gBuffer_.Destroy();
+    lightsBuffer_.Destroy();
+    cameraBuffer_.Destroy();
     whiteTexture_.Destroy();
     containerSpecular_.Destroy();
     container_.Destroy();
-    model_.Destroy();
+    model_.reset();
 
 }
 
 void HelloDeferred::OnEvent(SDL_Event& event)
 {
     camera_.OnEvent(event);
-    if (event.type == SDL_WINDOWEVENT &&
-        event.window.event == SDL_WINDOWEVENT_RESIZED)
-    {
-        gBuffer_.SetSize({event.window.data1, event.window.data2});
-        gBuffer_.Reload();
-    }
 }
 
 void HelloDeferred::DrawImGui()
 {
     ImGui::Begin("Deferred Program");
     ImGui::Checkbox("Enable Deferred", &deferredRendering_);
+    const auto& queueStatistics = renderQueue_.GetStatistics();
+    ImGui::Text("Queued draws: %zu", queueStatistics.drawNmb);
+    ImGui::Text("Program changes: %zu material changes: %zu vertex array changes: %zu",
+                queueStatistics.programChangeNmb, queueStatistics.materialChangeNmb, queueStatistics.vaoChangeNmb);
     ImGui::End();
 }
 
 void HelloDeferred::RenderScene(ShaderProgram& shader)
 {
+    renderQueue_.SetViewPosition(camera_.position, camera_.farPlane);
     for (int x = -2; x < 3; x++)
     {
         for (int z = -2; z < 3; z++)
@@ -197,23 +187,21 @@ void HelloDeferred::RenderScene(ShaderProgram& shader)
                                glm::transpose(glm::inverse(model)));
                 cube_.Draw();
             }
-            {
+            model = glm::mat4(1.0f);
+            model = glm::translate(model,
+                                   glm::vec3(2.0f * (float(x) + 0.5f), 0.0f,
+                                             2.0f * (float(z) + 2.5f)));
+            model = glm::scale(model, glm::vec3(0.2f));
+            renderQueue_.Submit(shader, *model_, model);
+        }
+    }
+    {
 #ifdef TRACY_ENABLE
-                ZoneNamedN(drawModel, "Draw Cube", true);
-                TracyGpuNamedZone(drawModelGpu, "Draw Cube", true);
+        ZoneNamedN(drawModel, "Draw Models", true);
+        TracyGpuNamedZone(drawModelGpu, "Draw Models", true);
 #endif
-                model = glm::mat4(1.0f);
-                model = glm::translate(model,
-                                       glm::vec3(2.0f * (float(x) + 0.5f), 0.0f,
-                                                 2.0f * (float(z) + 2.5f)));
-                model = glm::scale(model, glm::vec3(0.2f));
-
-                shader.SetMat4("model", model);
-                shader.SetMat4("transposeInverseModel",
-                               glm::transpose(glm::inverse(model)));
-                model_.Draw(shader);
-            }
-        }
+        //Each mesh of the model is drawn for all the instances before the next one, its textures bound once
+        renderQueue_.Flush();
     }
 #ifdef TRACY_ENABLE
     ZoneNamedN(drawModel, "Draw Floor", true);
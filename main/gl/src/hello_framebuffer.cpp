@@ -3,6 +3,7 @@
 //
 
 #include "hello_framebuffer.h"
+#include "gl/state_cache.h"
 #include <imgui.h>
 namespace gl
 {
@@ -37,7 +38,7 @@ void HelloFramebuffer::Init()
             "data/shaders/10_hello_framebuffer/screen.vert",
             "data/shaders/10_hello_framebuffer/screen_inverse.frag");
 
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloFramebuffer::Update(core::seconds dt)
@@ -79,18 +80,18 @@ void HelloFramebuffer::Update(core::seconds dt)
     }
     Framebuffer::Unbind();
     currentShader->Bind();
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     currentShader->SetInt("screenTexture", 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, framebuffer_.GetColorTexture());
+    StateCache::ActiveTexture(GL_TEXTURE0);
+    StateCache::BindTexture(GL_TEXTURE_2D, framebuffer_.GetColorTexture());
     screenFrame_.Draw();
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloFramebuffer::Destroy()
 {
 
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     screenFrame_.Destroy();
     cube_.Destroy();
     containerTexture_.Destroy();
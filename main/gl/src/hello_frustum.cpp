@@ -1,6 +1,13 @@
 #include "GL/glew.h"
 #include "hello_frustum.h"
+#include "gl/asset_registry.h"
+#include "gl/error.h"
+#include "gl/state_cache.h"
+#include <cmath>
+#include <cstring>
 #include <random>
+#include <thread>
+#include <glm/common.hpp>
 #include "imgui.h"
 #ifdef TRACY_ENABLE
 
@@ -13,11 +20,8 @@ namespace gl
 {
     void HelloFrustum::Init()
     {
-        rockModel_.LoadModel("data/model/rock/rock.obj");
-        asteroidCulledPositions_.resize(maxAsteroidNmb_);
-        asteroidForces_.resize(maxAsteroidNmb_);
-        asteroidVelocities_.resize(maxAsteroidNmb_);
-        asteroidPositions_.resize(maxAsteroidNmb_);
+        rockModel_ = AssetRegistry::LoadModel("data/model/rock/rock.obj", Mesh::VertexFormat::FULL, maxLodCount_);
+        simulation_.Resize(maxAsteroidNmb_);
         //Calculate init pos and velocities
         std::random_device rd; //Will be used to obtain a seed for the random number engine
         std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
@@ -31,7 +35,7 @@ namespace gl
             position = glm::angleAxis(glm::radians(angle), glm::vec3(0, 1, 0)) *
                 position;
             position *= radius;
-            asteroidPositions_[i] = position;
+            simulation_.SetPosition(i, position);
         }
 
         vertexInstancingDrawShader_.CreateDefaultProgram(
@@ -53,16 +57,51 @@ namespace gl
         overviewFramebuffer_.SetSize({1024, 1024});
         overviewFramebuffer_.Create();
 
-        const auto& mesh = rockModel_.GetMesh(0);
-        glBindVertexArray(mesh.GetVao());
+        culledInstanceBuffer_.Create(sizeof(glm::vec3) * maxAsteroidNmb_);
         glGenBuffers(1, &instanceVBO_);
+        StateCache::BindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * maxAsteroidNmb_, nullptr, GL_DYNAMIC_COPY);
+        StateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
 
-        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+        //Binding 5 is switched between the stream buffer region and the occlusion culling output
+        const auto& mesh = rockModel_->GetMesh(0);
+        StateCache::BindVertexArray(mesh.GetVao());
         glEnableVertexAttribArray(5);
-        glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-        glVertexAttribDivisor(5, 1);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        glVertexAttribFormat(5, 3, GL_FLOAT, GL_FALSE, 0);
+        glVertexAttribBinding(5, 5);
+        glVertexBindingDivisor(5, 1);
+        glBindVertexBuffer(5, culledInstanceBuffer_.GetName(), 0, sizeof(glm::vec3));
+        StateCache::BindVertexArray(0);
+
+        workerQueue_ = std::make_unique<core::WorkerQueue>();
+        const auto workerNmb = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        for (unsigned i = 0; i < workerNmb; i++)
+        {
+            workerThreads_.push_back(std::make_unique<core::WorkerThread>(*workerQueue_));
+            workerThreads_.back()->Start();
+        }
+
+        hiZCopyShader_.CreateComputeProgram("data/shaders/14_hello_frustum/hiz_copy.comp");
+        hiZReduceShader_.CreateComputeProgram("data/shaders/14_hello_frustum/hiz_reduce.comp");
+        occlusionCullingShader_.CreateComputeProgram("data/shaders/14_hello_frustum/occlusion_culling.comp");
+
+        glGenBuffers(1, &drawCommandBuffer_);
+        StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer_);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * maxLodCount_, nullptr,
+                     GL_DYNAMIC_DRAW);
+        StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glGenBuffers(visibleCountBuffers_.size(), visibleCountBuffers_.data());
+        for (const auto visibleCountBuffer : visibleCountBuffers_)
+        {
+            StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, visibleCountBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, sizeof(DrawElementsIndirectCommand) * maxLodCount_, nullptr,
+                         GL_STREAM_READ);
+        }
+        StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glCheckError();
+
+        CreateHiZ();
     }
 
     void HelloFrustum::Update(core::seconds dt)
@@ -73,15 +112,85 @@ namespace gl
 #endif
         camera_.Update(dt);
         dt_ = dt.count();
-        asteroidCulledPositions_.clear();
-        CalculateForce(0, asteroidNmb_);
-        CalculateVelocity(0, asteroidNmb_);
-        CalculatePositions(0, asteroidNmb_);
-        Culling(0, asteroidNmb_);
+        auto* culledPositions = static_cast<glm::vec3*>(culledInstanceBuffer_.BeginRegion());
+        {
+#ifdef TRACY_ENABLE
+            ZoneNamedN(simulateAndCull, "Simulate And Cull", true);
+#endif
+            const auto chunkNmb = (asteroidNmb_ + jobChunkSize_ - 1) / jobChunkSize_;
+            chunkCulledPositions_.resize(chunkNmb);
+            std::vector<std::shared_ptr<core::Task>> tasks;
+            for (std::size_t chunk = 0; chunk < chunkNmb; chunk++)
+            {
+                const auto begin = chunk * jobChunkSize_;
+                const auto end = std::min<std::size_t>(begin + jobChunkSize_, asteroidNmb_);
+                auto task = std::make_shared<core::Task>([this, chunk, begin, end]()
+                {
+                    simulation_.Update(dt_, begin, end);
+                    Culling(begin, end, chunkCulledPositions_[chunk]);
+                });
+                workerQueue_->AddTask(task);
+                tasks.push_back(std::move(task));
+            }
+            for (auto& task : tasks)
+            {
+                task->Join();
+            }
+
+            //Group the survivors by LOD, the chunks copy theirs one after the other in each LOD range
+            std::vector<std::array<std::size_t, maxLodCount_>> chunkOffsets(chunkNmb);
+            std::size_t offset = 0;
+            for (std::size_t lod = 0; lod < maxLodCount_; lod++)
+            {
+                lodFirstInstance_[lod] = offset;
+                for (std::size_t chunk = 0; chunk < chunkNmb; chunk++)
+                {
+                    chunkOffsets[chunk][lod] = offset;
+                    offset += chunkCulledPositions_[chunk][lod].size();
+                }
+                lodInstanceNmb_[lod] = offset - lodFirstInstance_[lod];
+            }
+            culledAsteroidNmb_ = offset;
+
+            tasks.clear();
+            for (std::size_t chunk = 0; chunk < chunkNmb; chunk++)
+            {
+                auto task = std::make_shared<core::Task>([this, culledPositions, &chunkOffsets, chunk]()
+                {
+                    for (std::size_t lod = 0; lod < maxLodCount_; lod++)
+                    {
+                        const auto& positions = chunkCulledPositions_[chunk][lod];
+                        std::memcpy(culledPositions + chunkOffsets[chunk][lod], positions.data(),
+                                    sizeof(glm::vec3) * positions.size());
+                    }
+                });
+                workerQueue_->AddTask(task);
+                tasks.push_back(std::move(task));
+            }
+            for (auto& task : tasks)
+            {
+                task->Join();
+            }
+        }
+        if (enableOcclusionCulling_)
+        {
+            OcclusionCulling();
+        }
 
         vertexInstancingDrawShader_.Bind();
 
-        const auto& asteroidMesh = rockModel_.GetMesh(0);
+        const auto& asteroidMesh = rockModel_->GetMesh(0);
+        StateCache::BindVertexArray(asteroidMesh.GetVao());
+        if (enableOcclusionCulling_)
+        {
+            glBindVertexBuffer(5, instanceVBO_, 0, sizeof(glm::vec3));
+        }
+        else
+        {
+            glBindVertexBuffer(5, culledInstanceBuffer_.GetName(),
+                               static_cast<GLintptr>(culledInstanceBuffer_.GetRegionOffset()),
+                               sizeof(glm::vec3));
+        }
         asteroidMesh.BindTextures(vertexInstancingDrawShader_);
         const auto drawAsteroids = [this, &asteroidMesh]()
         {
@@ -89,25 +198,33 @@ namespace gl
             ZoneNamedN(drawAsteroidsCpu, "Draw Asteroids", true);
             TracyGpuNamedZone(drawAsteroidsGpu, "Draw Asteroids", true);
 #endif
-            const auto actualAsteroidNmb = asteroidCulledPositions_.size();
+            if (enableOcclusionCulling_)
+            {
+                //Occlusion culling wrote the visible instances and their count of each LOD on the GPU
+                StateCache::BindVertexArray(asteroidMesh.GetVao());
+                StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer_);
+                glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                            static_cast<GLsizei>(GetLodCount()), 0);
+                return;
+            }
 
-            for (std::size_t chunk = 0; chunk < actualAsteroidNmb / instanceChunkSize_ + 1; chunk++)
+            StateCache::BindVertexArray(asteroidMesh.GetVao());
+            for (std::size_t lod = 0; lod < GetLodCount(); lod++)
             {
-                const std::size_t chunkBeginIndex = chunk * instanceChunkSize_;
-                const std::size_t chunkEndIndex = std::min(actualAsteroidNmb, (chunk + 1) * instanceChunkSize_);
-                if (chunkEndIndex > chunkBeginIndex)
+                const auto& meshLod = asteroidMesh.GetLod(lod);
+                const auto lodAsteroidNmb = lodInstanceNmb_[lod];
+                for (std::size_t chunk = 0; chunk < lodAsteroidNmb / instanceChunkSize_ + 1; chunk++)
                 {
-                    const std::size_t chunkSize = chunkEndIndex - chunkBeginIndex;
-
-                    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
-                    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * chunkSize,
-                                 &asteroidCulledPositions_[chunkBeginIndex],
-                                 GL_DYNAMIC_DRAW);
-                    glBindBuffer(GL_ARRAY_BUFFER, 0);
-                    glBindVertexArray(asteroidMesh.GetVao());
-                    glDrawElementsInstanced(GL_TRIANGLES, asteroidMesh.GetIndicesCount(), GL_UNSIGNED_INT, 0,
-                                            chunkSize);
-                    glBindVertexArray(0);
+                    const std::size_t chunkBeginIndex = chunk * instanceChunkSize_;
+                    const std::size_t chunkEndIndex = std::min(lodAsteroidNmb, (chunk + 1) * instanceChunkSize_);
+                    if (chunkEndIndex > chunkBeginIndex)
+                    {
+                        const std::size_t chunkSize = chunkEndIndex - chunkBeginIndex;
+                        glDrawElementsInstancedBaseInstance(
+                                GL_TRIANGLES, meshLod.indexCount, GL_UNSIGNED_INT,
+                                reinterpret_cast<void*>(meshLod.firstIndex * sizeof(unsigned int)),
+                                chunkSize, lodFirstInstance_[lod] + chunkBeginIndex);
+                    }
                 }
             }
         };
@@ -120,25 +237,48 @@ namespace gl
         vertexInstancingDrawShader_.SetMat4("projection", overCamera_.GetProjection());
         drawAsteroids();
 
-        Framebuffer::Unbind();
         const auto screenSize = Engine::GetInstance().GetWindowSize();
+        if (enableOcclusionCulling_)
+        {
+            //The main view needs a sampleable depth for the next frame Hi-Z
+            sceneFramebuffer_.Bind();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+        else
+        {
+            Framebuffer::Unbind();
+        }
         glViewport(0, 0, screenSize[0], screenSize[1]);
         vertexInstancingDrawShader_.SetMat4("view", camera_.GetView());
         vertexInstancingDrawShader_.SetMat4("projection", camera_.GetProjection());
         drawAsteroids();
+        if (enableOcclusionCulling_)
+        {
+            BuildHiZ();
+            previousViewProjection_ = camera_.GetProjection() * camera_.GetView();
+
+            sceneFramebuffer_.Bind();
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, screenSize[0], screenSize[1],
+                              0, 0, screenSize[0], screenSize[1],
+                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            Framebuffer::Unbind();
+            glCheckError();
+        }
+        culledInstanceBuffer_.EndRegion();
 
         //Draw the mini view on top left
-        glDisable(GL_DEPTH_TEST);
+        StateCache::Disable(GL_DEPTH_TEST);
         screenShader_.Bind();
         const float miniMapSize = 0.2f;
         screenShader_.SetVec2("offset", glm::vec2((1.0f - miniMapSize / camera_.aspect), 1.0f - miniMapSize));
         screenShader_.SetVec2("scale", glm::vec2(miniMapSize / camera_.aspect, miniMapSize));
 
         screenShader_.SetInt("screenTexture", 0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, overviewFramebuffer_.GetColorTexture());
+        StateCache::ActiveTexture(GL_TEXTURE0);
+        StateCache::BindTexture(GL_TEXTURE_2D, overviewFramebuffer_.GetColorTexture());
         screenPlan_.Draw();
-        glEnable(GL_DEPTH_TEST);
+        StateCache::Enable(GL_DEPTH_TEST);
     }
 
     void HelloFrustum::Destroy()
@@ -147,12 +287,44 @@ namespace gl
         screenShader_.Destroy();
         screenPlan_.Destroy();
         overviewFramebuffer_.Destroy();
-        rockModel_.Destroy();
+        rockModel_.reset();
+
+        hiZCopyShader_.Destroy();
+        hiZReduceShader_.Destroy();
+        occlusionCullingShader_.Destroy();
+        DestroyHiZ();
+        StateCache::DeleteBuffers(1, &drawCommandBuffer_);
+        drawCommandBuffer_ = 0;
+        StateCache::DeleteBuffers(visibleCountBuffers_.size(), visibleCountBuffers_.data());
+        visibleCountBuffers_.fill(0);
+        for (auto& fence : visibleCountFences_)
+        {
+            if (fence != nullptr)
+            {
+                glDeleteSync(static_cast<GLsync>(fence));
+                fence = nullptr;
+            }
+        }
+        StateCache::DeleteBuffers(1, &instanceVBO_);
+        instanceVBO_ = 0;
+        culledInstanceBuffer_.Destroy();
+        workerQueue_->Destroy();
+        for (auto& workerThread : workerThreads_)
+        {
+            workerThread->Destroy();
+        }
+        workerThreads_.clear();
+        workerQueue_.reset();
     }
 
     void HelloFrustum::OnEvent(SDL_Event& event)
     {
         camera_.OnEvent(event);
+        if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_RESIZED)
+        {
+            DestroyHiZ();
+            CreateHiZ();
+        }
     }
 
     void HelloFrustum::DrawImGui()
@@ -165,51 +337,44 @@ namespace gl
         const uint64_t maxChunkSize = 10'000;
         ImGui::SliderScalar("Instance Chunk Size", ImGuiDataType_U64, &instanceChunkSize_, &minChunkSize,
                             &maxChunkSize);
-        ImGui::LabelText("Asteroid Actual Nmb", "%zu", asteroidCulledPositions_.size());
-        ImGui::End();
-    }
-
-    void HelloFrustum::CalculateForce(uint64_t begin, uint64_t end)
-    {
-        const uint64_t endCount = std::min(end, asteroidNmb_);
-        for (auto i = begin; i < endCount; i++)
+        ImGui::LabelText("Asteroid Actual Nmb", "%zu", culledAsteroidNmb_);
+        ImGui::Checkbox("LOD", &enableLod_);
+        if (enableLod_)
+        {
+            ImGui::SliderFloat("LOD Screen Size", &lodScreenSize_, 0.01f, 0.5f);
+            const auto& asteroidMesh = rockModel_->GetMesh(0);
+            for (std::size_t lod = 0; lod < GetLodCount(); lod++)
+            {
+                ImGui::Text("LOD %zu: %zu triangles, %zu asteroids", lod,
+                            asteroidMesh.GetLod(lod).indexCount / 3, lodInstanceNmb_[lod]);
+            }
+        }
+        if (ImGui::Checkbox("Hi-Z Occlusion Culling", &enableOcclusionCulling_))
         {
-            const auto deltaToCenter = glm::vec3(0.0f) - asteroidPositions_[i];
-            const auto r = glm::length(deltaToCenter);
-            const auto force = gravityConst * centerMass * asteroidMass / (r * r);
-            asteroidForces_[i] = deltaToCenter / r * force;
+            hiZReady_ = false;
+            occlusionVisibleNmb_ = 0;
         }
-    }
-
-    void HelloFrustum::CalculateVelocity(uint64_t begin, uint64_t end)
-    {
-        const uint64_t endCount = std::min(end, asteroidNmb_);
-        for (auto i = begin; i < endCount; i++)
+        if (enableOcclusionCulling_)
         {
-            const auto deltaToCenter = glm::vec3() - asteroidPositions_[i];
-            auto velDir = glm::vec3(-deltaToCenter.z, 0.0f, deltaToCenter.x);
-            velDir = glm::normalize(velDir);
-
-            const auto speed = std::sqrt(glm::length(asteroidForces_[i]) / asteroidMass * glm::length(deltaToCenter));
-            asteroidVelocities_[i] = velDir * speed;
+            ImGui::LabelText("Asteroid Visible Nmb", "%u", occlusionVisibleNmb_);
+            ImGui::LabelText("Occlusion Culled Nmb", "%zu",
+                             culledAsteroidNmb_ -
+                             std::min<std::size_t>(occlusionVisibleNmb_, culledAsteroidNmb_));
         }
+        ImGui::End();
     }
 
-    void HelloFrustum::CalculatePositions(uint64_t begin, uint64_t end)
+    std::size_t HelloFrustum::GetLodCount() const
     {
-        const uint64_t endCount = std::min(end, asteroidNmb_);
-        for (auto i = begin; i < endCount; i++)
-        {
-            asteroidPositions_[i] += asteroidVelocities_[i] * dt_;
-        }
+        return std::min(rockModel_->GetMesh(0).GetLodCount(), maxLodCount_);
     }
 
-    void HelloFrustum::Culling(unsigned long begin, unsigned long end)
+    void HelloFrustum::Culling(std::size_t begin, std::size_t end, LodPositions& culledPositions)
     {
 #ifdef TRACY_ENABLE
         ZoneNamedN(cullingCpu, "Frustum Culling", true);
 #endif
-        const auto& asteroidMesh = rockModel_.GetMesh(0);
+        const auto& asteroidMesh = rockModel_->GetMesh(0);
         const auto asteroidRadius = glm::length(asteroidMesh.GetMax() - asteroidMesh.GetMin()) / 2.0f;
         const auto cameraDir = camera_.direction;
         const auto cameraLeftDir = camera_.leftDir;
@@ -224,19 +389,22 @@ namespace gl
         const auto topNormal = topQuaternion * cameraUp;
         const auto bottomQuaternion = glm::angleAxis(glm::radians(camera_.fovY) / 2.0f, cameraLeftDir);
         const auto bottomNormal = bottomQuaternion * -cameraUp;
+        const auto tanHalfFovY = std::tan(glm::radians(camera_.fovY) / 2.0f);
+        const auto lodCount = enableLod_ ? GetLodCount() : 1;
 
-        //asteroidCulledPositions_ = asteroidPositions_;
-        //return;
+        for (auto& positions : culledPositions)
+        {
+            positions.clear();
+        }
         for (auto i = begin; i < end; i++)
         {
-            const auto asteroidPos = asteroidPositions_[i];
+            const auto asteroidPos = simulation_.GetPosition(i);
             const auto asterPos = asteroidPos - camera_.position;
+            const auto depth = glm::dot(cameraDir, asterPos);
             //Near and Far
             {
-                const auto planePos = camera_.position + cameraDir * camera_.nearPlane;
-                const auto v = glm::dot(cameraDir, asterPos);
-                if (v < -asteroidRadius + camera_.nearPlane ||
-                    v > asteroidRadius + camera_.farPlane)
+                if (depth < -asteroidRadius + camera_.nearPlane ||
+                    depth > asteroidRadius + camera_.farPlane)
                     continue;
             }
 
@@ -274,7 +442,174 @@ namespace gl
                 }
             }
 
-            asteroidCulledPositions_.push_back(asteroidPositions_[i]);
+            //Part of the screen height covered by the asteroid
+            const auto screenSize = asteroidRadius / (std::max(depth, camera_.nearPlane) * tanHalfFovY);
+            std::size_t lod = 0;
+            auto lodScreenSize = lodScreenSize_;
+            while (lod + 1 < lodCount && screenSize < lodScreenSize)
+            {
+                lod++;
+                lodScreenSize /= 2.0f;
+            }
+            culledPositions[lod].push_back(asteroidPos);
+        }
+    }
+
+    void HelloFrustum::CreateHiZ()
+    {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+        TracyGpuZone("Create Hi-Z");
+#endif
+        const auto windowSize = Engine::GetInstance().GetWindowSize();
+        sceneFramebuffer_.SetSize({windowSize[0], windowSize[1]});
+        sceneFramebuffer_.SetType(Framebuffer::COLOR_ATTACHMENT_0 | Framebuffer::DEPTH_ATTACHMENT);
+        sceneFramebuffer_.Create();
+        //The depth attachment is set up for shadow comparison, we read raw depth values
+        StateCache::BindTexture(GL_TEXTURE_2D, sceneFramebuffer_.GetDepthTexture());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+        hiZMipCount_ = 1 + static_cast<int>(std::floor(std::log2(std::max(windowSize[0], windowSize[1]))));
+        glGenTextures(1, &hiZTexture_);
+        StateCache::BindTexture(GL_TEXTURE_2D, hiZTexture_);
+        glTexStorage2D(GL_TEXTURE_2D, hiZMipCount_, GL_R32F, windowSize[0], windowSize[1]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        StateCache::BindTexture(GL_TEXTURE_2D, 0);
+        glCheckError();
+        hiZReady_ = false;
+    }
+
+    void HelloFrustum::DestroyHiZ()
+    {
+        sceneFramebuffer_.Destroy();
+        if (hiZTexture_ != 0)
+        {
+            StateCache::DeleteTextures(1, &hiZTexture_);
+            hiZTexture_ = 0;
+        }
+        hiZReady_ = false;
+    }
+
+    void HelloFrustum::BuildHiZ()
+    {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+        TracyGpuZone("Build Hi-Z");
+#endif
+        constexpr int groupSize = 8;
+        const auto size = sceneFramebuffer_.GetSize();
+        hiZCopyShader_.Bind();
+        hiZCopyShader_.SetTexture("depthTexture", sceneFramebuffer_.GetDepthTexture(), 0);
+        glBindImageTexture(0, hiZTexture_, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glDispatchCompute((size.x + groupSize - 1) / groupSize, (size.y + groupSize - 1) / groupSize, 1);
+
+        hiZReduceShader_.Bind();
+        auto levelSize = size;
+        for (int level = 1; level < hiZMipCount_; level++)
+        {
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            levelSize = glm::max(levelSize / 2, glm::ivec2(1));
+            glBindImageTexture(0, hiZTexture_, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glBindImageTexture(1, hiZTexture_, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            glDispatchCompute((levelSize.x + groupSize - 1) / groupSize, (levelSize.y + groupSize - 1) / groupSize, 1);
+        }
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        glCheckError();
+        hiZReady_ = true;
+    }
+
+    void HelloFrustum::OcclusionCulling()
+    {
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+        TracyGpuZone("Occlusion Culling");
+#endif
+        const auto& asteroidMesh = rockModel_->GetMesh(0);
+        const auto asteroidRadius = glm::length(asteroidMesh.GetMax() - asteroidMesh.GetMin()) / 2.0f;
+        const auto lodCount = GetLodCount();
+
+        //The visible instances of each LOD are compacted from the start of its range of frustum culled ones
+        std::array<DrawElementsIndirectCommand, maxLodCount_> commands{};
+        for (std::size_t lod = 0; lod < lodCount; lod++)
+        {
+            const auto& meshLod = asteroidMesh.GetLod(lod);
+            commands[lod] = {static_cast<GLuint>(meshLod.indexCount), 0,
+                             static_cast<GLuint>(meshLod.firstIndex), 0,
+                             static_cast<GLuint>(lodFirstInstance_[lod])};
+        }
+        StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer_);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(commands), commands.data());
+        StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        //The frustum culled positions are read straight from the current stream buffer region
+        StateCache::BindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, culledInstanceBuffer_.GetName(),
+                                    static_cast<GLintptr>(culledInstanceBuffer_.GetRegionOffset()),
+                                    static_cast<GLsizeiptr>(culledInstanceBuffer_.GetRegionSize()));
+        StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, instanceVBO_);
+        StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, drawCommandBuffer_);
+
+        occlusionCullingShader_.Bind();
+        occlusionCullingShader_.SetTexture("hiZ", hiZTexture_, 0);
+        occlusionCullingShader_.SetMat4("viewProjection", previousViewProjection_);
+        occlusionCullingShader_.SetFloat("radius", asteroidRadius);
+        occlusionCullingShader_.SetInt("hiZMipCount", hiZMipCount_);
+        occlusionCullingShader_.SetInt("enableHiZ", hiZReady_);
+        constexpr GLuint groupSize = 64;
+        for (std::size_t lod = 0; lod < lodCount; lod++)
+        {
+            const auto instanceCount = static_cast<GLuint>(lodInstanceNmb_[lod]);
+            if (instanceCount == 0)
+            {
+                continue;
+            }
+            occlusionCullingShader_.SetInt("lod", static_cast<int>(lod));
+            occlusionCullingShader_.SetInt("instanceCount", static_cast<int>(instanceCount));
+            glDispatchCompute((instanceCount + groupSize - 1) / groupSize, 1, 1);
+        }
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+        //Read the copies of the previous frames the GPU is done with, oldest first so the newest count stays,
+        //a copy still in flight keeps the last count rather than waiting for it
+        const auto currentIndex = frameIndex_ % visibleCountBufferNmb_;
+        for (std::size_t i = 0; i < visibleCountBufferNmb_; i++)
+        {
+            const auto index = (currentIndex + i) % visibleCountBufferNmb_;
+            auto& fence = visibleCountFences_[index];
+            if (fence == nullptr)
+            {
+                continue;
+            }
+            const auto sync = static_cast<GLsync>(fence);
+            const auto waitResult = glClientWaitSync(sync, 0, 0);
+            if (waitResult == GL_TIMEOUT_EXPIRED && index != currentIndex)
+            {
+                continue;
+            }
+            if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED)
+            {
+                StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, visibleCountBuffers_[index]);
+                glGetBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(commands), commands.data());
+                occlusionVisibleNmb_ = 0;
+                for (const auto& command : commands)
+                {
+                    occlusionVisibleNmb_ += command.instanceCount;
+                }
+            }
+            //The current buffer is written again below, a count it still waits for is dropped
+            glDeleteSync(sync);
+            fence = nullptr;
         }
+        StateCache::BindBuffer(GL_COPY_READ_BUFFER, drawCommandBuffer_);
+        StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, visibleCountBuffers_[currentIndex]);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            sizeof(DrawElementsIndirectCommand) * maxLodCount_);
+        visibleCountFences_[currentIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        StateCache::BindBuffer(GL_COPY_READ_BUFFER, 0);
+        StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        frameIndex_++;
+        glCheckError();
     }
 }
@@ -1,5 +1,7 @@
 #include <GL/glew.h>
 #include "hello_hdr.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
 #include <imgui.h>
 
 
@@ -9,9 +11,9 @@ void HelloHdr::Init()
 {
     cube_.Init();
     cubeShader_.CreateDefaultProgram("data/shaders/19_hello_hdr/tunnel.vert", "data/shaders/19_hello_hdr/tunnel.frag");
-    cubeTexture_.LoadTexture("data/textures/brickwall.jpg",
-                             Texture::MIRROR_REPEAT_WRAP | Texture::GAMMA_CORRECTION | Texture::MIPMAP |
-                             Texture::SMOOTH);
+    cubeTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg",
+                                              Texture::MIRROR_REPEAT_WRAP | Texture::GAMMA_CORRECTION |
+                                              Texture::MIPMAP | Texture::SMOOTH);
     hdrQuad_.Init();
     hdrFrambuffer_.SetType(Framebuffer::HDR | Framebuffer::COLOR_ATTACHMENT_0 | Framebuffer::DEPTH_RBO);
     const auto windowSize = Engine::GetInstance().GetWindowSize();
@@ -24,7 +26,7 @@ void HelloHdr::Init()
     camera_.position = glm::vec3();
     camera_.LookAt(glm::vec3(0, 0, 1));
 
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloHdr::Update(core::seconds dt)
@@ -39,7 +41,7 @@ void HelloHdr::Update(core::seconds dt)
     cubeShader_.SetMat4("projection", camera_.GetProjection());
     cubeShader_.SetMat4("model", glm::mat4(1.0f));
     cubeShader_.SetMat4("transposeInverseModel", glm::mat4(1.0f));
-    cubeShader_.SetTexture("diffuseTexture", cubeTexture_, 0);
+    cubeShader_.SetTexture("diffuseTexture", *cubeTexture_, 0);
     for (size_t i = 0; i < lights_.size(); i++)
     {
         cubeShader_.SetVec3("lights[" + std::to_string(i) + "].Position", lights_[i].lightPos_);
@@ -60,10 +62,10 @@ void HelloHdr::Update(core::seconds dt)
 
 void HelloHdr::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     cube_.Destroy();
     cubeShader_.Destroy();
-    cubeTexture_.Destroy();
+    cubeTexture_.reset();
 
     hdrQuad_.Destroy();
     hdrFrambuffer_.Destroy();
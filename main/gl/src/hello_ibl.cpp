@@ -2,6 +2,7 @@
 #include "hello_ibl.h"
 
 #include "gl/error.h"
+#include "gl/state_cache.h"
 #include <fmt/core.h>
 #include <imgui.h>
 
@@ -44,13 +45,15 @@ void HelloIbl::Init()
     camera_.Init();
     camera_.position = glm::vec3(0, 0, 30.0f);
     camera_.LookAt(glm::vec3());
-
+    cameraBuffer_.Create<CameraBlock>(UniformBlockBinding::CAMERA);
+    lightsBuffer_.Create<PointLightsBlock<4>>(UniformBlockBinding::LIGHTS);
+    lightsBuffer_.Update(lights_);
 
     GenerateCubemap();
     GenerateDiffuseIrradiance();
     GeneratePrefilter();
     GenerateLUT();
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 
     auto& engine = Engine::GetInstance();
     const auto windowSize = engine.GetWindowSize();
@@ -60,9 +63,8 @@ void HelloIbl::Init()
 void HelloIbl::Update(core::seconds dt)
 {
     camera_.Update(dt);
+    cameraBuffer_.Update(CameraBlock{camera_.GetView(), camera_.GetProjection(), camera_.position});
 
-    const auto view = camera_.GetView();
-    const auto projection = camera_.GetProjection();
     //Render PBR spheres
     const int nrRows = 7;
     const int nrColumns = 7;
@@ -73,18 +75,9 @@ void HelloIbl::Update(core::seconds dt)
     pbrShader_.SetInt("gammaCorrect", true);
     pbrShader_.SetFloat("ao", 1.0f);
     pbrShader_.SetVec3("albedo", baseColor_);
-    pbrShader_.SetMat4("view", view);
-    pbrShader_.SetVec3("viewPos", camera_.position);
-    pbrShader_.SetMat4("projection", projection);
     pbrShader_.SetTexture("irradianceMap", irradianceMap_, 0);
     pbrShader_.SetTexture("prefilterMap", prefilterMap_, 1);
     pbrShader_.SetTexture("brdfLUT", brdfLUTTexture_, 2);
-    for (size_t i = 0; i < lights_.size(); i++)
-    {
-        pbrShader_.SetVec3(fmt::format("lights[{}].position", i), lights_[i].position);
-        pbrShader_.SetVec3(fmt::format("lights[{}].color", i), lights_[i].color);
-
-    }
     for (int row = 0; row < nrRows; ++row)
     {
         pbrShader_.SetFloat("metallic", static_cast<float>(row) / static_cast<float>(nrRows - 1));
@@ -106,21 +99,21 @@ void HelloIbl::Update(core::seconds dt)
         }
     }
     //Render skybox
-    glDepthFunc(GL_LEQUAL);
+    StateCache::DepthFunc(GL_LEQUAL);
     skyboxShader_.Bind();
-    skyboxShader_.SetMat4("view", view);
-    skyboxShader_.SetMat4("projection", projection);
     skyboxShader_.SetTexture("environmentMap",
         flags_ & SHOW_PREFILTER ? prefilterMap_ : (flags_ & SHOW_IRRADIANCE ? irradianceMap_ : envCubemap_), 0);
     skybox_.Draw();
-    glDepthFunc(GL_LESS);
+    StateCache::DepthFunc(GL_LESS);
     glCheckError();
 }
 
 void HelloIbl::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     hdrTexture_.Destroy();
+    lightsBuffer_.Destroy();
+    cameraBuffer_.Destroy();
     sphere_.Destroy();
     quad_.Destroy();
     skybox_.Destroy();
@@ -277,11 +270,11 @@ void HelloIbl::GeneratePrefilter()
     captureFramebuffer_.Reload();
     captureFramebuffer_.Bind();
     const auto colorBuffer = captureFramebuffer_.GetColorTexture(0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, colorBuffer);
+    StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, colorBuffer);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     // be sure to set minifcation filter to mip_linear 
     glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     glCheckError();
     prefilterShader_.Bind();
     prefilterShader_.SetTexture("environmentMap", envCubemap_, 0);
@@ -335,14 +328,14 @@ void HelloIbl::GenerateLUT()
     captureFramebuffer_.SetSize({ lutSize_.x,lutSize_.y });
     captureFramebuffer_.SetChannelCount(2);
     captureFramebuffer_.Reload();
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     captureFramebuffer_.Bind();
     glViewport(0, 0, lutSize_.x, lutSize_.y);
     brdfShader_.Bind();
     glClear(GL_COLOR_BUFFER_BIT);
     quad_.Draw();
     brdfLUTTexture_.SetName(captureFramebuffer_.MoveColorTexture(0));
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
     Framebuffer::Unbind();
 }
 }
@@ -1,6 +1,9 @@
 #include "GL/glew.h"
 #include "hello_instancing.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
 #include <random>
+#include <thread>
 #include <fmt/core.h>
 #include <imgui.h>
 
@@ -11,15 +14,14 @@
 
 namespace gl
 {
+using namespace literals;
 
 void HelloInstancing::Init()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    asteroidPositions_.resize(maxAsteroidNmb_);
-    asteroidForces_.resize(maxAsteroidNmb_);
-    asteroidVelocities_.resize(maxAsteroidNmb_);
+    simulation_.Resize(maxAsteroidNmb_);
     //Calculate init pos and velocities
     std::random_device rd;  //Will be used to obtain a seed for the random number engine
     std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
@@ -33,22 +35,30 @@ void HelloInstancing::Init()
         position = glm::angleAxis(glm::radians(angle), glm::vec3(0, 1, 0)) *
                    position;
         position *= radius;
-        asteroidPositions_[i] = position;
+        simulation_.SetPosition(i, position);
     }
 
-    rockModel_.LoadModel("data/model/rock/rock.obj");
-    const auto& asteroidMesh = rockModel_.GetMesh(0);
+    //Vertex fetch is a large part of drawing that many asteroids, the quantized vertices take 20 bytes instead of 44
+    rockModel_ = AssetRegistry::LoadModel("data/model/rock/rock.obj", Mesh::VertexFormat::QUANTIZED);
+    const auto& asteroidMesh = rockModel_->GetMesh(0);
 
-    glBindVertexArray(asteroidMesh.GetVao());
-    glGenBuffers(1, &instanceVBO_);
-
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+    instanceBuffer_.Create(sizeof(glm::vec3) * maxAsteroidNmb_);
+    //The instance positions come from the current stream buffer region bound on binding 5 each frame
+    StateCache::BindVertexArray(asteroidMesh.GetVao());
     glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3),
-                          (void*) 0);
-    glVertexAttribDivisor(5, 1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    glVertexAttribFormat(5, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexAttribBinding(5, 5);
+    glVertexBindingDivisor(5, 1);
+    glBindVertexBuffer(5, instanceBuffer_.GetName(), 0, sizeof(glm::vec3));
+    StateCache::BindVertexArray(0);
+
+    workerQueue_ = std::make_unique<core::WorkerQueue>();
+    const auto workerNmb = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned i = 0; i < workerNmb; i++)
+    {
+        workerThreads_.push_back(std::make_unique<core::WorkerThread>(*workerQueue_));
+        workerThreads_.back()->Start();
+    }
     singleDrawShader_.CreateDefaultProgram(
             "data/shaders/13_hello_instancing/asteroid_single.vert",
             "data/shaders/13_hello_instancing/asteroid.frag");
@@ -58,6 +68,23 @@ void HelloInstancing::Init()
     vertexInstancingDrawShader_.CreateDefaultProgram(
             "data/shaders/13_hello_instancing/asteroid_vertex_instancing.vert",
             "data/shaders/13_hello_instancing/asteroid.frag");
+    gpuInstancingDrawShader_.CreateDefaultProgram(
+            "data/shaders/13_hello_instancing/asteroid_gpu_instancing.vert",
+            "data/shaders/13_hello_instancing/asteroid_gpu.frag");
+    centerMassComputeShader_.CreateComputeProgram(
+            "data/shaders/13_hello_instancing/asteroid_center_mass.comp");
+    nbodyComputeShader_.CreateComputeProgram(
+            "data/shaders/13_hello_instancing/asteroid_nbody.comp");
+
+    glGenBuffers(positionSsbos_.size(), positionSsbos_.data());
+    glGenBuffers(1, &velocitySsbo_);
+    for (const auto ssbo : {positionSsbos_[0], positionSsbos_[1], velocitySsbo_})
+    {
+        StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec4) * maxAsteroidNmb_,
+                     nullptr, GL_DYNAMIC_COPY);
+    }
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     camera_.Init();
     camera_.position = glm::vec3(0.0f, 500.0f, -500.0f);
     camera_.farPlane = 1'000.0f;
@@ -72,9 +99,16 @@ void HelloInstancing::Update(core::seconds dt)
 #endif
     camera_.Update(dt);
     dt_ = dt.count();
-    CalculateForce(0, asteroidNmb_);
-    CalculateVelocity(0, asteroidNmb_);
-    CalculatePositions(0, asteroidNmb_);
+    if (simulationType_ != SimulationType::CPU)
+    {
+        UpdateGpu();
+        return;
+    }
+    //Buffer instancing integrates the asteroids on the workers while filling the instance buffer
+    if (instancingType_ != InstancingType::BUFFER_INSTANCING)
+    {
+        simulation_.Update(dt_, 0, asteroidNmb_);
+    }
 
     switch (instancingType_)
     {
@@ -85,10 +119,11 @@ void HelloInstancing::Update(core::seconds dt)
             singleDrawShader_.SetMat4("view", camera_.GetView());
             singleDrawShader_.SetMat4("projection", camera_.GetProjection());
 
+            const auto positionLocation = singleDrawShader_.GetUniformLocation("position"_uniform);
             for (std::size_t i = 0; i < asteroidNmb_; i++)
             {
-                singleDrawShader_.SetVec3("position", asteroidPositions_[i]);
-                rockModel_.Draw(singleDrawShader_);
+                singleDrawShader_.SetVec3(positionLocation, simulation_.GetPosition(i));
+                rockModel_->Draw(singleDrawShader_);
             }
             break;
         }
@@ -100,12 +135,16 @@ void HelloInstancing::Update(core::seconds dt)
                               true);
 #endif
             uniformInstancingShader_.Bind();
-            const auto& asteroidMesh = rockModel_.GetMesh(0);
+            const auto& asteroidMesh = rockModel_->GetMesh(0);
             asteroidMesh.BindTextures(uniformInstancingShader_);
+            asteroidMesh.BindQuantization(uniformInstancingShader_);
             uniformInstancingShader_.SetMat4("view",
                                              camera_.GetView());
             uniformInstancingShader_.SetMat4("projection",
                                              camera_.GetProjection());
+            //The whole chunk goes in a single upload of the position array
+            const auto positionLocation = uniformInstancingShader_.GetUniformLocation("position"_uniform);
+            std::vector<glm::vec3> chunkPositions(uniformChunkSize_);
 
             for (std::size_t chunk = 0;
                  chunk < asteroidNmb_ / uniformChunkSize_ + 1; chunk++)
@@ -120,14 +159,10 @@ void HelloInstancing::Update(core::seconds dt)
                     TracyGpuNamedZone(uploadUniformGpu, "Upload Uniforms GPU",
                                       true);
 #endif
-                    for (size_t index = chunkBeginIndex;
-                         index < chunkEndIndex; index++)
-                    {
-                        const std::string uniformName = fmt::format("position[{}]", index -
-                                                                       chunkBeginIndex);
-                        uniformInstancingShader_.SetVec3(uniformName,
-                                                         asteroidPositions_[index]);
-                    }
+                    simulation_.CopyPositions(chunkPositions.data(), chunkBeginIndex, chunkEndIndex);
+                    uniformInstancingShader_.SetVec3Array(
+                            positionLocation,
+                            std::span(chunkPositions.data(), chunkEndIndex - chunkBeginIndex));
                 }
                 if (chunkEndIndex > chunkBeginIndex)
                 {
@@ -136,12 +171,11 @@ void HelloInstancing::Update(core::seconds dt)
                     TracyGpuNamedZone(drawInstancedGpu, "Draw Instanced",
                         true);
 #endif
-                    glBindVertexArray(asteroidMesh.GetVao());
+                    StateCache::BindVertexArray(asteroidMesh.GetVao());
                     glDrawElementsInstanced(GL_TRIANGLES,
                                             asteroidMesh.GetIndicesCount(),
                                             GL_UNSIGNED_INT, 0,
                                             chunkEndIndex - chunkBeginIndex);
-                    glBindVertexArray(0);
                 }
             }
             break;
@@ -154,13 +188,40 @@ void HelloInstancing::Update(core::seconds dt)
                               true);
 #endif
             vertexInstancingDrawShader_.Bind();
-            const auto& asteroidMesh = rockModel_.GetMesh(0);
+            const auto& asteroidMesh = rockModel_->GetMesh(0);
             asteroidMesh.BindTextures(vertexInstancingDrawShader_);
+            asteroidMesh.BindQuantization(vertexInstancingDrawShader_);
             vertexInstancingDrawShader_.SetMat4("view",
                                                 camera_.GetView());
             vertexInstancingDrawShader_.SetMat4("projection",
                                                 camera_.GetProjection());
+            auto* instancePositions = static_cast<glm::vec3*>(instanceBuffer_.BeginRegion());
+            {
+#ifdef TRACY_ENABLE
+                ZoneNamedN(uploadVertex, "Upload Vertex Instancing", true);
+#endif
+                std::vector<std::shared_ptr<core::Task>> tasks;
+                for (std::size_t begin = 0; begin < asteroidNmb_; begin += jobChunkSize_)
+                {
+                    const auto end = std::min<std::size_t>(begin + jobChunkSize_, asteroidNmb_);
+                    auto task = std::make_shared<core::Task>([this, instancePositions, begin, end]()
+                    {
+                        simulation_.Update(dt_, begin, end);
+                        simulation_.CopyPositions(instancePositions + begin, begin, end);
+                    });
+                    workerQueue_->AddTask(task);
+                    tasks.push_back(std::move(task));
+                }
+                for (auto& task : tasks)
+                {
+                    task->Join();
+                }
+            }
 
+            StateCache::BindVertexArray(asteroidMesh.GetVao());
+            glBindVertexBuffer(5, instanceBuffer_.GetName(),
+                               static_cast<GLintptr>(instanceBuffer_.GetRegionOffset()),
+                               sizeof(glm::vec3));
             for (std::size_t chunk = 0;
                  chunk < asteroidNmb_ / instanceChunkSize_ + 1; chunk++)
             {
@@ -170,38 +231,20 @@ void HelloInstancing::Update(core::seconds dt)
                                                       instanceChunkSize_);
                 if (chunkEndIndex > chunkBeginIndex)
                 {
-
-                    const size_t chunkSize = chunkEndIndex - chunkBeginIndex;
-                    {
 #ifdef TRACY_ENABLE
-                        ZoneNamedN(uploadVertex, "Upload Vertex Instancing",
-                                   true);
-                        TracyGpuNamedZone(uploadVertexGPU,
-                                          "Upload Vertex Instancing", true);
-#endif
-                        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
-                        glBufferData(GL_ARRAY_BUFFER,
-                                     sizeof(glm::vec3) * chunkSize,
-                                     &asteroidPositions_[chunkBeginIndex],
-                                     GL_DYNAMIC_DRAW);
-                        glBindBuffer(GL_ARRAY_BUFFER, 0);
-                    }
-                    {
-#ifdef TRACY_ENABLE
-                        ZoneNamedN(drawInstances, "Draw Instances",
-                            true);
-                        TracyGpuNamedZone(drawInstancesGpu,
-                            "Draw Instances", true);
+                    ZoneNamedN(drawInstances, "Draw Instances",
+                        true);
+                    TracyGpuNamedZone(drawInstancesGpu,
+                        "Draw Instances", true);
 #endif
-                        glBindVertexArray(asteroidMesh.GetVao());
-                        glDrawElementsInstanced(GL_TRIANGLES,
-                            asteroidMesh.GetIndicesCount(),
-                            GL_UNSIGNED_INT, 0,
-                            chunkSize);
-                        glBindVertexArray(0);
-                    }
+                    glDrawElementsInstancedBaseInstance(GL_TRIANGLES,
+                        asteroidMesh.GetIndicesCount(),
+                        GL_UNSIGNED_INT, 0,
+                        chunkEndIndex - chunkBeginIndex,
+                        chunkBeginIndex);
                 }
             }
+            instanceBuffer_.EndRegion();
 
             break;
         }
@@ -212,10 +255,25 @@ void HelloInstancing::Update(core::seconds dt)
 
 void HelloInstancing::Destroy()
 {
-    rockModel_.Destroy();
+    rockModel_.reset();
     singleDrawShader_.Destroy();
     uniformInstancingShader_.Destroy();
     vertexInstancingDrawShader_.Destroy();
+    gpuInstancingDrawShader_.Destroy();
+    centerMassComputeShader_.Destroy();
+    nbodyComputeShader_.Destroy();
+    StateCache::DeleteBuffers(positionSsbos_.size(), positionSsbos_.data());
+    positionSsbos_.fill(0);
+    StateCache::DeleteBuffers(1, &velocitySsbo_);
+    velocitySsbo_ = 0;
+    instanceBuffer_.Destroy();
+    workerQueue_->Destroy();
+    for (auto& workerThread : workerThreads_)
+    {
+        workerThread->Destroy();
+    }
+    workerThreads_.clear();
+    workerQueue_.reset();
 }
 
 void HelloInstancing::OnEvent(SDL_Event& event)
@@ -238,9 +296,48 @@ void HelloInstancing::DrawImGui()
     {
         instancingType_ = InstancingType(currentItem);
     }
-    ImGui::SliderScalar("Asteroid Nmb", ImGuiDataType_U64, &asteroidNmb_,
-                        &minAsteroidNmb_, &maxAsteroidNmb_);
-    if (instancingType_ == InstancingType::BUFFER_INSTANCING)
+    const char* simulationTypeNames[int(SimulationType::LENGTH)] =
+            {
+                    "CPU",
+                    "GPU Center Mass",
+                    "GPU N-Body"
+            };
+    int currentSimulation = int(simulationType_);
+    if (ImGui::Combo("Simulation Type", &currentSimulation, simulationTypeNames,
+                     int(SimulationType::LENGTH)))
+    {
+        if (simulationType_ == SimulationType::CPU &&
+            SimulationType(currentSimulation) != SimulationType::CPU)
+        {
+            UploadSimulationToGpu();
+        }
+        else if (simulationType_ != SimulationType::CPU &&
+                 SimulationType(currentSimulation) == SimulationType::CPU)
+        {
+            ReadSimulationFromGpu();
+        }
+        simulationType_ = SimulationType(currentSimulation);
+        if (simulationType_ == SimulationType::GPU_NBODY)
+        {
+            asteroidNmb_ = std::min(asteroidNmb_, maxNbodyAsteroidNmb_);
+        }
+    }
+    const auto previousAsteroidNmb = asteroidNmb_;
+    const auto& sliderMaxAsteroidNmb = simulationType_ == SimulationType::GPU_NBODY ?
+                                       maxNbodyAsteroidNmb_ : maxAsteroidNmb_;
+    if (ImGui::SliderScalar("Asteroid Nmb", ImGuiDataType_U64, &asteroidNmb_,
+                            &minAsteroidNmb_, &sliderMaxAsteroidNmb) &&
+        simulationType_ != SimulationType::CPU && asteroidNmb_ > previousAsteroidNmb)
+    {
+        CopyPositionsToNextSsbo(previousAsteroidNmb, asteroidNmb_);
+    }
+    if (simulationType_ == SimulationType::GPU_NBODY)
+    {
+        ImGui::SliderFloat("Asteroid Mass", &asteroidMass_, 0.0f, 100.0f);
+        ImGui::SliderFloat("Softening", &softening_, 0.1f, 10.0f);
+    }
+    if (simulationType_ == SimulationType::CPU &&
+        instancingType_ == InstancingType::BUFFER_INSTANCING)
     {
         const size_t minChunkSize = 100;
         const size_t maxChunkSize = 10'000;
@@ -250,49 +347,106 @@ void HelloInstancing::DrawImGui()
     ImGui::End();
 }
 
-void HelloInstancing::CalculateForce(unsigned long long begin, unsigned long long end)
+void HelloInstancing::UploadSimulationToGpu()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
+    TracyGpuZone("Upload Simulation To GPU");
 #endif
-    const size_t endCount = std::min(end, asteroidNmb_);
-    for (auto i = begin; i < endCount; i++)
+    //A zero time step only computes the orbital velocities
+    simulation_.Update(0.0f, 0, maxAsteroidNmb_);
+    std::vector<glm::vec4> positions(maxAsteroidNmb_);
+    std::vector<glm::vec4> velocities(maxAsteroidNmb_);
+    for (std::size_t i = 0; i < maxAsteroidNmb_; i++)
     {
-        const auto deltaToCenter = glm::vec3(0.0f) - asteroidPositions_[i];
-        const auto r = glm::length(deltaToCenter);
-        const auto force = gravityConst * centerMass * asteroidMass / (r * r);
-        asteroidForces_[i] = deltaToCenter / r * force;
+        positions[i] = glm::vec4(simulation_.GetPosition(i), 1.0f);
+        velocities[i] = glm::vec4(simulation_.GetVelocity(i), 0.0f);
     }
+    currentPositionSsbo_ = 0;
+    //Both position buffers, the compute passes only write the asteroids below asteroidNmb_
+    for (const auto ssbo : positionSsbos_)
+    {
+        StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(glm::vec4) * positions.size(), positions.data());
+    }
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, velocitySsbo_);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(glm::vec4) * velocities.size(), velocities.data());
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void HelloInstancing::CalculateVelocity(unsigned long long begin, unsigned long long end)
+void HelloInstancing::ReadSimulationFromGpu()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
+    TracyGpuZone("Read Simulation From GPU");
 #endif
-    const size_t endCount = std::min(end, asteroidNmb_);
-    for (auto i = begin; i < endCount; i++)
+    std::vector<glm::vec4> positions(maxAsteroidNmb_);
+    std::vector<glm::vec4> velocities(maxAsteroidNmb_);
+    //Shader storage writes of the compute passes are only visible to buffer reads after this barrier
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, positionSsbos_[currentPositionSsbo_]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(glm::vec4) * positions.size(), positions.data());
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, velocitySsbo_);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(glm::vec4) * velocities.size(), velocities.data());
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    for (std::size_t i = 0; i < maxAsteroidNmb_; i++)
     {
-        const auto deltaToCenter = glm::vec3(0.0f) - asteroidPositions_[i];
-        auto velDir = glm::vec3(-deltaToCenter.z, 0.0f, deltaToCenter.x);
-        velDir = glm::normalize(velDir);
-
-        const auto speed = std::sqrt(
-                glm::length(asteroidForces_[i]) / asteroidMass *
-                glm::length(deltaToCenter));
-        asteroidVelocities_[i] = velDir * speed;
+        simulation_.SetPosition(i, glm::vec3(positions[i]));
+        simulation_.SetVelocity(i, glm::vec3(velocities[i]));
     }
 }
 
-void HelloInstancing::CalculatePositions(unsigned long long begin, unsigned long long end)
+void HelloInstancing::CopyPositionsToNextSsbo(std::size_t begin, std::size_t end)
+{
+    const auto nextPositionSsbo = (currentPositionSsbo_ + 1) % positionSsbos_.size();
+    StateCache::BindBuffer(GL_COPY_READ_BUFFER, positionSsbos_[currentPositionSsbo_]);
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, positionSsbos_[nextPositionSsbo]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                        sizeof(glm::vec4) * begin, sizeof(glm::vec4) * begin,
+                        sizeof(glm::vec4) * (end - begin));
+    StateCache::BindBuffer(GL_COPY_READ_BUFFER, 0);
+    StateCache::BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void HelloInstancing::UpdateGpu()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
+    TracyGpuZone("Update GPU Simulation");
 #endif
-    const size_t endCount = std::min(end, asteroidNmb_);
-    for (auto i = begin; i < endCount; i++)
+    const auto nextPositionSsbo = (currentPositionSsbo_ + 1) % positionSsbos_.size();
+    auto& computeShader = simulationType_ == SimulationType::GPU_NBODY ?
+                          nbodyComputeShader_ : centerMassComputeShader_;
+    computeShader.Bind();
+    computeShader.SetInt("asteroidNmb", static_cast<int>(asteroidNmb_));
+    computeShader.SetFloat("dt", dt_);
+    computeShader.SetFloat("gravityConst", simulation_.gravityConst);
+    computeShader.SetFloat("centerMass", simulation_.centerMass);
+    if (simulationType_ == SimulationType::GPU_NBODY)
     {
-        asteroidPositions_[i] += asteroidVelocities_[i] * dt_;
+        computeShader.SetFloat("asteroidMass", asteroidMass_);
+        computeShader.SetFloat("softening", softening_);
     }
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, positionSsbos_[currentPositionSsbo_]);
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, positionSsbos_[nextPositionSsbo]);
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, velocitySsbo_);
+    constexpr unsigned long long groupSize = 256;
+    glDispatchCompute(static_cast<GLuint>((asteroidNmb_ + groupSize - 1) / groupSize), 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    currentPositionSsbo_ = nextPositionSsbo;
+
+    //The vertex shader fetches its position straight from the simulation buffer
+    gpuInstancingDrawShader_.Bind();
+    const auto& asteroidMesh = rockModel_->GetMesh(0);
+    asteroidMesh.BindTextures(gpuInstancingDrawShader_);
+    asteroidMesh.BindQuantization(gpuInstancingDrawShader_);
+    gpuInstancingDrawShader_.SetMat4("view", camera_.GetView());
+    gpuInstancingDrawShader_.SetMat4("projection", camera_.GetProjection());
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, positionSsbos_[currentPositionSsbo_]);
+    StateCache::BindVertexArray(asteroidMesh.GetVao());
+    glDrawElementsInstanced(GL_TRIANGLES,
+                            asteroidMesh.GetIndicesCount(),
+                            GL_UNSIGNED_INT, 0,
+                            asteroidNmb_);
+}
 }
-}
\ No newline at end of file
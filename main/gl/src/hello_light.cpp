@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include "hello_light.h"
+#include "gl/state_cache.h"
 #include <imgui.h>
 namespace gl
 {
@@ -17,7 +18,7 @@ void HelloLight::Init()
                                       "data/shaders/04_hello_light/lamp.frag");
     litProgram_.CreateDefaultProgram("data/shaders/04_hello_light/light.vert",
                                      "data/shaders/04_hello_light/light.frag");
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 
 }
 
@@ -66,7 +67,7 @@ void HelloLight::Update(core::seconds dt)
 
 void HelloLight::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     litProgram_.Destroy();
     lampProgram_.Destroy();
     cube_.Destroy();
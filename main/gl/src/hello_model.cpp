@@ -1,4 +1,7 @@
 #include "hello_model.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
+#include "gl/texture_loader.h"
 #include "imgui.h"
 
 namespace gl
@@ -6,43 +9,69 @@ namespace gl
 
 void HelloModel::Init()
 {
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
-    gltfModel_.LoadModel("data/model/nanosuit2/nanosuit.gltf");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
+    gltfModel_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.gltf");
+    std::size_t vertexCount = 0;
+    std::size_t indexCount = 0;
+    for (const auto* model : {model_.get(), gltfModel_.get()})
+    {
+        for (std::size_t i = 0; i < model->GetMeshCount(); i++)
+        {
+            vertexCount += model->GetMesh(i).GetVertices().size();
+            indexCount += model->GetMesh(i).GetIndicesCount();
+        }
+    }
+    geometryPool_.Create(vertexCount, indexCount);
+    model_->AddToPool(geometryPool_, &materialSystem_);
+    gltfModel_->AddToPool(geometryPool_, &materialSystem_);
+    //The texture arrays are copied from the model textures, they have to be uploaded
+    TextureLoader::Flush();
+    materialSystem_.Build();
     shader_.CreateDefaultProgram("data/shaders/07_hello_model/model.vert",
                                  "data/shaders/07_hello_model/model.frag");
+    materialShader_.CreateDefaultProgram("data/shaders/07_hello_model/model_material.vert",
+                                         materialSystem_.IsBindless() ?
+                                         "data/shaders/07_hello_model/model_material_bindless.frag" :
+                                         "data/shaders/07_hello_model/model_material_array.frag");
     camera_.Init();
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloModel::Update(core::seconds dt)
 {
     camera_.Update(dt);
 
-    shader_.Bind();
-    shader_.SetMat4("view", camera_.GetView());
-    shader_.SetMat4("projection", camera_.GetProjection());
-
     glm::mat4 model(1.0f);
     model = glm::rotate(model, 180.0f, glm::vec3(0, 1, 0));
     model = glm::scale(model, glm::vec3(0.1f, 0.1f, 0.1f));
-    shader_.SetMat4("model", model);
-    shader_.SetMat4("normalMatrix", glm::transpose(glm::inverse(model)));
-    if (usingGltf_)
+    auto& drawnModel = usingGltf_ ? *gltfModel_ : *model_;
+    //The material system lets the whole model go in one multi draw, whatever the textures of its meshes
+    auto& shader = usingGeometryPool_ ? materialShader_ : shader_;
+    shader.Bind();
+    shader.SetMat4("view", camera_.GetView());
+    shader.SetMat4("projection", camera_.GetProjection());
+    shader.SetMat4("model", model);
+    if (usingGeometryPool_)
     {
-        gltfModel_.Draw(shader_);
+        materialSystem_.Bind(shader);
+        drawnModel.Draw(shader, geometryPool_);
     }
     else
     {
-        model_.Draw(shader_);
+        shader.SetMat4("normalMatrix", glm::transpose(glm::inverse(model)));
+        drawnModel.Draw(shader);
     }
 }
 
 void HelloModel::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
-    model_.Destroy();
-    gltfModel_.Destroy();
+    StateCache::Disable(GL_DEPTH_TEST);
+    model_.reset();
+    gltfModel_.reset();
+    geometryPool_.Destroy();
+    materialSystem_.Destroy();
     shader_.Destroy();
+    materialShader_.Destroy();
 }
 
 void HelloModel::OnEvent(SDL_Event& event)
@@ -54,6 +83,16 @@ void HelloModel::DrawImGui()
 {
     ImGui::Begin("Model");
     ImGui::Checkbox("Using GLTF", &usingGltf_);
+    ImGui::Checkbox("Multi Draw Indirect", &usingGeometryPool_);
+    if (materialSystem_.IsBindless())
+    {
+        ImGui::Text("Materials: %zu with bindless textures", materialSystem_.GetMaterialCount());
+    }
+    else
+    {
+        ImGui::Text("Materials: %zu in %zu texture arrays", materialSystem_.GetMaterialCount(),
+                    materialSystem_.GetTextureArrayCount());
+    }
     ImGui::End();
 }
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include "GL/glew.h"
 #include "hello_normal.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
 
 #include <functional>
 
@@ -16,9 +18,9 @@ void HelloNormal::Init()
                                         "data/shaders/15_hello_normal/model.frag");
     normalShader_.CreateDefaultProgram("data/shaders/15_hello_normal/normal.vert",
                                         "data/shaders/15_hello_normal/normal.frag");
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
-    diffuseTexture_.LoadTexture("data/textures/brickwall.jpg");
-    normalTexture_.LoadTexture("data/textures/brickwall_normal.jpg");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
+    diffuseTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg");
+    normalTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall_normal.jpg");
 
     plane_.Init();
     cube_.Init();
@@ -26,7 +28,7 @@ void HelloNormal::Init()
     camera_.Init();
     camera_.position = glm::vec3(-3,3,3);
     camera_.LookAt(glm::vec3());
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloNormal::Update(core::seconds dt)
@@ -61,11 +63,11 @@ void HelloNormal::Update(core::seconds dt)
             if (flag != ENABLE_MODEL)
             {
                 normalShader_.SetInt("texture_diffuse1", 0);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, diffuseTexture_.GetName());
+                StateCache::ActiveTexture(GL_TEXTURE0);
+                StateCache::BindTexture(GL_TEXTURE_2D, diffuseTexture_->GetName());
                 normalShader_.SetInt("texture_normal1", 1);
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, normalTexture_.GetName());
+                StateCache::ActiveTexture(GL_TEXTURE1);
+                StateCache::BindTexture(GL_TEXTURE_2D, normalTexture_->GetName());
             }
         }
         else
@@ -81,8 +83,8 @@ void HelloNormal::Update(core::seconds dt)
             if (flag != ENABLE_MODEL)
             {
                 diffuseShader_.SetInt("texture_diffuse1", 0);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, diffuseTexture_.GetName());
+                StateCache::ActiveTexture(GL_TEXTURE0);
+                StateCache::BindTexture(GL_TEXTURE_2D, diffuseTexture_->GetName());
             }
         }
         switch (flag)
@@ -92,7 +94,7 @@ void HelloNormal::Update(core::seconds dt)
                 break;
             case ENABLE_MODEL:
             {
-                model_.Draw(flags_ & ENABLE_NORMAL_MAP ? normalShader_ : diffuseShader_);
+                model_->Draw(flags_ & ENABLE_NORMAL_MAP ? normalShader_ : diffuseShader_);
                 break;
             }
             case ENABLE_CUBE:
@@ -125,10 +127,10 @@ void HelloNormal::Update(core::seconds dt)
 
 void HelloNormal::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
-    model_.Destroy();
-    diffuseTexture_.Destroy();
-    normalTexture_.Destroy();
+    StateCache::Disable(GL_DEPTH_TEST);
+    model_.reset();
+    diffuseTexture_.reset();
+    normalTexture_.reset();
 
     normalShader_.Destroy();
     diffuseShader_.Destroy();
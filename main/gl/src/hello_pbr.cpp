@@ -1,5 +1,6 @@
 #include <GL/glew.h>
 #include <hello_pbr.h>
+#include <gl/state_cache.h>
 #include <imgui.h>
 #include <fmt/core.h>
 
@@ -23,7 +24,7 @@ void HelloPbr::Init()
 		{glm::vec3(10.0f, -10.0f, 10.0f),glm::vec3(300.0f, 300.0f, 300.0f)},
 		}
 	};
-	glEnable(GL_DEPTH_TEST);
+	StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloPbr::Update(core::seconds dt)
@@ -69,7 +70,7 @@ void HelloPbr::Update(core::seconds dt)
 
 void HelloPbr::Destroy()
 {
-	glDisable(GL_DEPTH_TEST);
+	StateCache::Disable(GL_DEPTH_TEST);
 	sphere_.Destroy();
 	pbrShader_.Destroy();
 }
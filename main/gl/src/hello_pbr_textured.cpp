@@ -1,5 +1,10 @@
 #include <GL/glew.h>
 #include <hello_pbr_textured.h>
+#include <gl/state_cache.h>
+#include <gl/texture_residency.h>
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/gtc/constants.hpp>
 #include "fmt/core.h"
 
 namespace gl
@@ -21,11 +26,12 @@ void HelloPbrTextured::Init()
     }
     };
     ao_.CreateWhiteTexture();
-    albedo_.LoadTexture("data/textures/rustediron2/rustediron2_basecolor.png");
-    normal_.LoadTexture("data/textures/rustediron2/rustediron2_normal.png");
-    metallic_.LoadTexture("data/textures/rustediron2/rustediron2_metallic.png");
-    roughness_.LoadTexture("data/textures/rustediron2/rustediron2_roughness.png");
-    glEnable(GL_DEPTH_TEST);
+    constexpr auto textureFlags = Texture::DEFAULT | Texture::STREAMING;
+    albedo_.LoadTexture("data/textures/rustediron2/rustediron2_basecolor.png", textureFlags);
+    normal_.LoadTexture("data/textures/rustediron2/rustediron2_normal.png", textureFlags);
+    metallic_.LoadTexture("data/textures/rustediron2/rustediron2_metallic.png", textureFlags);
+    roughness_.LoadTexture("data/textures/rustediron2/rustediron2_roughness.png", textureFlags);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloPbrTextured::Update(core::seconds dt)
@@ -52,11 +58,21 @@ void HelloPbrTextured::Update(core::seconds dt)
     pbrShader_.SetMat4("model", glm::mat4(1.0f));
     pbrShader_.SetMat4("normalMatrix", glm::mat4(1.0f));
     sphere_.Draw();
+
+    //The textures wrap once around the sphere
+    const auto screenSize = TextureResidency::GetScreenSize(2.0f * glm::pi<float>() * SPHERE_RADIUS,
+                                                            glm::length(camera_.position),
+                                                            glm::radians(camera_.fovY),
+                                                            Engine::GetInstance().GetWindowSize()[1]);
+    for (const auto* texture : {&albedo_, &normal_, &metallic_, &roughness_})
+    {
+        TextureResidency::ReportUsage(texture->GetName(), screenSize);
+    }
 }
 
 void HelloPbrTextured::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     ao_.Destroy();
     albedo_.Destroy();
     normal_.Destroy();
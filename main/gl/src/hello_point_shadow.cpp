@@ -3,6 +3,8 @@
 //
 #include <GL/glew.h>
 #include "hello_point_shadow.h"
+#include "gl/asset_registry.h"
+#include "gl/state_cache.h"
 #include <imgui.h>
 
 #ifdef TRACY_ENABLE
@@ -17,7 +19,7 @@ namespace gl
 void HelloPointShadow::Init()
 {
     cube_.Init();
-    cubeTexture_.LoadTexture("data/textures/brickwall.jpg");
+    cubeTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg");
 
     simpleDepthShader_.CreateDefaultProgram("data/shaders/17_hello_point_shadow/simpleDepth.vert",
                                             "data/shaders/17_hello_point_shadow/simpleDepth.frag");
@@ -34,7 +36,7 @@ void HelloPointShadow::Init()
     camera_.position = glm::vec3 (3.0f);
     camera_.LookAt(glm::vec3());
 
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 
     lightCamera_.position = glm::vec3();
     lightCamera_.farPlane = 50.0f;
@@ -110,12 +112,12 @@ void HelloPointShadow::Update(core::seconds dt)
     cubeShader_.SetFloat("lightFarPlane", lightCamera_.farPlane);
     cubeShader_.SetFloat("bias", bias_);
     //Render the scene with shadow
-    cubeShader_.SetTexture("material.texture_diffuse1", cubeTexture_, 0);
+    cubeShader_.SetTexture("material.texture_diffuse1", *cubeTexture_, 0);
     cubeShader_.SetInt("shadowMap", 1);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, shadowFramebuffer_.GetDepthTexture());
+    StateCache::ActiveTexture(GL_TEXTURE1);
+    StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, shadowFramebuffer_.GetDepthTexture());
     RenderScene(cubeShader_);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    StateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
     //Render the white light cube
     lightCubeShader_.Bind();
@@ -131,13 +133,13 @@ void HelloPointShadow::Update(core::seconds dt)
 
 void HelloPointShadow::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     cube_.Destroy();
     lightCubeShader_.Destroy();
     shadowFramebuffer_.Destroy();
     cubeShader_.Destroy();
     simpleDepthShader_.Destroy();
-    cubeTexture_.Destroy();
+    cubeTexture_.reset();
 }
 
 void HelloPointShadow::OnEvent(SDL_Event& event)
@@ -1,7 +1,9 @@
 #include "GL/glew.h"
 #include "hello_shadow.h"
+#include "gl/asset_registry.h"
 #include "imgui.h"
 #include "gl/error.h"
+#include "gl/state_cache.h"
 #ifdef TRACY_ENABLE
 
 #include "tracy/Tracy.hpp"
@@ -15,8 +17,8 @@ void HelloShadow::Init()
 {
     cube_.Init();
     floor_.Init();
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
-    floorTexture_.LoadTexture("data/textures/brickwall.jpg");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
+    floorTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg");
 
     camera_.Init();
     camera_.position = glm::vec3(0,3,3);
@@ -37,14 +39,14 @@ void HelloShadow::Init()
     shadowFramebuffer_.SetSize({SHADOW_WIDTH, SHADOW_HEIGHT});
     shadowFramebuffer_.Create();
 
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_CULL_FACE);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloShadow::Update(core::seconds dt)
 {
     camera_.Update(dt);
-    glCullFace(GL_BACK);
+    StateCache::CullFace(GL_BACK);
     const auto lightView = depthCamera_.GetView();
     const auto lightProjection = depthCamera_.GetProjection();
     const auto lightSpaceMatrix = lightProjection * lightView;
@@ -59,12 +61,12 @@ void HelloShadow::Update(core::seconds dt)
         simpleDepthShader_.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
         if (flags_ & ENABLE_PETER_PANNING)
         {
-            glCullFace(GL_FRONT);
+            StateCache::CullFace(GL_FRONT);
         }
         RenderScene(simpleDepthShader_);
         if (flags_ & ENABLE_PETER_PANNING)
         {
-            glCullFace(GL_BACK);
+            StateCache::CullFace(GL_BACK);
         }
         //Render scene with shadow
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -90,13 +92,13 @@ void HelloShadow::Update(core::seconds dt)
 void HelloShadow::Destroy()
 {
 
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_CULL_FACE);
+    StateCache::Disable(GL_DEPTH_TEST);
     cube_.Destroy();
     floor_.Destroy();
-    model_.Destroy();
+    model_.reset();
 
-    floorTexture_.Destroy();
+    floorTexture_.reset();
     shadowFramebuffer_.Destroy();
     modelShader_.Destroy();
     simpleDepthShader_.Destroy();
@@ -158,7 +160,7 @@ void HelloShadow::RenderScene(ShaderProgram& shader)
     shader.SetMat4("model", model);
     shader.SetMat4("transposeInverseModel",
                    glm::transpose(glm::inverse(model)));
-    model_.Draw(shader);
+    model_->Draw(shader);
 
     //Render floor
     model = glm::mat4(1.0f);
@@ -166,7 +168,7 @@ void HelloShadow::RenderScene(ShaderProgram& shader)
     shader.SetMat4("model", model);
     shader.SetMat4("transposeInverseModel",
                    glm::transpose(glm::inverse(model)));
-    shader.SetTexture("texture_diffuse1", floorTexture_, 0);
+    shader.SetTexture("texture_diffuse1", *floorTexture_, 0);
     floor_.Draw();
 
     //Render cubes
@@ -1,6 +1,9 @@
 #include <GL/glew.h>
 #include "hello_ssao.h"
+#include "gl/asset_registry.h"
 #include <gl/error.h>
+#include <gl/framebuffer.h>
+#include <gl/state_cache.h>
 #include <random>
 #include <imgui.h>
 
@@ -11,6 +14,7 @@
 
 namespace gl
 {
+using namespace literals;
 void HelloSSAO::Init()
 {
 
@@ -27,7 +31,7 @@ void HelloSSAO::Init()
         "data/shaders/22_hello_ssao/ssao.vert",
         "data/shaders/22_hello_ssao/ssao_lighting.frag");
     whiteTexture_.CreateWhiteTexture();
-    model_.LoadModel("data/model/nanosuit2/nanosuit.obj");
+    model_ = AssetRegistry::LoadModel("data/model/nanosuit2/nanosuit.obj");
     screenQuad_.Init();
     plane_.Init();
     camera_.Init();
@@ -61,36 +65,17 @@ void HelloSSAO::Init()
         noise = noiseValue;
     }
     glGenTextures(1, &noiseTexture_);
-    glBindTexture(GL_TEXTURE_2D, noiseTexture_);
+    StateCache::BindTexture(GL_TEXTURE_2D, noiseTexture_);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, 4, 4, 0, GL_RGB, GL_FLOAT, &ssaoNoise[0]);
     glCheckError();
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    StateCache::BindTexture(GL_TEXTURE_2D, 0);
     glCheckError();
 
-    //Create framebuffers
-    auto& engine = Engine::GetInstance();
-    const auto windowSize = engine.GetWindowSize();
-    gBuffer_.SetSize({ windowSize[0], windowSize[1] });
-    gBuffer_.SetChannelCount(4);
-    gBuffer_.SetColorAttachmentNmb(3);
-    gBuffer_.SetType(Framebuffer::DEFAULT | Framebuffer::HDR);
-    gBuffer_.Create();
-
-    ssaoFramebuffer_.SetSize({ windowSize[0], windowSize[1] });
-    ssaoFramebuffer_.SetType(Framebuffer::COLOR_ATTACHMENT_0 | Framebuffer::HDR);
-    ssaoFramebuffer_.SetChannelCount(1);
-    ssaoFramebuffer_.Create();
-
-    ssaoBlurFramebuffer_.SetSize({ windowSize[0], windowSize[1] });
-    ssaoBlurFramebuffer_.SetType(Framebuffer::COLOR_ATTACHMENT_0 | Framebuffer::HDR);
-    ssaoBlurFramebuffer_.SetChannelCount(1);
-    ssaoBlurFramebuffer_.Create();
-
-    glEnable(GL_DEPTH_TEST);
+    StateCache::Enable(GL_DEPTH_TEST);
 }
 
 void HelloSSAO::Update(core::seconds dt)
@@ -103,61 +88,82 @@ void HelloSSAO::Update(core::seconds dt)
 
     const auto view = camera_.GetView();
     const auto projection = camera_.GetProjection();
+    const auto windowSize = Engine::GetInstance().GetWindowSize();
+    const RenderTargetDesc gBufferDesc{windowSize[0], windowSize[1], GL_RGBA16F};
+    const RenderTargetDesc ssaoDesc{windowSize[0], windowSize[1], GL_R32F};
+    frameGraph_.Clear();
+    const auto gPosition = frameGraph_.CreateResource("G-Buffer Position", gBufferDesc);
+    const auto gNormal = frameGraph_.CreateResource("G-Buffer Normal", gBufferDesc);
+    const auto gAlbedo = frameGraph_.CreateResource("G-Buffer Albedo", gBufferDesc);
+    const auto depth = frameGraph_.CreateResource("Depth", {windowSize[0], windowSize[1], GL_DEPTH_COMPONENT16});
+    const auto ssao = frameGraph_.CreateResource("SSAO", ssaoDesc);
+    const auto ssaoBlur = frameGraph_.CreateResource("SSAO Blur", ssaoDesc);
+
+    // 1. geometry pass: render scene's geometry/color data into gbuffer
+    frameGraph_.AddPass("Geometry Pass", [&](FrameGraph::PassBuilder& builder)
     {
-#ifdef TRACY_ENABLE
-        ZoneNamedN(gPass, "Geometry Pass", true);
-        TracyGpuNamedZone(gPassGpu, "Geometry Pass", true);
-#endif
-        // 1. geometry pass: render scene's geometry/color data into gbuffer
-        gBuffer_.Bind();
+        builder.Write(gPosition);
+        builder.Write(gNormal);
+        builder.Write(gAlbedo);
+        builder.Write(depth);
+    }, [&](const FrameGraph::PassResources& resources)
+    {
+        resources.BindFramebuffer({gPosition, gNormal, gAlbedo}, depth);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         ssaoGeometryShader_.Bind();
         ssaoGeometryShader_.SetMat4("view", view);
         ssaoGeometryShader_.SetMat4("projection", projection);
         RenderScene(ssaoGeometryShader_);
-    }
+    });
+    // 2. generate SSAO texture
+    frameGraph_.AddPass("SSAO Pass", [&](FrameGraph::PassBuilder& builder)
     {
-#ifdef TRACY_ENABLE
-        ZoneNamedN(ssaoPass, "SSAO Pass", true);
-        TracyGpuNamedZone(ssaoPassGpu, "SSAO Pass", true);
-#endif
-        // 2. generate SSAO texture
-        ssaoFramebuffer_.Bind();
+        builder.Read(gPosition);
+        builder.Read(gNormal);
+        builder.Write(ssao);
+    }, [&](const FrameGraph::PassResources& resources)
+    {
+        resources.BindFramebuffer({ssao});
         glClear(GL_COLOR_BUFFER_BIT);
         ssaoShader_.Bind();
-        for (unsigned int i = 0; i < 64; i++)
-        {
-            ssaoShader_.SetVec3("samples[" + std::to_string(i) + "]", ssaoKernel_[i]);
-        }
+        ssaoShader_.SetVec3Array(ssaoShader_.GetUniformLocation("samples"_uniform), ssaoKernel_);
         ssaoShader_.SetMat4("projection", projection);
-        ssaoShader_.SetTexture("gPosition", gBuffer_.GetColorTexture(0), 0);
-        ssaoShader_.SetTexture("gNormal", gBuffer_.GetColorTexture(1), 1);
+        ssaoShader_.SetTexture("gPosition", resources.GetTexture(gPosition), 0);
+        ssaoShader_.SetTexture("gNormal", resources.GetTexture(gNormal), 1);
         ssaoShader_.SetTexture("texNoise", noiseTexture_, 2);
 
         ssaoShader_.SetInt("kernelSize", kernelSize_);
         ssaoShader_.SetFloat("radius", ssaoRadius_);
         ssaoShader_.SetFloat("bias", ssaoBias_);
         screenQuad_.Draw();
-    }
+    });
+    // 3. blur SSAO texture to remove noise
+    frameGraph_.AddPass("Blur Pass", [&](FrameGraph::PassBuilder& builder)
     {
-#ifdef TRACY_ENABLE
-        ZoneNamedN(ssaoBlurPass, "Blur Pass", true);
-        TracyGpuNamedZone(ssaoBlurPassGpu, "Blur Pass", true);
-#endif
-        // 3. blur SSAO texture to remove noise
-
-        ssaoBlurFramebuffer_.Bind();
+        builder.Read(ssao);
+        builder.Write(ssaoBlur);
+    }, [&](const FrameGraph::PassResources& resources)
+    {
+        resources.BindFramebuffer({ssaoBlur});
         glClear(GL_COLOR_BUFFER_BIT);
         ssaoBlurShader_.Bind();
-        ssaoBlurShader_.SetTexture("ssaoInput", ssaoFramebuffer_.GetColorTexture(0), 0);
+        ssaoBlurShader_.SetTexture("ssaoInput", resources.GetTexture(ssao), 0);
         screenQuad_.Draw();
-    }
+    });
+    // 4. lighting pass: traditional deferred Blinn-Phong lighting with added screen-space ambient occlusion
+    //Without SSAO the occlusion passes are not read and get culled
+    frameGraph_.AddPass("Lighting Pass", [&](FrameGraph::PassBuilder& builder)
+    {
+        builder.Read(gPosition);
+        builder.Read(gNormal);
+        builder.Read(gAlbedo);
+        if (enableSsao)
+        {
+            builder.Read(ssaoBlur);
+        }
+        builder.SetSideEffect();
+    }, [&](const FrameGraph::PassResources& resources)
     {
-#ifdef TRACY_ENABLE
-        ZoneNamedN(lightingPass, "Lighting Pass", true);
-        TracyGpuNamedZone(lightingPassGpu, "Lighting Pass", true);
-#endif
-        // 4. lighting pass: traditional deferred Blinn-Phong lighting with added screen-space ambient occlusion
         Framebuffer::Unbind();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         ssaoLightingShader_.Bind();
@@ -167,46 +173,36 @@ void HelloSSAO::Update(core::seconds dt)
         ssaoLightingShader_.SetFloat("light.linear", light_.linear);
         ssaoLightingShader_.SetFloat("light.quadratic", light_.quadratic);
         ssaoLightingShader_.SetFloat("light.constant", light_.constant);
-        ssaoLightingShader_.SetTexture("gPosition", gBuffer_.GetColorTexture(0), 0);
-        ssaoLightingShader_.SetTexture("gNormal", gBuffer_.GetColorTexture(1), 1);
-        ssaoLightingShader_.SetTexture("gAlbedo", gBuffer_.GetColorTexture(2), 2);
-        ssaoLightingShader_.SetTexture("ssao", ssaoBlurFramebuffer_.GetColorTexture(0), 3);
+        ssaoLightingShader_.SetTexture("gPosition", resources.GetTexture(gPosition), 0);
+        ssaoLightingShader_.SetTexture("gNormal", resources.GetTexture(gNormal), 1);
+        ssaoLightingShader_.SetTexture("gAlbedo", resources.GetTexture(gAlbedo), 2);
+        ssaoLightingShader_.SetTexture("ssao", enableSsao ? resources.GetTexture(ssaoBlur) : whiteTexture_.GetName(),
+                                       3);
         ssaoLightingShader_.SetInt("enableSSAO", enableSsao);
         screenQuad_.Draw();
-    }
+    });
+    frameGraph_.Execute();
 }
 
 void HelloSSAO::Destroy()
 {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::Disable(GL_DEPTH_TEST);
     ssaoBlurShader_.Destroy();
     ssaoShader_.Destroy();
     ssaoGeometryShader_.Destroy();
     ssaoLightingShader_.Destroy();
+    frameGraph_.Clear();
 
     whiteTexture_.Destroy();
-    glDeleteTextures(1, &noiseTexture_);
-    model_.Destroy();
+    StateCache::DeleteTextures(1, &noiseTexture_);
+    model_.reset();
     screenQuad_.Destroy();
     plane_.Destroy();
-
-    gBuffer_.Destroy();
-    ssaoFramebuffer_.Destroy();
-    ssaoBlurFramebuffer_.Destroy();
 }
 
 void HelloSSAO::OnEvent(SDL_Event& event)
 {
     camera_.OnEvent(event);
-    if(event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_RESIZED)
-    {
-        gBuffer_.SetSize({ event.window.data1, event.window.data2 });
-        gBuffer_.Reload();
-        ssaoBlurFramebuffer_.SetSize({ event.window.data1, event.window.data2 });
-        ssaoBlurFramebuffer_.Reload();
-        ssaoFramebuffer_.SetSize({ event.window.data1, event.window.data2 });
-        ssaoFramebuffer_.Reload();
-    }
 }
 
 void HelloSSAO::DrawImGui()
@@ -216,6 +212,12 @@ void HelloSSAO::DrawImGui()
     ImGui::SliderFloat("Bias", &ssaoBias_, 0.005f, 0.05f);
     ImGui::SliderInt("Kernel Size", &kernelSize_, 1, maxKernelSize_);
     ImGui::Checkbox("Enable SSAO", &enableSsao);
+    const auto& frameGraphStatistics = frameGraph_.GetStatistics();
+    ImGui::Text("Passes: %zu culled: %zu", frameGraphStatistics.passNmb, frameGraphStatistics.culledPassNmb);
+    for (const auto passName : frameGraph_.GetExecutedPasses())
+    {
+        ImGui::BulletText("%.*s", static_cast<int>(passName.size()), passName.data());
+    }
     ImGui::End();
 }
 
@@ -238,7 +240,7 @@ void HelloSSAO::RenderScene(ShaderProgram& shader)
     model = glm::scale(model, glm::vec3( 0.1f));
     shader.SetMat4("model", model);
     shader.SetMat4("normalMatrix", glm::transpose(glm::inverse(view * model)));
-    model_.Draw(shader);
+    model_->Draw(shader);
 
     glCheckError();
 }
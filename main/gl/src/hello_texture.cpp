@@ -1,4 +1,5 @@
 #include <hello_texture.h>
+#include "gl/asset_registry.h"
 #include "imgui.h"
 
 namespace gl
@@ -9,9 +10,9 @@ void HelloTexture::Init()
     shader_.CreateDefaultProgram(
             "data/shaders/02_hello_texture/texture_quad.vert",
             "data/shaders/02_hello_texture/texture_quad.frag");
-    texture_.LoadTexture("data/textures/brickwall.jpg");
-    ktxTexture_.LoadTexture("data/textures/brickwall.ktx");
-    ddsTexture_.LoadTexture("data/textures/brickwall.dds");
+    texture_ = AssetRegistry::LoadTexture("data/textures/brickwall.jpg");
+    ktxTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.ktx");
+    ddsTexture_ = AssetRegistry::LoadTexture("data/textures/brickwall.dds");
 }
 
 void HelloTexture::Update([[maybe_unused]] core::seconds dt)
@@ -20,13 +21,13 @@ void HelloTexture::Update([[maybe_unused]] core::seconds dt)
     switch(textureType_)
     {
     case TextureType::NONE:
-        shader_.SetTexture("ourTexture", texture_, 0);
+        shader_.SetTexture("ourTexture", *texture_, 0);
         break;
     case TextureType::KTX:
-        shader_.SetTexture("ourTexture", ktxTexture_, 0);
+        shader_.SetTexture("ourTexture", *ktxTexture_, 0);
         break;
     case TextureType::DDS:
-        shader_.SetTexture("ourTexture", ddsTexture_, 0);
+        shader_.SetTexture("ourTexture", *ddsTexture_, 0);
         break;
     }
     
@@ -37,8 +38,9 @@ void HelloTexture::Destroy()
 {
     quad_.Destroy();
     shader_.Destroy();
-    texture_.Destroy();
-    ktxTexture_.Destroy();
+    texture_.reset();
+    ktxTexture_.reset();
+    ddsTexture_.reset();
 }
 
 void HelloTexture::OnEvent([[maybe_unused]] SDL_Event& event)
@@ -2,6 +2,7 @@
 
 #include "imgui.h"
 #include "hello_triangle.h"
+#include "gl/state_cache.h"
 
 namespace gl
 {
@@ -15,10 +16,10 @@ void HelloTriangle::Init()
     glGenVertexArrays(1, &basicTriangleProgram_.VAO);
     // ..:: Initialization code (done once (unless your object frequently changes)) :: ..
     // 1. bind Vertex Array Object
-    glBindVertexArray(basicTriangleProgram_.VAO);
+    StateCache::BindVertexArray(basicTriangleProgram_.VAO);
     // 2. copy our vertices array in a buffer for OpenGL to use
     glGenBuffers(1, &basicTriangleProgram_.VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, basicTriangleProgram_.VBO);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, basicTriangleProgram_.VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(basicTriangleProgram_.vertices), &basicTriangleProgram_.vertices,
                  GL_STATIC_DRAW);
     // 3. then set our vertex attributes pointers
@@ -40,7 +41,7 @@ void HelloTriangle::Update([[maybe_unused]] core::seconds dt)
     {
         case ProgramType::Triangle:
             basicTriangleProgram_.shaderProgram.Bind();
-            glBindVertexArray(basicTriangleProgram_.VAO);
+            StateCache::BindVertexArray(basicTriangleProgram_.VAO);
             glDrawArrays(GL_TRIANGLES, 0, 3);
             break;
         case ProgramType::Quad:
@@ -55,8 +56,8 @@ void HelloTriangle::Update([[maybe_unused]] core::seconds dt)
 
 void HelloTriangle::Destroy()
 {
-    glDeleteVertexArrays(1, &basicTriangleProgram_.VAO);
-    glDeleteBuffers(1, &basicTriangleProgram_.VBO);
+    StateCache::DeleteVertexArrays(1, &basicTriangleProgram_.VAO);
+    StateCache::DeleteBuffers(1, &basicTriangleProgram_.VBO);
 
     basicTriangleProgram_.shaderProgram.Destroy();
 
@@ -0,0 +1,110 @@
+#include <argh.h>
+#include <barnes_hut.h>
+#include <jobsystem.h>
+#include <log.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * \brief Disk of debris like the asteroid field of the instancing samples
+ */
+void GenerateDebrisField(std::size_t count, std::vector<glm::vec3>& positions, std::vector<float>& masses)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> angleDistribution(0.0f, 2.0f * static_cast<float>(M_PI));
+    std::normal_distribution<float> radiusDistribution(150.0f, 25.0f);
+    std::normal_distribution<float> heightDistribution(0.0f, 2.0f);
+    std::uniform_real_distribution<float> massDistribution(0.1f, 1.0f);
+    positions.resize(count);
+    masses.resize(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const float angle = angleDistribution(generator);
+        const float radius = radiusDistribution(generator);
+        positions[i] = glm::vec3(std::cos(angle) * radius, heightDistribution(generator), std::sin(angle) * radius);
+        masses[i] = massDistribution(generator);
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    argh::parser parser(argc, argv, argh::parser::PREFER_PARAM_FOR_UNREG_OPTION);
+    float theta = 0.5f;
+    std::size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t iterations = 5;
+    std::size_t chunkSize = 4'096;
+    parser("theta", theta) >> theta;
+    parser("threads", threadCount) >> threadCount;
+    parser("iterations", iterations) >> iterations;
+    parser("chunk", chunkSize) >> chunkSize;
+    iterations = std::max<std::size_t>(iterations, 1);
+
+    core::WorkerQueue queue;
+    std::vector<std::unique_ptr<core::WorkerThread>> threads;
+    for (std::size_t i = 0; i < threadCount; i++)
+    {
+        threads.push_back(std::make_unique<core::WorkerThread>(queue));
+        threads.back()->Start();
+    }
+
+    core::LogDebug(fmt::format("Barnes-Hut benchmark, theta: {}, threads: {}, iterations: {}",
+                               theta, threadCount, iterations));
+    for (const std::size_t count : {10'000u, 100'000u, 1'000'000u})
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<float> masses;
+        GenerateDebrisField(count, positions, masses);
+        std::vector<glm::vec3> accelerations(count);
+
+        core::BarnesHutTree tree;
+        tree.theta = theta;
+        double serialBuild = 0.0, threadedBuild = 0.0, serialForce = 0.0, threadedForce = 0.0;
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            auto start = Clock::now();
+            tree.Build(positions, masses);
+            serialBuild += ElapsedMs(start);
+            start = Clock::now();
+            tree.ComputeAccelerations(accelerations, 0, count);
+            serialForce += ElapsedMs(start);
+
+            start = Clock::now();
+            tree.Build(positions, masses, queue);
+            threadedBuild += ElapsedMs(start);
+            start = Clock::now();
+            tree.ComputeAccelerations(accelerations, queue, chunkSize);
+            threadedForce += ElapsedMs(start);
+        }
+        const auto average = static_cast<double>(iterations);
+        core::LogDebug(fmt::format(
+                "{:>9} bodies, {:>8} nodes | build: {:8.2f} ms serial {:8.2f} ms threaded | "
+                "force: {:9.2f} ms serial {:9.2f} ms threaded",
+                count, tree.GetNodes().size(),
+                serialBuild / average, threadedBuild / average,
+                serialForce / average, threadedForce / average));
+    }
+
+    queue.Destroy();
+    for (auto& thread : threads)
+    {
+        thread->Destroy();
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <argh.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <log.h>
+#include <mesh_file.h>
+#include <mesh_optimizer.h>
+#include <fmt/core.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+/**
+ * \brief Texture types in the order gl::Model loads them, with their sampler name
+ */
+constexpr std::array<std::pair<aiTextureType, std::string_view>, 3> TEXTURE_TYPES =
+        {
+                std::pair{aiTextureType_DIFFUSE, std::string_view("texture_diffuse")},
+                std::pair{aiTextureType_SPECULAR, std::string_view("texture_specular")},
+                std::pair{aiTextureType_HEIGHT, std::string_view("texture_normal")}
+        };
+
+void CookMesh(const aiMesh* mesh, core::MeshFileData& data)
+{
+    std::vector<core::MeshFileVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    vertices.reserve(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+    {
+        core::MeshFileVertex vertex{};
+        vertex.position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+        vertex.normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+        if (mesh->mTangents != nullptr)
+        {
+            vertex.tangent = glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
+        }
+        if (mesh->mTextureCoords[0] != nullptr)
+        {
+            vertex.texCoords = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+        }
+        vertices.push_back(vertex);
+    }
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+        const auto& face = mesh->mFaces[i];
+        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    }
+    const auto statistics = core::OptimizeMesh(vertices, indices);
+    core::LogDebug(fmt::format("Mesh {}: {} triangles, ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f}",
+                               data.meshes.size(), indices.size() / 3, statistics.before.acmr,
+                               statistics.after.acmr, statistics.before.atvr, statistics.after.atvr));
+
+    core::MeshFileMesh cookedMesh;
+    cookedMesh.firstVertex = static_cast<std::uint32_t>(data.vertices.size());
+    cookedMesh.vertexCount = static_cast<std::uint32_t>(vertices.size());
+    cookedMesh.firstIndex = static_cast<std::uint32_t>(data.indices.size());
+    cookedMesh.indexCount = static_cast<std::uint32_t>(indices.size());
+    cookedMesh.materialIndex = mesh->mMaterialIndex;
+    data.vertices.insert(data.vertices.end(), vertices.begin(), vertices.end());
+    data.indices.insert(data.indices.end(), indices.begin(), indices.end());
+    data.meshes.push_back(cookedMesh);
+}
+
+void CookNode(const aiNode* node, const aiScene* scene, core::MeshFileData& data)
+{
+    //Same traversal as gl::Model::ProcessNode so the meshes keep their order
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    {
+        CookMesh(scene->mMeshes[node->mMeshes[i]], data);
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+    {
+        CookNode(node->mChildren[i], scene, data);
+    }
+}
+
+void CookMaterials(const aiScene* scene, core::MeshFileData& data)
+{
+    for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+    {
+        const auto* material = scene->mMaterials[i];
+        core::MeshFileMaterial cookedMaterial;
+        cookedMaterial.firstTexture = static_cast<std::uint32_t>(data.textures.size());
+        for (const auto& [type, typeName] : TEXTURE_TYPES)
+        {
+            for (unsigned int j = 0; j < material->GetTextureCount(type); j++)
+            {
+                aiString path;
+                material->GetTexture(type, j, &path);
+                data.AddTexture(path.C_Str(), typeName);
+            }
+        }
+        cookedMaterial.textureCount = static_cast<std::uint32_t>(data.textures.size()) - cookedMaterial.firstTexture;
+        data.materials.push_back(cookedMaterial);
+    }
+}
+
+bool CookFile(std::string_view inpath, std::string_view outpath)
+{
+    if (!fs::exists(inpath))
+    {
+        core::LogError(fmt::format("Input file {} does not exist", inpath));
+        return false;
+    }
+    Assimp::Importer importer;
+    //Same post processing as gl::Model::LoadModel
+    const auto* scene = importer.ReadFile(inpath.data(), aiProcess_Triangulate | aiProcess_FlipUVs |
+                                                         aiProcess_GenNormals | aiProcess_CalcTangentSpace);
+    if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || scene->mRootNode == nullptr)
+    {
+        core::LogError(fmt::format("Assimp: {}", importer.GetErrorString()));
+        return false;
+    }
+    core::MeshFileData data;
+    CookMaterials(scene, data);
+    CookNode(scene->mRootNode, scene, data);
+
+    const auto file = core::WriteMeshFile(data);
+    std::ofstream outFile(outpath.data(), std::ofstream::binary);
+    if (!outFile)
+    {
+        core::LogError(fmt::format("Could not open output file {}", outpath));
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    core::LogDebug(fmt::format("Cooked {} meshes, {} vertices and {} indices in {}",
+                               data.meshes.size(), data.vertices.size(), data.indices.size(), outpath));
+    return true;
+}
+}
+
+int main(int argc, char** argv)
+{
+    argh::parser parser(argc, argv);
+    const std::string inpath = parser[1];
+    //gl::Model looks for the cooked file next to the source one
+    const auto outpath = parser.size() > 2 ? parser[2] : fmt::format("{}{}", inpath, core::MESH_FILE_EXTENSION);
+    return CookFile(inpath, outpath) ? 0 : 1;
+}
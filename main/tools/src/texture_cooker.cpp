@@ -0,0 +1,192 @@
+#include <argh.h>
+#include <log.h>
+#include <texture_compression.h>
+#include <fmt/core.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <gli/gli.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+/**
+ * \brief Parts of a file name marking a tangent space normal map, stored as BC5
+ */
+constexpr std::array<std::string_view, 3> NORMAL_MAP_TAGS = {"normal", "_ddn", "_nrm"};
+
+struct CookOptions
+{
+    bool flipY = false;
+    /**
+     * \brief Average the mips in linear space, for colors sampled as sRGB
+     */
+    bool srgb = true;
+    bool forceNormalMap = false;
+};
+
+bool IsNormalMap(std::string_view path)
+{
+    std::string fileName = fs::path(path).filename().string();
+    std::ranges::transform(fileName, fileName.begin(), [](unsigned char c)
+    {
+        return static_cast<char>(std::tolower(c));
+    });
+    return std::ranges::any_of(NORMAL_MAP_TAGS, [&fileName](std::string_view tag)
+    {
+        return fileName.find(tag) != std::string::npos;
+    });
+}
+
+/**
+ * \brief Same channels as the uncompressed texture gl::Texture uploads, except normal maps whose z is rebuilt
+ */
+core::BlockFormat ChooseFormat(const std::vector<std::uint8_t>& rgba, int channelNb, bool isNormalMap)
+{
+    if (isNormalMap)
+    {
+        return core::BlockFormat::BC5;
+    }
+    if (channelNb == 1)
+    {
+        return core::BlockFormat::BC4;
+    }
+    if (channelNb == 2)
+    {
+        return core::BlockFormat::BC5;
+    }
+    bool hasAlpha = false;
+    for (std::size_t i = 3; i < rgba.size(); i += 4)
+    {
+        if (rgba[i] != 255)
+        {
+            hasAlpha = true;
+            break;
+        }
+    }
+    return hasAlpha ? core::BlockFormat::BC3 : core::BlockFormat::BC1;
+}
+
+gli::format ToGliFormat(core::BlockFormat format)
+{
+    switch (format)
+    {
+        case core::BlockFormat::BC1:
+            return gli::FORMAT_RGB_DXT1_UNORM_BLOCK8;
+        case core::BlockFormat::BC3:
+            return gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16;
+        case core::BlockFormat::BC4:
+            return gli::FORMAT_R_ATI1N_UNORM_BLOCK8;
+        case core::BlockFormat::BC5:
+            return gli::FORMAT_RG_ATI2N_UNORM_BLOCK16;
+    }
+    return gli::FORMAT_UNDEFINED;
+}
+
+std::string_view GetFormatName(core::BlockFormat format)
+{
+    switch (format)
+    {
+        case core::BlockFormat::BC1:
+            return "BC1";
+        case core::BlockFormat::BC3:
+            return "BC3";
+        case core::BlockFormat::BC4:
+            return "BC4";
+        case core::BlockFormat::BC5:
+            return "BC5";
+    }
+    return "";
+}
+
+bool CookFile(std::string_view inpath, std::string_view outpath, const CookOptions& options)
+{
+    if (!fs::exists(inpath))
+    {
+        core::LogError(fmt::format("Input file {} does not exist", inpath));
+        return false;
+    }
+    //Same orientation as gl::Texture::DecodeImage with FLIP_Y
+    stbi_set_flip_vertically_on_load(options.flipY);
+    int width = 0;
+    int height = 0;
+    int channelNb = 0;
+    auto* pixels = stbi_load(inpath.data(), &width, &height, &channelNb, 4);
+    if (pixels == nullptr)
+    {
+        core::LogError(fmt::format("Could not decode {}: {}", inpath, stbi_failure_reason()));
+        return false;
+    }
+    std::vector<std::uint8_t> rgba(pixels, pixels + static_cast<std::size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    const auto isNormalMap = options.forceNormalMap || IsNormalMap(inpath);
+    const auto format = ChooseFormat(rgba, channelNb, isNormalMap);
+    //Normals and single channel data are not colors
+    const auto srgb = options.srgb && !isNormalMap && channelNb > 2;
+    if (channelNb == 2 && !isNormalMap)
+    {
+        //gl::Texture uploads a gray and alpha image as RG, stb_image expanded it to gray, gray, gray, alpha
+        for (std::size_t i = 0; i < rgba.size(); i += 4)
+        {
+            rgba[i + 1] = rgba[i + 3];
+        }
+    }
+    gli::texture2d texture(ToGliFormat(format), gli::extent2d(width, height));
+    for (std::size_t level = 0; level < texture.levels(); level++)
+    {
+        const auto extent = texture.extent(level);
+        const auto compressed = core::CompressImage(rgba, extent.x, extent.y, format);
+        if (compressed.size() != texture.size(level))
+        {
+            core::LogError(fmt::format("Level {} of {} is {} bytes instead of {}",
+                                       level, inpath, compressed.size(), texture.size(level)));
+            return false;
+        }
+        std::memcpy(texture.data(0, 0, level), compressed.data(), compressed.size());
+        if (level + 1 < texture.levels())
+        {
+            rgba = core::DownsampleImage(rgba, extent.x, extent.y, srgb);
+        }
+    }
+    //KTX1 as gli does not read KTX2
+    if (!gli::save_ktx(texture, std::string(outpath)))
+    {
+        core::LogError(fmt::format("Could not write output file {}", outpath));
+        return false;
+    }
+    const auto sourceSize = static_cast<std::size_t>(width) * height * channelNb;
+    core::LogDebug(fmt::format("Cooked {} ({}x{}, {} channels) in {}: {}, {} levels, {} bytes instead of {}",
+                               inpath, width, height, channelNb, outpath, GetFormatName(format),
+                               texture.levels(), texture.size(), sourceSize * 4 / 3));
+    return true;
+}
+}
+
+int main(int argc, char** argv)
+{
+    argh::parser parser(argc, argv);
+    const std::string inpath = parser[1];
+    CookOptions options;
+    options.flipY = parser["flip-y"];
+    options.srgb = !parser["linear"];
+    options.forceNormalMap = parser["normal"];
+    //gl::Texture looks for the cooked file next to the source one
+    const auto outpath = parser.size() > 2
+                             ? parser[2]
+                             : fmt::format("{}{}", inpath, options.flipY
+                                                               ? core::FLIPPED_COOKED_TEXTURE_EXTENSION
+                                                               : core::COOKED_TEXTURE_EXTENSION);
+    return CookFile(inpath, outpath, options) ? 0 : 1;
+}